@@ -0,0 +1,28 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <type_traits>
+
+// =========================
+// Posizioni logiche degli attori
+// =========================
+// La posizione autorevole di Pac-Man e dei fantasmi, in due array paralleli (x e y, struct-of-arrays)
+// posseduti dalla simulazione. Ogni attore legge e scrive solo il proprio slot: l'update tocca pochi
+// float contigui invece di una sf::CircleShape (vertici, trasformazione in cache) sparsa nello heap,
+// e sprite e forme SFML si posizionano da qui solo al momento di disegnare.
+// Banalmente copiabile: una copia salva le posizioni di tutti gli attori.
+// =========================
+struct ActorPositions {
+    static constexpr std::size_t CAPACITY = 5; // Pac-Man + 4 fantasmi
+    static constexpr std::size_t PLAYER = 0;   // i fantasmi occupano gli slot successivi
+
+    float x[CAPACITY] = {};
+    float y[CAPACITY] = {};
+
+    sf::Vector2f get(std::size_t slot) const { return {x[slot], y[slot]}; }
+    void set(std::size_t slot, const sf::Vector2f& pos) { x[slot] = pos.x; y[slot] = pos.y; }
+    void move(std::size_t slot, const sf::Vector2f& delta) { x[slot] += delta.x; y[slot] += delta.y; }
+};
+
+static_assert(std::is_trivially_copyable_v<ActorPositions>, "ActorPositions deve restare copiabile con memcpy");
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// Contatore delle allocazioni sull'heap del thread corrente.
+// Solo nelle build di debug (NDEBUG non definito) AllocationCounter.cpp sostituisce operator new
+// e conta ogni chiamata; in release il contatore resta a zero e non costa nulla.
+// Serve a verificare che i percorsi caldi della simulazione (update dei fantasmi) non allochino.
+class AllocationCounter {
+public:
+    static bool isEnabled();
+    // Allocazioni fatte dal thread corrente dall'avvio
+    static std::uint64_t count();
+};
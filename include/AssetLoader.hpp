@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "ThreadPool.hpp"
+
+// =========================
+// Caricamento degli asset all'avvio, in parallelo
+// =========================
+// Ogni file (campioni audio, musica, font, atlas delle texture) è un job indipendente: start() li
+// invia a un ThreadPool e il thread principale intanto disegna la schermata di caricamento con
+// getProgress(). Dopo wait() i risultati sono visibili al thread principale, che li consegna ai
+// loro proprietari (upload della texture, avvio del thread audio). I job fanno solo lavoro di CPU
+// e disco (niente OpenGL), ognuno su dati suoi; un'eccezione conta come fallimento.
+// I nomi devono essere stringhe statiche: finiscono anche nella traccia (--trace, categoria "startup").
+// =========================
+class AssetLoader {
+public:
+    using Job = std::function<bool()>;
+
+    struct Result {
+        const char* name = "";
+        double seconds = 0.0; // durata del job sul suo worker
+        bool ok = false;
+    };
+
+    // threads = 0 -> un worker per core
+    explicit AssetLoader(unsigned threads = 0);
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Prima di start()
+    void add(const char* name, Job job);
+    void start();
+
+    // Dal thread principale durante il caricamento
+    bool isDone() const { return m_completed.load(std::memory_order_acquire) == m_jobs.size(); }
+    float getProgress() const;
+
+    // Attende tutti i job; dopo, i risultati e i tempi sono validi
+    void wait();
+    // Un risultato per job, nell'ordine di add()
+    const std::vector<Result>& getResults() const { return m_results; }
+    // Tempo reale da start() alla fine dell'ultimo job, contro la somma delle durate dei job
+    double getWallSeconds() const { return m_wallSeconds; }
+    double getWorkSeconds() const;
+    unsigned getThreadCount() const { return m_pool.size(); }
+
+private:
+    ThreadPool m_pool;
+    std::vector<Job> m_jobs;
+    std::vector<Result> m_results;          // un elemento per job, scritto solo dal suo worker
+    std::atomic<std::size_t> m_completed{0};
+    std::atomic<double> m_finishedAt{0.0};  // secondi da start() alla fine dell'ultimo job
+    double m_wallSeconds = 0.0;
+    bool m_started = false;
+    bool m_waited = false;
+};
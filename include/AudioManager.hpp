@@ -0,0 +1,141 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <thread>
+
+class GameSimulation;
+
+// =========================
+// Audio del gioco: campioni, voci e stato dei suoni
+// =========================
+// Il thread principale non tocca mai un sf::Sound: accoda eventi (menu, inizio partita, pausa,
+// eventi della simulazione) con post(), una coda circolare senza lock con un solo scrittore.
+// Il thread audio svuota la coda ogni 5 ms e tiene lo stato: musica d'inizio, sirena dei fantasmi
+// (normale, ritorno alla casa, silenzio in frightened) con dissolvenza incrociata, chomp che sfuma
+// e va in pausa quando Pac-Man smette di mangiare, effetti singoli. Le sf::Sound sono un gruppo fisso
+// di VOICES voci: un effetto prende una voce libera o ruba l'effetto più vecchio, mai un loop.
+// Il costruttore non legge il disco: i FILE_COUNT file si caricano con loadFile(), anche in parallelo
+// (AssetLoader), e start() avvia il thread audio a caricamento finito. Un file mancante resta muto.
+// Con Config::enabled = false (es. --no-audio) non si carica nulla e post() non fa niente.
+// =========================
+class AudioManager {
+public:
+    enum Event : std::uint8_t {
+        // Menu e schermate
+        MenuMove,           // cursore su/giù (al più un suono ogni 100 ms)
+        Confirm,            // conferma, restart, ritorno al menu
+        MenuOpen,           // apertura del menu di pausa, uscita dal Game Over
+        // Partita
+        GameStarted,        // nuova partita: musica d'inizio (solo la prima volta), sirena e chomp azzerati
+        LoopsPaused,        // pausa e schermate di messaggio: sirena e chomp sfumano
+        LoopsResumed,       // ripresa: torna la sirena dello stato corrente
+        GameStopped,        // ritorno al menu o Game Over: ferma sirena e chomp
+        // Simulazione (di solito da postSimulation)
+        PlayerStarted,      // Pac-Man si è mosso: da qui la sirena può suonare
+        PelletEaten,
+        SuperPelletEaten,
+        GhostEaten,
+        PlayerDied,         // sirena e chomp fermi fino a LoopsResumed, suono della morte
+        SirenNormal,
+        SirenFrightened,
+        SirenReturning,
+    };
+
+    struct Config {
+        std::filesystem::path audioDir;
+        bool enabled = true;
+    };
+
+    static constexpr std::size_t VOICES = 8;
+    static constexpr std::size_t QUEUE_SIZE = 64; // eventi in attesa (oltre si perdono)
+    static constexpr std::size_t FILE_COUNT = 9;   // 8 effetti e la musica d'inizio
+
+    explicit AudioManager(const Config& config);
+    ~AudioManager();
+    AudioManager(const AudioManager&) = delete;
+    AudioManager& operator=(const AudioManager&) = delete;
+
+    // Nome (statico) del file index (0..FILE_COUNT-1), per i log e la traccia
+    static const char* getFileName(std::size_t index);
+    // Carica il file index; chiamate su indici diversi possono girare insieme su più thread.
+    // Prima di start(); false se il file non si carica (o l'audio è disabilitato)
+    bool loadFile(std::size_t index);
+    // Avvia il thread audio, dopo i loadFile (e la loro sincronizzazione). Senza audio non fa niente
+    void start();
+
+    // Solo dal thread principale
+    void post(Event event);
+    // Eventi dell'ultimo advance e cambi di stato dei fantasmi (sirena), dal thread principale
+    void postSimulation(const GameSimulation& sim);
+
+    // Vero dalla GameStarted che avvia la musica d'inizio alla sua fine: la partita aspetta
+    bool isIntroPlaying() const { return m_introPlaying.load(std::memory_order_acquire); }
+    bool isEnabled() const { return m_enabled; }
+
+private:
+    enum Sample : std::uint8_t {
+        Chomp, ChompMenu, EatGhost, Death, Menu, GhostBlue, GhostReturn, GhostNormal, SAMPLE_COUNT
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Voice {
+        std::optional<sf::Sound> sound;
+        Sample sample = SAMPLE_COUNT;
+        float volume = 0.f;         // 0-100
+        float target = 0.f;
+        float rate = 0.f;           // volume al secondo verso target
+        bool pauseAtZero = false;   // a volume 0: pause (chomp) invece di stop
+        std::uint64_t serial = 0;   // ordine di avvio, per rubare l'effetto più vecchio
+    };
+
+    void run();
+    void handle(Event event, Clock::time_point now);
+    void update(float dt, Clock::time_point now);
+
+    int startVoice(Sample sample, bool looping, float volume);
+    void playEffect(Sample sample);
+    void fade(int voice, float target, float seconds, bool pauseAtZero = false);
+    void stopVoice(int voice);
+    bool isBusy(int voice) const;
+    void updateSiren(float seconds);
+    void silenceLoops(float seconds);
+
+    bool m_enabled = false;
+    std::filesystem::path m_audioDir;
+    std::array<sf::SoundBuffer, SAMPLE_COUNT> m_buffers;
+    std::array<bool, SAMPLE_COUNT> m_loaded{};
+    sf::Music m_intro;
+    bool m_introLoaded = false;
+
+    // Coda: scritta dal thread principale, letta dal thread audio
+    std::array<Event, QUEUE_SIZE> m_queue{};
+    alignas(64) std::atomic<unsigned> m_head{0};
+    alignas(64) std::atomic<unsigned> m_tail{0};
+    std::atomic<bool> m_introPlaying{false};
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+
+    // Stato del thread principale (postSimulation)
+    bool m_introRequested = false;
+    bool m_postedStarted = false;
+    Event m_postedSiren = SirenNormal;
+
+    // Stato del thread audio
+    std::array<Voice, VOICES> m_voices;
+    std::uint64_t m_voiceSerial = 0;
+    int m_chompVoice = -1;
+    int m_sirenVoice = -1;
+    Event m_siren = SirenNormal;
+    bool m_sirenAllowed = false;    // dopo PlayerStarted
+    bool m_loopsActive = false;     // partita in corso e non in pausa
+    bool m_introStarted = false;
+    Clock::time_point m_lastPellet;
+    Clock::time_point m_lastMenuMove;
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "GameSimulation.hpp"
+#include "GameState.hpp"
+#include "Pcg32.hpp"
+
+class ThreadPool;
+
+// =========================
+// Autopilota di Pac-Man (Monte Carlo tree search)
+// =========================
+// Sceglie la direzione di Pac-Man simulando molti futuri della partita con la simulazione stessa
+// come modello: fantasmi, target (Blinky, Pinky, Inky, Clyde), frightened e frutti si comportano
+// esattamente come nella partita vera. Ogni ricerca parte da GameSimulation::snapshot() e ogni
+// iterazione fa restore() su una simulazione privata del worker, quindi il gioco non viene toccato.
+// Le azioni sono "tieni la direzione d per actionTicks tick"; l'albero (UCT) arriva al più a
+// horizonTicks, poi un rollout casuale (mai indietro se c'è un'altra uscita) completa l'orizzonte.
+// Ricompensa: punti fatti, -1 se Pac-Man muore, +1 se finisce il livello, meno la distanza dal
+// pellet più vicino a fine orizzonte (così non gira a vuoto lontano dai pellet).
+// In parallelo ogni worker del pool cresce un albero proprio dallo stesso snapshot e alla fine
+// si sommano le visite delle azioni alla radice (root parallelization): nessun lock durante la ricerca.
+// Il risultato è un SimInput come quello della tastiera: il replay registra le scelte e le verifica.
+// =========================
+class Autopilot {
+public:
+    struct Config {
+        float budgetSeconds = 0.004f;     // tempo reale per ricerca (0 = solo maxIterations)
+        std::uint32_t maxIterations = 0;  // iterazioni per ricerca, somma dei worker (0 = solo budget)
+        unsigned threads = 0;             // 0 = un worker per core, 1 = ricerca sul thread chiamante
+        unsigned actionTicks = 12;        // tick per azione e tra due ricerche (0.1 s)
+        unsigned horizonTicks = 240;      // futuro simulato per iterazione (2 s)
+        float exploration = 0.7f;         // costante di UCB1
+        std::uint32_t seed = 0;           // rollout casuali (ricerche riproducibili con threads = 1 e solo maxIterations)
+    };
+
+    // Esito dell'ultima ricerca
+    struct Stats {
+        std::uint64_t iterations = 0;
+        std::uint64_t ticks = 0;          // tick simulati da tutti i worker
+        double seconds = 0.0;             // tempo reale della ricerca
+        std::uint32_t visits[4] = {};     // visite per direzione (TileMap::DIR_DX/DIR_DY)
+        float value[4] = {};              // ricompensa media per direzione
+        int action = -1;                  // direzione scelta, -1 se nessuna ricerca
+    };
+
+    // simConfig: le mappe della partita da pilotare (le simulazioni dei worker sono sempre headless)
+    Autopilot(const GameSimulation::Config& simConfig, const Config& config);
+    ~Autopilot();
+    Autopilot(const Autopilot&) = delete;
+    Autopilot& operator=(const Autopilot&) = delete;
+
+    // Input per il prossimo tick: ricerca ogni actionTicks tick di sim (o dopo una vita persa o
+    // un livello nuovo), altrimenti ripete l'ultima direzione scelta
+    SimInput next(const GameSimulation& sim);
+    // Ricerca subito dallo stato attuale di sim
+    SimInput search(const GameSimulation& sim);
+    // Nuova partita: dimentica l'ultima scelta e riparte dal seme dei rollout
+    void reset(std::uint32_t seed);
+
+    const Stats& getStats() const { return m_stats; }
+    // Ricerche e tick simulati dalla creazione
+    std::uint64_t getSearchCount() const { return m_totalSearches; }
+    std::uint64_t getSimulatedTicks() const { return m_totalTicks; }
+    const Config& getConfig() const { return m_config; }
+    unsigned getWorkerCount() const;
+
+private:
+    static constexpr std::uint32_t NO_SEARCH = 0xFFFFFFFFu;
+
+    struct Node {
+        std::int32_t child[4];
+        std::uint32_t visits;
+        float reward;
+        std::uint8_t untried; // bit per direzione non ancora espansa
+    };
+
+    struct Worker {
+        std::unique_ptr<GameSimulation> sim;
+        std::vector<Node> nodes;
+        std::vector<std::int32_t> path;
+        Pcg32 rng;
+        std::uint32_t search = NO_SEARCH; // ricerca a cui appartiene l'albero
+        std::uint64_t iterations = 0;
+        std::uint64_t ticks = 0;
+    };
+
+    void runWorker(Worker& worker, const GameState& root, std::uint32_t searchIndex);
+    float iterate(Worker& worker, const GameState& root);
+    // Tiene la direzione dir per actionTicks tick; false se la partita si ferma (morte, fine livello)
+    bool applyAction(Worker& worker, int dir, unsigned& ticks, std::uint32_t& events);
+    int rolloutAction(Worker& worker) const;
+    float evaluate(const GameSimulation& sim, const GameState& root, std::uint32_t events) const;
+
+    GameSimulation::Config m_simConfig;
+    Config m_config;
+    std::unique_ptr<ThreadPool> m_pool;   // nullptr con threads = 1
+    std::vector<Worker> m_workers;        // uno per worker del pool
+    std::atomic<std::uint64_t> m_iterationsLeft{0};
+    std::chrono::steady_clock::time_point m_deadline;
+    std::uint32_t m_searches = 0;
+
+    Stats m_stats;
+    std::uint64_t m_totalSearches = 0;
+    std::uint64_t m_totalTicks = 0;
+    sf::Vector2f m_heading{0.f, 0.f};     // ultima direzione scelta
+    std::uint64_t m_nextSearchTick = 0;
+    int m_searchedLevel = -1;
+    int m_searchedLives = -1;
+};
@@ -4,24 +4,26 @@
 
 class Blinky : public Ghost {
 public:
-    Blinky(const sf::Vector2f& pos);
+    Blinky(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos);
     void update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
                 const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode, bool gameStarted = true) override;
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
-    
+
 protected:
+    const sf::Sprite* currentSprite() const override;
     sf::Vector2f calculateTarget(const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, 
                                const TileMap& map, const sf::Vector2u& tileSize) override;
+    sf::Vector2f findPath(const sf::Vector2f& target, const TileMap& map, const sf::Vector2u& tileSize) override;
 
 private:
     // --- Sprite e animazione Blinky ---
-    std::unique_ptr<sf::Texture> m_texture;
     std::unique_ptr<sf::Sprite> m_sprite;
     bool m_hasTexture = false;
     float m_animTime = 0.f;
     int m_animFrame = 0;
+    float m_debugTimer = 0.f; // log di debug una volta al secondo, per fantasma
 
+    // Chase: primo passo del cammino minimo verso Pac-Man (next-hop del campo di flusso verso Pac-Man)
     sf::Vector2f findPathToPacman(const sf::Vector2f& pacmanPos, const TileMap& map, const sf::Vector2u& tileSize);
-    sf::Vector2f greedyFallback(const sf::Vector2f& pacmanPos, const TileMap& map, const sf::Vector2u& tileSize, 
-                               int startX, int startY, int w, int h);
+    // Quando il next-hop non è utilizzabile (reverse, ghost house): scelta per distanza come gli altri fantasmi
+    sf::Vector2f greedyFallback(const sf::Vector2f& pacmanPos, const TileMap& map, const sf::Vector2u& tileSize);
 };
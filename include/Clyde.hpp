@@ -4,7 +4,7 @@
 
 class Clyde : public Ghost {
 public:
-    Clyde(const sf::Vector2f& pos);
+    Clyde(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos);
     void update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
                 const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode, bool gameStarted = true, bool released = true);
 protected:
@@ -12,10 +12,10 @@ protected:
                                  const TileMap& map, const sf::Vector2u& tileSize) override;
 private:
     // --- Sprite e animazione Clyde ---
-    std::unique_ptr<sf::Texture> m_texture;
     std::unique_ptr<sf::Sprite> m_sprite;
     bool m_hasTexture = false;
     float m_animTime = 0.f;
     int m_animFrame = 0;
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    float m_debugTimer = 0.f; // log di debug una volta al secondo, per fantasma
+    const sf::Sprite* currentSprite() const override;
 };
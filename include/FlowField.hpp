@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "TileMap.hpp"
+
+// =========================
+// Campo di flusso verso un target
+// =========================
+// Distanza in passi da ogni nodo della mappa a un nodo target (BFS dal target, tunnel compresi).
+// Il grafo non è orientato, quindi la stessa BFS dà a ogni fantasma la distanza verso il target
+// e il primo passo del cammino minimo: una scelta di direzione costa 4 letture, qualunque sia il fantasma.
+// =========================
+class FlowField {
+public:
+    // Riserva spazio per la mappa: build() successive non allocano
+    void reserve(std::size_t nodeCount);
+    // BFS dal target (-1 = nessun target: tutti i nodi irraggiungibili)
+    void build(const TileMap& map, int targetNode);
+
+    int getTarget() const { return m_target; }
+    std::uint16_t distance(int node) const {
+        if (node < 0 || static_cast<std::size_t>(node) >= m_dist.size()) return TileMap::UNREACHABLE;
+        return m_dist[node];
+    }
+    // Primo passo del cammino minimo da node (indice direzione) o NO_DIRECTION se già arrivati.
+    // A parità di distanza vince l'ordine su, sinistra, giù, destra
+    std::uint8_t nextHop(const TileMap& map, int node) const;
+
+private:
+    int m_target = -1;
+    std::vector<std::uint16_t> m_dist;
+    std::vector<std::int16_t> m_frontier;
+};
+
+// =========================
+// Campi di flusso condivisi dai fantasmi di una simulazione
+// =========================
+// Un campo per target, calcolato alla prima richiesta e tenuto finché il target resta lo stesso:
+// il campo verso Pac-Man si ricalcola solo quando Pac-Man cambia cella, quelli degli angoli di
+// scatter restano validi per tutto il livello. Fantasmi con lo stesso target (tutti quelli che
+// inseguono Pac-Man, tutti quelli in scatter verso lo stesso angolo) leggono lo stesso campo,
+// quindi il costo per tick dipende dal numero di target distinti e non dal numero di fantasmi.
+// Con più di CAPACITY target diversi si scarta il campo usato meno di recente.
+// =========================
+class FlowFieldCache {
+public:
+    static constexpr std::size_t CAPACITY = 8;
+
+    // Nuova mappa (o mappa ricaricata): campi invalidati e memoria riservata per i nodi della mappa,
+    // così i calcoli durante gli update dei fantasmi non allocano
+    void reset(const TileMap& map);
+    // Campo verso targetNode; il riferimento resta valido fino alla prossima chiamata
+    const FlowField& toward(int targetNode);
+
+    // Campi calcolati (BFS eseguite) dalla creazione
+    std::uint64_t getBuildCount() const { return m_builds; }
+
+private:
+    struct Slot {
+        FlowField field;
+        std::uint64_t lastUse = 0;
+        bool valid = false;
+    };
+
+    const TileMap* m_map = nullptr;
+    std::array<Slot, CAPACITY> m_slots;
+    std::uint64_t m_clock = 0;
+    std::uint64_t m_builds = 0;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "TraceRecorder.hpp"
+
+// Con -DPACMUX_FRAME_PROFILER=0 (opzione CMake PACMUX_FRAME_PROFILER) il profiler resta nel codice
+// ma ogni misura è vuota: nessuna lettura dell'orologio, nessuna scrittura
+#ifndef PACMUX_FRAME_PROFILER
+#define PACMUX_FRAME_PROFILER 0
+#endif
+
+// =========================
+// Profiler dei frame del gioco
+// =========================
+// Il ciclo principale misura le sue fasi con Scope (eventi, simulazione, audio, passate di disegno,
+// display) e la simulazione aggiunge i suoi sottosistemi (Pac-Man, fantasmi, pellet, frutti, collisioni).
+// Ogni frame è una riga di HISTORY righe circolari; endFrame() la pubblica con un indice atomico,
+// così un lettore (l'overlay, o un altro thread) legge le righe pubblicate senza lock.
+// summarize() dà min, media, p99 e max (ms) di una fase sugli ultimi frame.
+// Con una traccia attiva (TraceRecorder) ogni Scope e ogni frame diventano anche eventi B/E.
+// =========================
+class FrameProfiler {
+public:
+    static constexpr bool ENABLED = PACMUX_FRAME_PROFILER != 0;
+    static constexpr std::size_t HISTORY = 256; // frame (circa 4 s a 60 fps)
+
+    enum Phase : int {
+        Frame,          // da beginFrame a endFrame
+        Events,         // pollEvent e tasti
+        Simulation,     // advance (tutti i tick del frame)
+        SimPlayer,      // parti di Simulation, da GameSimulation::SubsystemTimes
+        SimGhosts,
+        SimPellets,
+        SimFruits,
+        SimCollisions,
+        SimLevelLoad,
+        Audio,          // eventi accodati all'AudioManager
+        DrawMap,        // labirinto e pellet (sfondo statico o per tile)
+        DrawActors,
+        DrawHud,        // punteggio, vite, livello, overlay
+        Display,        // window.display (vsync compreso)
+        PHASE_COUNT
+    };
+
+    struct Summary {
+        float min = 0.f; // millisecondi
+        float avg = 0.f;
+        float p99 = 0.f;
+        float max = 0.f;
+        std::size_t frames = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    // Misura dalla costruzione a stop() (o alla distruzione) e la somma alla fase nel frame corrente
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, Phase phase) {
+            if constexpr (ENABLED) {
+                m_profiler = &profiler;
+                m_phase = phase;
+                TraceRecorder::begin(phaseName(phase), "frame");
+                m_start = Clock::now();
+            }
+        }
+        ~Scope() { stop(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void stop() {
+            if constexpr (ENABLED) {
+                if (!m_profiler) return;
+                m_profiler->add(m_phase, std::chrono::duration<double>(Clock::now() - m_start).count());
+                TraceRecorder::end(phaseName(m_phase), "frame");
+                m_profiler = nullptr;
+            }
+        }
+
+    private:
+        FrameProfiler* m_profiler = nullptr;
+        Phase m_phase = Frame;
+        Clock::time_point m_start;
+    };
+
+    FrameProfiler();
+
+    // Inizio del frame: azzera la riga corrente. Un frame lasciato senza endFrame (menu, pausa)
+    // non viene pubblicato e nella traccia finisce qui
+    void beginFrame() {
+        if constexpr (ENABLED) {
+            for (auto& sample : m_rows[m_frame % HISTORY]) sample.store(0.f, std::memory_order_relaxed);
+            if (m_frameOpen) TraceRecorder::end("frame", "frame");
+            m_frameOpen = true;
+            TraceRecorder::begin("frame", "frame");
+            m_frameStart = Clock::now();
+        }
+    }
+    // Somma seconds alla fase nel frame corrente (solo dal thread che chiama beginFrame/endFrame)
+    void add(Phase phase, double seconds) {
+        if constexpr (ENABLED) {
+            std::atomic<float>& sample = m_rows[m_frame % HISTORY][phase];
+            sample.store(sample.load(std::memory_order_relaxed) + float(seconds * 1000.0), std::memory_order_relaxed);
+        }
+    }
+    // Fine del frame: misura Frame e rende la riga visibile ai lettori
+    void endFrame() {
+        if constexpr (ENABLED) {
+            add(Frame, std::chrono::duration<double>(Clock::now() - m_frameStart).count());
+            TraceRecorder::end("frame", "frame");
+            m_frameOpen = false;
+            ++m_frame;
+            m_published.store(m_frame, std::memory_order_release);
+        }
+    }
+
+    // Frame pubblicati dall'avvio
+    std::uint64_t getFrameCount() const { return m_published.load(std::memory_order_acquire); }
+    // Statistiche della fase sugli ultimi frames frame pubblicati (al più HISTORY - 1)
+    Summary summarize(Phase phase, std::size_t frames = HISTORY - 1) const;
+    // Tabella di tutte le fasi (una riga per fase), per l'overlay e la console
+    std::string report(std::size_t frames = HISTORY - 1) const;
+    static const char* phaseName(Phase phase);
+
+private:
+    std::array<std::array<std::atomic<float>, PHASE_COUNT>, HISTORY> m_rows; // millisecondi per fase
+    std::uint64_t m_frame = 0;                    // frame in scrittura (solo lo scrittore)
+    std::atomic<std::uint64_t> m_published{0};    // frame completi
+    Clock::time_point m_frameStart;
+    bool m_frameOpen = false;                     // beginFrame senza endFrame
+};
@@ -2,6 +2,7 @@
 
 #include <SFML/Graphics.hpp>
 #include <memory>
+#include "SpriteBatch.hpp"
 
 // Frutto collezionabile semplice, disegnato dalla sprite sheet condivisa pacman.png.
 // Le celle della mappa marcate con 'F' generano i frutti. Supportiamo almeno 2 tipi.
@@ -22,13 +23,23 @@ public:
     // Punteggio assegnato quando viene raccolto
     int getScore() const;
 
+    // Centro, tipo e tempo di vita (per GameState: un frutto si ricrea con costruttore e setTimeAlive)
+    sf::Vector2f getCenter() const { return m_position; }
+    Type getType() const { return m_type; }
+    float getTimeAlive() const { return m_timeAlive; }
+    void setTimeAlive(float seconds) { m_timeAlive = seconds; }
+
+    // Aggiunge lo sprite (o il cerchio di fallback) al batch degli attori
+    void appendTo(SpriteBatch& batch, const sf::Transform& transform = sf::Transform::Identity) const;
+
 private:
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
     // Texture e Sprite per il rendering (come Pac-Man e i Ghost)
-    std::unique_ptr<sf::Texture> m_texture;
+    std::shared_ptr<const sf::Texture> m_texture; // atlas condiviso (SpriteSheet)
     std::unique_ptr<sf::Sprite> m_sprite;
     bool m_hasTexture = false;
+    sf::Vector2f m_position;
     Type m_type;
 
     // Timer di vita del frutto (in secondi)
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+#include <array>
+#include <cstdint>
+#include "TileMap.hpp"
+#include "Player.hpp"
+#include "PelletGrid.hpp"
+#include "Fruit.hpp"
+#include "Ghost.hpp"
+#include "FlowField.hpp"
+#include "Pcg32.hpp"
+#include "GameState.hpp"
+
+class ReplayWriter;
+
+// Input di un tick: direzione desiderata per Pac-Man.
+// Nel gioco la campiona main.cpp dalla tastiera, in headless la fornisce uno script o un agente.
+struct SimInput {
+    sf::Vector2f direction{0.f, 0.f}; // (-1,0),(1,0),(0,-1),(0,1) oppure (0,0) = nessun tasto
+};
+
+// =========================
+// Simulazione di gioco headless
+// =========================
+// Possiede tutto lo stato del gameplay (mappa, Pac-Man, fantasmi, pellet, frutti, timer, vite, livello)
+// e lo fa avanzare a passo fisso (TICK) con advance(frameDt, input) o direttamente con step(TICK, input).
+// Non apre finestre, non carica font e non riproduce suoni: il chiamante reagisce agli eventi
+// (suoni, messaggi) e disegna leggendo lo stato, interpolato tra gli ultimi due tick.
+// Lo stesso input con lo stesso seme dà sempre la stessa partita, a qualunque frame rate;
+// in headless si può chiamare step(TICK, ...) in un ciclo stretto, più veloce del tempo reale.
+// =========================
+class GameSimulation {
+public:
+    struct Config {
+        std::vector<std::string> mapFiles;  // percorsi delle mappe, nell'ordine dei livelli
+        sf::Vector2u tileSize{32, 32};
+        std::uint32_t seed = 0;             // seme RNG (spawn frutti, scelte dei fantasmi in frightened)
+        bool headless = false;              // true = nessuna texture caricata (SpriteSheet disabilitata)
+    };
+
+    // Tempo reale (secondi) speso in ogni sottosistema, accumulato solo con setProfiling(true)
+    struct SubsystemTimes {
+        double player = 0.0;     // movimento e animazione di Pac-Man
+        double ghosts = 0.0;     // rilascio, scatter/chase e update dei fantasmi
+        double pellets = 0.0;    // pellet e super pellet
+        double fruits = 0.0;
+        double collisions = 0.0; // Pac-Man contro fantasmi
+        double levelLoad = 0.0;  // caricamento mappa e reset di livello/vita
+
+        double total() const { return player + ghosts + pellets + fruits + collisions + levelLoad; }
+        SubsystemTimes& operator+=(const SubsystemTimes& other);
+    };
+
+    // Eventi accaduti durante l'ultimo step (bitmask)
+    enum Event : std::uint32_t {
+        PelletEaten        = 1u << 0,
+        SuperPelletEaten   = 1u << 1,
+        FruitEaten         = 1u << 2,
+        GhostEaten         = 1u << 3,
+        PlayerDied         = 1u << 4,  // inizio animazione di morte
+        LifeLost           = 1u << 5,  // animazione finita, livello ricaricato (vite > 0)
+        GameOver           = 1u << 6,  // animazione finita, vite esaurite
+        LevelCompleted     = 1u << 7,
+        AllLevelsCompleted = 1u << 8,  // ultimo livello completato: difficoltà aumentata
+        ExtraLife          = 1u << 9,
+        LevelLoadFailed    = 1u << 10
+    };
+
+    static constexpr float PLAYER_SPEED = 120.f;
+    static constexpr int START_LIVES = 3;
+    static constexpr unsigned EXTRA_LIFE_SCORE = 10000;
+    static constexpr float GHOST_EAT_PAUSE = 1.0f;
+
+    // Passo fisso della simulazione (120 Hz) e frame più lungo recuperabile (oltre si rallenta)
+    static constexpr float TICK = 1.f / 120.f;
+    static constexpr float MAX_FRAME_TIME = 0.25f;
+
+    // Eventi dopo i quali advance() si ferma e scarta il tempo residuo del frame,
+    // così il chiamante mostra messaggi o la pausa prima che la simulazione vada avanti
+    static constexpr std::uint32_t INTERRUPT_EVENTS =
+        GhostEaten | PlayerDied | LifeLost | GameOver | LevelCompleted | AllLevelsCompleted | ExtraLife | LevelLoadFailed;
+
+    explicit GameSimulation(const Config& config);
+    // I fantasmi puntano ai campi di flusso della simulazione: niente copie
+    GameSimulation(const GameSimulation&) = delete;
+    GameSimulation& operator=(const GameSimulation&) = delete;
+
+    // Nuova partita: punteggio, vite, livello e difficoltà ripartono da zero.
+    // Il generatore riparte dal seme, quindi stesso seme + stessi input = stessa partita
+    bool newGame() { return newGame(m_config.seed); }
+    bool newGame(std::uint32_t seed);
+
+    // Avanza la simulazione di dt secondi (un tick: usare TICK per partite riproducibili)
+    void step(float dt, const SimInput& input);
+
+    // Accumula frameDt ed esegue tutti i tick fissi che ci stanno; getEvents() riporta l'unione
+    // degli eventi dei tick eseguiti. Ritorna il numero di tick
+    int advance(float frameDt, const SimInput& input);
+    // Frazione di tick accumulata e non ancora simulata (0..1), da passare a setRenderAlpha
+    float getInterpolationAlpha() const { return m_accumulator / TICK; }
+    // Posizioni di disegno di Pac-Man e fantasmi interpolate tra il tick precedente e quello attuale
+    void setRenderAlpha(float alpha);
+    // Scarta il tempo accumulato (es. dopo una pausa o un cambio di focus)
+    void resetAccumulator() { m_accumulator = 0.f; }
+
+    // Registrazione (opzionale, non posseduta): ogni step e ogni snapPlayerToTile finiscono nel replay
+    void setRecorder(ReplayWriter* recorder) { m_recorder = recorder; }
+    std::uint32_t getSeed() const { return m_seed; }
+    const std::vector<std::string>& getMapFiles() const { return m_config.mapFiles; }
+    // Tick eseguiti dall'inizio della partita
+    std::uint64_t getTick() const { return m_tick; }
+    // Allocazioni heap fatte dagli update dei fantasmi dall'inizio della partita (attese: zero).
+    // Misurate solo nelle build di debug, vedi AllocationCounter
+    std::uint64_t getGhostUpdateAllocations() const { return m_ghostUpdateAllocations; }
+    // Misura dei sottosistemi (due letture dell'orologio per sottosistema e tick, spenta di default).
+    // I tempi si accumulano tra le partite finché non si chiama resetSubsystemTimes
+    void setProfiling(bool enabled) { m_profiling = enabled; }
+    const SubsystemTimes& getSubsystemTimes() const { return m_times; }
+    void resetSubsystemTimes() { m_times = SubsystemTimes{}; }
+    // BFS dei campi di flusso dei fantasmi eseguite dalla creazione (una per target nuovo, non per fantasma)
+    std::uint64_t getFlowFieldBuilds() const { return m_flowFields.getBuildCount(); }
+
+    // --- Eventi dell'ultimo step ---
+    std::uint32_t getEvents() const { return m_events; }
+    bool hasEvent(Event e) const { return (m_events & e) != 0; }
+
+    // --- Stato leggibile dal renderer ---
+    const TileMap& getMap() const { return m_map; }
+    const sf::Vector2u& getTileSize() const { return m_tileSize; }
+    const Player& getPlayer() const { return m_player; }
+    // Posizioni logiche di tutti gli attori (slot ActorPositions::PLAYER e fantasmi da 1)
+    const ActorPositions& getActorPositions() const { return m_actorPositions; }
+    const std::vector<std::unique_ptr<Ghost>>& getGhosts() const { return m_ghosts; }
+    const PelletGrid& getPellets() const { return m_pellets; }
+    const PelletGrid& getSuperPellets() const { return m_superPellets; }
+    const std::vector<Fruit>& getFruits() const { return m_fruits; }
+
+    unsigned getScore() const { return m_score; }
+    int getLives() const { return m_player.getLives(); }
+    int getLevel() const { return m_currentLevel; }
+    int getDifficulty() const { return m_difficultyLevel; }
+    bool isStarted() const { return m_started; }
+    bool isGameOver() const { return m_gameOver; }
+    bool isGhostEatPause() const { return m_ghostEatPauseTimer > 0.f; }
+    int getGhostEatScore() const { return m_ghostEatScore; }
+    bool anyGhostFrightened() const;
+    bool anyGhostReturning() const;
+
+    // Allinea Pac-Man al centro della cella e lo ferma (usato entrando in pausa)
+    void snapPlayerToTile();
+
+    // --- Snapshot per rollback e ricerca ---
+    // Copia tutto lo stato di gameplay in un GameState di dimensione fissa (nessuna allocazione)
+    GameState snapshot() const;
+    // Riporta la simulazione allo stato salvato: da lì gli stessi input danno gli stessi tick.
+    // Ricarica la mappa solo se lo snapshot è di un altro livello (o la simulazione non ne ha caricato
+    // nessuno), quindi va bene anche su una simulazione diversa con le stesse mappe.
+    // Il ripristino non finisce nel replay in registrazione. False se la mappa non si carica
+    bool restore(const GameState& state);
+
+private:
+    void update(float dt, const SimInput& input);
+    bool loadLevel(int levelIdx, bool resetPellets = true);
+    void applyDifficulty();
+    void addScore(unsigned value);
+
+    void updateModeTimer(float dt);
+    void updateGhostRelease(float dt);
+    void updateGhosts(float dt);
+    void updatePellets();
+    void spawnFruits();
+    void updateFruits(float dt);
+    void updateSuperPellets();
+    void updateGhostCollisions();
+    void completeLevel();
+    void handleDeathFinished();
+
+    // Primo membro: con Config::headless spegne l'atlas prima che Player e fantasmi cerchino la texture
+    struct HeadlessInit {
+        explicit HeadlessInit(bool headless);
+    };
+
+    HeadlessInit m_headlessInit;
+    Config m_config;
+    sf::Vector2u m_tileSize;
+    Pcg32 m_rng;
+    std::uint32_t m_seed = 0;
+    std::uint32_t m_events = 0;
+    float m_accumulator = 0.f;
+    std::uint64_t m_tick = 0;
+    std::uint64_t m_ghostUpdateAllocations = 0;
+    ReplayWriter* m_recorder = nullptr;
+    bool m_profiling = false;
+    SubsystemTimes m_times;
+
+    TileMap m_map;
+    int m_loadedLevel = -1; // livello di m_map (-1 = nessuno), per restore
+    sf::Vector2u m_mapSize;
+    sf::Vector2f m_startPos;
+    ActorPositions m_actorPositions; // posizioni logiche di Pac-Man e fantasmi, contigue (prima di m_player)
+    Player m_player;
+    std::vector<std::unique_ptr<Ghost>> m_ghosts; // slot ActorPositions 1..4, nell'ordine Blinky, Pinky, Inky, Clyde
+    FlowFieldCache m_flowFields; // condivisi da tutti i fantasmi, invalidati a ogni loadLevel
+    PelletGrid m_pellets;
+    PelletGrid m_superPellets{9.f};
+    std::vector<Fruit> m_fruits;
+
+    // Punteggio e vita extra
+    unsigned m_score = 0;
+    bool m_extraLifeGiven = false;
+
+    // Frutti: contatore pellet mangiati e spawn a 30/70
+    int m_pelletsEatenCount = 0;
+    bool m_fruit30Spawned = false;
+    bool m_fruit70Spawned = false;
+    bool m_firstFruitTypeSet = false;
+    Fruit::Type m_firstFruitType = Fruit::Type::Cherry;
+
+    // Alternanza scatter/chase
+    Ghost::Mode m_ghostMode = Ghost::Mode::Scatter;
+    float m_modeTimer = 0.f;
+    int m_modePhase = 0;
+
+    // Livelli e difficoltà
+    int m_currentLevel = 0;
+    int m_difficultyLevel = 1;
+    float m_ghostBaseSpeed = 90.f;
+    float m_frightenedBaseDuration = 6.0f;
+    float m_ghostRespawnDuration = 3.0f;
+    std::array<float, GameState::MAX_GHOSTS> m_ghostReleaseDelays = {0.f, 3.f, 3.f, 3.f};
+
+    // Release sequenziale dei fantasmi
+    int m_nextGhostToRelease = 0;
+    float m_ghostReleaseTimer = 0.f;
+
+    // Stato partita
+    bool m_started = false;   // false finché il giocatore non fa la prima mossa (inizio partita, dopo vita persa o livello)
+    bool m_gameOver = false;
+
+    // Pausa dopo aver mangiato un fantasma (combo classica)
+    float m_ghostEatPauseTimer = 0.f;
+    int m_ghostEatCombo = 0;
+    int m_ghostEatScore = 0;
+};
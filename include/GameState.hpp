@@ -0,0 +1,82 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "ActorPositions.hpp"
+#include "Pcg32.hpp"
+#include "Player.hpp"
+#include "Ghost.hpp"
+#include "PelletGrid.hpp"
+#include "Fruit.hpp"
+
+// =========================
+// Istantanea di una partita
+// =========================
+// Tutto lo stato di gameplay di GameSimulation (attori, pellet, frutti, timer, fase scatter/chase,
+// generatore) in un blocco di dimensione fissa, senza puntatori né allocazioni: GameSimulation::snapshot()
+// lo riempie con poche copie e restore() lo riapplica, anche su un'altra simulazione con le stesse mappe.
+// Serve al rollback e alla ricerca (provare più futuri dallo stesso punto).
+// Non contiene la mappa (si ricarica dal livello), i campi di flusso (cache derivata dalla mappa),
+// la grafica, il profiling e il replay in corso.
+// =========================
+struct GameState {
+    static constexpr std::size_t MAX_GHOSTS = ActorPositions::CAPACITY - 1;
+    static constexpr std::size_t MAX_FRUITS = 2; // al più due per livello (soglie 30 e 70 pellet)
+
+    struct FruitState {
+        sf::Vector2f center;
+        Fruit::Type type;
+        float timeAlive;
+    };
+
+    // --- Simulazione ---
+    Pcg32 rng;
+    std::uint32_t seed;
+    std::uint64_t tick;
+    float accumulator;
+    std::uint32_t events;
+
+    // --- Attori ---
+    ActorPositions positions;
+    Player::State player;
+    std::uint32_t ghostCount;
+    Ghost::State ghosts[MAX_GHOSTS];
+
+    // --- Pellet e frutti ---
+    PelletGrid::State pellets;
+    PelletGrid::State superPellets;
+    std::uint32_t fruitCount;
+    FruitState fruits[MAX_FRUITS];
+    int pelletsEatenCount;
+    bool fruit30Spawned;
+    bool fruit70Spawned;
+    bool firstFruitTypeSet;
+    Fruit::Type firstFruitType;
+
+    // --- Punteggio, livello e difficoltà ---
+    unsigned score;
+    bool extraLifeGiven;
+    int currentLevel;
+    int difficultyLevel;
+    float ghostBaseSpeed;
+    float frightenedBaseDuration;
+    float ghostRespawnDuration;
+    float ghostReleaseDelays[MAX_GHOSTS];
+
+    // --- Scatter/chase, rilascio dei fantasmi, pausa dopo un fantasma mangiato ---
+    Ghost::Mode ghostMode;
+    float modeTimer;
+    int modePhase;
+    int nextGhostToRelease;
+    float ghostReleaseTimer;
+    float ghostEatPauseTimer;
+    int ghostEatCombo;
+    int ghostEatScore;
+
+    bool started;
+    bool gameOver;
+};
+
+static_assert(std::is_trivially_copyable_v<GameState>, "GameState deve restare copiabile con memcpy");
@@ -2,7 +2,13 @@
 
 #include <SFML/Graphics.hpp>
 #include "TileMap.hpp"
+#include "SpriteBatch.hpp"
+#include "ActorPositions.hpp"
+#include "Pcg32.hpp"
 #include <memory>
+#include <cstdint>
+
+class FlowFieldCache;
 
 class Ghost : public sf::Drawable, public sf::Transformable {
 public:
@@ -19,15 +25,52 @@ public:
         Frightened
     };
 
-    Ghost(const sf::Vector2f& pos, sf::Color color, float radius, Type type);
+    // Stato di gameplay del fantasma per GameState (la posizione sta in ActorPositions).
+    // Tipo, slot, velocità di base e campi di flusso non cambiano durante il livello e non ci sono
+    struct State {
+        sf::Vector2f direction;
+        sf::Vector2f target;
+        sf::Vector2f drawPos;
+        sf::Vector2f prevDrawPos;
+        float speed;
+        float normalSpeed;
+        Mode mode;
+        bool hasLeftGhostHouse;
+        bool isFrightened;
+        float frightenedTimer;
+        float frightenedDuration;
+        bool eaten;
+        bool isReturningToHouse;
+        float respawnTimer;
+        float respawnDuration;
+        float releaseDelay;
+        bool canLeaveHouse;
+        bool released;
+        Pcg32 rng;
+        int corridor;
+        int corridorReverse;
+        float corridorProgress;
+        float corridorLength;
+        float animTime;
+        int animFrame;
+    };
+
+    // La posizione logica vive nello slot `slot` di positions (posseduto dalla simulazione)
+    Ghost(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos, sf::Color color, float radius, Type type);
     virtual ~Ghost() = default;
 
     virtual void update(float dt, const TileMap& map, const sf::Vector2u& tileSize, 
                        const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode, bool gameStarted = true);
-    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    // Aggiunge il frame corrente (o il cerchio di fallback) al batch degli attori
+    void appendTo(SpriteBatch& batch, const sf::Transform& transform = sf::Transform::Identity) const;
     
     void setPosition(const sf::Vector2f& pos);
-    sf::Vector2f getPosition() const { return m_shape.getPosition(); }
+    sf::Vector2f getPosition() const { return position(); }
+
+    // Interpolazione del disegno tra due tick fissi (come Player::beginTick/setRenderAlpha)
+    void beginTick() { m_prevDrawPos = m_drawPos; }
+    void setRenderAlpha(float alpha) { m_renderAlpha = alpha; }
     
     Type getType() const { return m_type; }
     bool hasLeftGhostHouse() const { return m_hasLeftGhostHouse; }
@@ -42,6 +85,12 @@ public:
     bool isReturningToHouse() const { return m_isReturningToHouse; }
 
     void setSpeed(float speed) { m_speed = speed; m_normalSpeed = speed; }
+    // Seme del generatore usato in frightened: la simulazione lo deriva dal proprio, così le partite sono riproducibili
+    void setRandomSeed(std::uint32_t seed) { m_rng.seed(seed); }
+    State getState() const;
+    void setState(const State& state);
+    // Campi di flusso condivisi con gli altri fantasmi della simulazione (non posseduti), usati da findPath
+    void setFlowFields(FlowFieldCache* fields) { m_flowFields = fields; }
     void setReleaseDelay(float delay) { m_releaseDelay = delay; m_canLeaveHouse = false; }
     // Imposta quanto tempo il fantasma resta nella ghost house dopo essere stato mangiato
     void setRespawnDuration(float seconds) { m_respawnDuration = seconds; }
@@ -77,16 +126,53 @@ protected:
     virtual sf::Vector2f calculateTarget(const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, 
                                         const TileMap& map, const sf::Vector2u& tileSize) = 0;
     
+    // Sprite pronto per il frame corrente (texture rect e posizione aggiornati), nullptr se senza texture.
+    // Ogni fantasma ridefinisce solo la scelta del frame: draw e appendTo sono comuni
+    virtual const sf::Sprite* currentSprite() const;
+    // m_drawPos interpolata tra l'inizio e la fine dell'ultimo tick (nessuna interpolazione nei tunnel)
+    sf::Vector2f renderPosition() const;
+
     virtual sf::Vector2f findPath(const sf::Vector2f& target, const TileMap& map, const sf::Vector2u& tileSize);
     bool canMove(const sf::Vector2f& direction, const TileMap& map, const sf::Vector2u& tileSize);
     
     // Trova la porta di uscita della ghost house (prima cella non ghost house sopra la posizione attuale)
     sf::Vector2f getGhostHouseExit(const TileMap& map, const sf::Vector2u& tileSize) const;
-
-    sf::CircleShape m_shape;
+    // Angolo della mappa assegnato al fantasma in scatter
+    sf::Vector2f scatterTarget(const TileMap& map, const sf::Vector2u& tileSize) const;
+
+    // --- Movimento sul grafo degli incroci (TileMap::getCorridors) ---
+    // Fuori dalla ghost house il fantasma percorre un corridoio alla volta e sceglie la direzione solo
+    // all'arrivo su un incrocio; lo spazio avanzato oltre l'incrocio passa al corridoio successivo.
+    // Si aggancia al grafo quando è al centro di una cella fuori dalla ghost house
+    bool attachToGraph(const TileMap& map, const sf::Vector2u& tileSize,
+                       const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection);
+    void travelGraph(float dt, const TileMap& map, const sf::Vector2u& tileSize,
+                     const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection);
+    // Direzione voluta dal centro della cella attuale: casuale in frightened, altrimenti findPath verso il target
+    sf::Vector2f decideDirection(const TileMap& map, const sf::Vector2u& tileSize,
+                                 const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection);
+    // Corridoio da prendere all'incrocio (il fantasma deve esserne al centro); il reverse solo nei vicoli ciechi
+    int chooseCorridor(int junction, const TileMap& map, const sf::Vector2u& tileSize,
+                       const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection);
+    void enterCorridor(int corridor, float progress, const TileMap& map, const sf::Vector2u& tileSize);
+    // Posiziona il fantasma e m_direction secondo corridoio e avanzamento correnti
+    void placeOnCorridor(const TileMap& map, const sf::Vector2u& tileSize);
+
+    // Posizione logica nello slot dell'attore (ActorPositions della simulazione)
+    sf::Vector2f position() const { return m_positions->get(m_slot); }
+    void placeAt(const sf::Vector2f& pos) { m_positions->set(m_slot, pos); }
+    void moveBy(const sf::Vector2f& delta) { m_positions->move(m_slot, delta); }
+
+    ActorPositions* m_positions;
+    std::size_t m_slot;
+    // Cerchio di fallback senza texture: costruito solo quando si disegna
+    float m_radius;
+    sf::Color m_color;
     sf::Vector2f m_direction;
     sf::Vector2f m_target;
     sf::Vector2f m_drawPos;
+    sf::Vector2f m_prevDrawPos;
+    float m_renderAlpha = 1.f;
     float m_speed;
     // Velocità "normale" da ripristinare dopo frightened/respawn
     float m_normalSpeed = 90.f;
@@ -111,8 +197,21 @@ protected:
 
     bool m_released = false;
 
+    // Scelte casuali in frightened (seme da setRandomSeed)
+    Pcg32 m_rng;
+
+    // Campi di flusso verso i target (da setFlowFields); senza, findPath non ha cammini e va su
+    FlowFieldCache* m_flowFields = nullptr;
+
+    // Corridoio percorso (-1 = fuori dal grafo: nella ghost house, mangiato o appena riposizionato),
+    // lo stesso al contrario (per l'inversione in frightened), avanzamento e lunghezza in pixel
+    int m_corridor = -1;
+    int m_corridorReverse = -1;
+    float m_corridorProgress = 0.f;
+    float m_corridorLength = 0.f;
+
     // Sprite e texture per animazione (come negli altri fantasmi)
-    std::unique_ptr<sf::Texture> m_texture;
+    std::shared_ptr<const sf::Texture> m_texture; // atlas condiviso (SpriteSheet)
     std::unique_ptr<sf::Sprite> m_sprite;
     bool m_hasTexture = false;
     float m_animTime = 0.f;
@@ -79,7 +79,7 @@ private:
     static const std::string JSONBIN_API_KEY;    // Token per scrittura via API
     
     std::vector<GlobalEntry> m_globalScores;
-    sf::Font m_font;
+    const sf::Font& m_font; // condiviso (TextCache)
     Status m_status;
     std::string m_errorMessage;
     std::string m_apiToken;  // Token caricato da variabile d'ambiente
@@ -40,7 +40,7 @@ public:
 private:
     static const size_t MAX_SCORES = 10; // Numero massimo di record da mantenere
     std::vector<HighScoreEntry> m_scores;
-    sf::Font m_font;
+    const sf::Font& m_font; // condiviso (TextCache)
     std::string m_filename;
 
     // Metodi di utilità
@@ -4,7 +4,7 @@
 
 class Inky : public Ghost {
 public:
-    Inky(const sf::Vector2f& pos);
+    Inky(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos);
     // Overload: update with Blinky's position for correct targeting and release logic
     void update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
                 const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode,
@@ -19,10 +19,10 @@ protected:
                                  const TileMap& map, const sf::Vector2u& tileSize, const sf::Vector2f& blinkyPos);
 private:
     // --- Sprite e animazione Inky ---
-    std::unique_ptr<sf::Texture> m_texture;
     std::unique_ptr<sf::Sprite> m_sprite;
     bool m_hasTexture = false;
     float m_animTime = 0.f;
     int m_animFrame = 0;
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    float m_debugTimer = 0.f; // log di debug una volta al secondo, per fantasma
+    const sf::Sprite* currentSprite() const override;
 };
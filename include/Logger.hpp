@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+
+// Livello minimo compilato: i messaggi sotto questo livello spariscono dal codice (argomenti
+// compresi). Di default Debug nelle build di debug e Info con NDEBUG; opzione CMake PACMUX_LOG_LEVEL
+// (0 debug, 1 info, 2 warning, 3 error)
+#ifndef PACMUX_LOG_LEVEL
+#ifdef NDEBUG
+#define PACMUX_LOG_LEVEL 1
+#else
+#define PACMUX_LOG_LEVEL 0
+#endif
+#endif
+
+// =========================
+// Log asincrono a livelli
+// =========================
+// write() formatta il messaggio (printf) in un record di un buffer circolare del thread chiamante:
+// un solo scrittore e un solo lettore, quindi nessun lock e nessuna allocazione dopo il primo
+// messaggio del thread. Un thread in background svuota i buffer ogni 10 ms su stdout (Debug, Info)
+// o stderr (Warning, Error) e fa un solo flush per passata: la console non blocca più il frame.
+// Con il buffer pieno il messaggio si perde e viene contato (mai attese nel ciclo di gioco).
+// L'ordine è garantito tra i messaggi dello stesso thread, non tra thread diversi.
+// Si usa con le macro PACMUX_LOG_*: sotto PACMUX_LOG_LEVEL non costano nulla, sopra costano una
+// lettura atomica se il livello è escluso a runtime (setLevel).
+// =========================
+class Logger {
+public:
+    enum Level : int { Debug, Info, Warning, Error, Off };
+
+    static constexpr int MESSAGE_SIZE = 248; // caratteri per messaggio (i più lunghi vengono troncati)
+    static constexpr unsigned CAPACITY = 512; // messaggi in attesa per thread
+
+    static constexpr bool compiledIn(Level level) { return level >= PACMUX_LOG_LEVEL; }
+    static bool isEnabled(Level level) { return level >= s_level.load(std::memory_order_relaxed); }
+    // Livello minimo a runtime (es. Warning in pacmux_bench, Off per tacere tutto)
+    static void setLevel(Level level) { s_level.store(level, std::memory_order_relaxed); }
+
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    static void write(Level level, const char* format, ...);
+    // Prepara il buffer del thread corrente (il primo messaggio di un thread lo alloca): da chiamare
+    // fuori dai percorsi caldi, es. GameSimulation lo fa nel costruttore
+    static void prepareThread();
+    // Scrive subito i messaggi in attesa (dal thread chiamante)
+    static void flush();
+    // Ferma il thread di scrittura dopo l'ultimo svuotamento; i messaggi successivi vanno
+    // direttamente in console. Registrata con atexit al primo messaggio
+    static void shutdown();
+    // Messaggi persi per buffer pieno dall'avvio
+    static unsigned long long getDroppedCount();
+
+private:
+    static std::atomic<int> s_level;
+};
+
+#define PACMUX_LOG(level, ...)                                                   \
+    do {                                                                         \
+        if constexpr (Logger::compiledIn(level)) {                               \
+            if (Logger::isEnabled(level)) Logger::write(level, __VA_ARGS__);     \
+        }                                                                        \
+    } while (0)
+
+#define PACMUX_LOG_DEBUG(...) PACMUX_LOG(Logger::Debug, __VA_ARGS__)
+#define PACMUX_LOG_INFO(...) PACMUX_LOG(Logger::Info, __VA_ARGS__)
+#define PACMUX_LOG_WARNING(...) PACMUX_LOG(Logger::Warning, __VA_ARGS__)
+#define PACMUX_LOG_ERROR(...) PACMUX_LOG(Logger::Error, __VA_ARGS__)
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+// =========================
+// Generatore PCG32 (XSH-RR, O'Neill)
+// =========================
+// Sostituisce std::mt19937 nella simulazione: lo stato è un solo uint64_t invece di ~5 KB,
+// quindi copiarlo in uno snapshot (GameState) costa quanto copiare un float.
+// Incremento fisso: il seme sceglie solo il punto di partenza della sequenza.
+// L'uscita è definita dall'algoritmo e non dalla libreria standard, come il modulo diretto usato
+// al posto delle distribuzioni: un replay registrato su una piattaforma si verifica identico sulle altre.
+// =========================
+class Pcg32 {
+public:
+    using result_type = std::uint32_t;
+
+    static constexpr result_type min() { return 0u; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    Pcg32() { seed(0u); }
+    explicit Pcg32(std::uint64_t s) { seed(s); }
+
+    void seed(std::uint64_t s) {
+        m_state = 0u;
+        (*this)();
+        m_state += s;
+        (*this)();
+    }
+
+    result_type operator()() {
+        const std::uint64_t old = m_state;
+        m_state = old * MULTIPLIER + INCREMENT;
+        const std::uint32_t xorshifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+        const std::uint32_t rot = static_cast<std::uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+private:
+    static constexpr std::uint64_t MULTIPLIER = 6364136223846793005ULL;
+    static constexpr std::uint64_t INCREMENT = 1442695040888963407ULL;
+
+    std::uint64_t m_state;
+};
+
+static_assert(std::is_trivially_copyable_v<Pcg32> && sizeof(Pcg32) == 8, "Pcg32 deve restare un solo uint64_t");
@@ -1,14 +0,0 @@
-#pragma once
-#include <SFML/Graphics.hpp>
-
-class Pellet : public sf::Drawable, public sf::Transformable {
-public:
-    Pellet(const sf::Vector2f& pos, float radius = 3.5f);
-    bool eaten(const sf::Vector2f& playerPos) const;
-    // Posizione centro del pellet (utile per spawn frutti)
-    sf::Vector2f getPosition() const { return m_shape.getPosition(); }
-
-private:
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
-    sf::CircleShape m_shape;
-};
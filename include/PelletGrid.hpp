@@ -0,0 +1,103 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <bit>
+#include "SpriteBatch.hpp"
+
+// Pellet indicizzati per cella della mappa.
+// Un bit per cella dice se c'è un pellet, in un array di dimensione fissa (MAX_CELLS celle) con il
+// conteggio accanto: mangiata e conteggio in O(1), la scelta casuale conta i bit parola per parola.
+// Il disegno scorre solo i bit accesi. Lo stato (State) si salva e ripristina con una copia.
+class PelletGrid : public sf::Drawable {
+public:
+    // Celle massime della mappa (es. 64x64): bastano 64 parole per griglia
+    static constexpr std::size_t MAX_CELLS = 4096;
+    static constexpr std::size_t WORDS = MAX_CELLS / 64;
+
+    // Contenuto della griglia per GameState (bit e conteggio, senza dimensioni né colore)
+    struct State {
+        std::array<std::uint64_t, WORDS> bits;
+        std::uint32_t count;
+    };
+
+    PelletGrid(float radius = 3.5f, sf::Color color = sf::Color(255, 209, 128)); // Peach
+
+    // Svuota la griglia e la dimensiona sulla mappa; false se la mappa supera MAX_CELLS
+    bool reset(const sf::Vector2u& mapSize, const sf::Vector2u& tileSize);
+    void add(unsigned x, unsigned y);
+    bool has(unsigned x, unsigned y) const {
+        if (x >= m_mapSize.x || y >= m_mapSize.y) return false;
+        std::size_t i = static_cast<std::size_t>(y) * m_mapSize.x + x;
+        return (m_bits[i >> 6] >> (i & 63)) & 1u;
+    }
+    // Rimuove il pellet della cella; false se non c'era
+    bool eatAt(unsigned x, unsigned y);
+
+    std::size_t count() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    float getRadius() const { return m_radius; }
+
+    // Centro della cella in pixel
+    sf::Vector2f tileCenter(unsigned x, unsigned y) const {
+        return {x * float(m_tileSize.x) + m_tileSize.x / 2.f, y * float(m_tileSize.y) + m_tileSize.y / 2.f};
+    }
+
+    // Cella di un pellet scelto a caso (uniforme): il k-esimo bit acceso in ordine di riga, quindi la
+    // scelta dipende solo da quali pellet restano e non dall'ordine in cui sono stati mangiati.
+    // False se non ce ne sono.
+    // Modulo diretto sull'uscita del generatore invece di std::uniform_int_distribution, che cambia
+    // tra librerie standard: un replay registrato con MSVC si verifica identico con GCC/Clang
+    template <typename Rng>
+    bool randomTile(Rng& rng, unsigned& x, unsigned& y) const {
+        if (m_count == 0) return false;
+        std::uint32_t k = static_cast<std::uint32_t>(rng() % m_count);
+        for (std::size_t word = 0; word < m_words; ++word) {
+            std::uint64_t bits = m_bits[word];
+            const std::uint32_t n = static_cast<std::uint32_t>(std::popcount(bits));
+            if (k >= n) {
+                k -= n;
+                continue;
+            }
+            for (; k > 0; --k) bits &= bits - 1; // spegne i k bit più bassi
+            std::size_t i = (word << 6) + static_cast<std::size_t>(std::countr_zero(bits));
+            x = static_cast<unsigned>(i % m_mapSize.x);
+            y = static_cast<unsigned>(i / m_mapSize.x);
+            return true;
+        }
+        return false;
+    }
+
+    // Salvataggio e ripristino per GameState: la griglia deve avere già le dimensioni della mappa (reset)
+    void saveState(State& state) const { state.bits = m_bits; state.count = m_count; }
+    void restoreState(const State& state) { m_bits = state.bits; m_count = state.count; }
+
+    // Aggiunge un cerchio per pellet al batch degli attori; color sostituisce il colore della griglia
+    void appendTo(SpriteBatch& batch, const sf::Transform& transform = sf::Transform::Identity) const {
+        appendTo(batch, m_color, transform);
+    }
+    void appendTo(SpriteBatch& batch, sf::Color color, const sf::Transform& transform = sf::Transform::Identity) const;
+
+    // Chiama f(x, y) per ogni cella con pellet, riga per riga
+    template <typename F>
+    void forEach(F&& f) const {
+        for (std::size_t word = 0; word < m_words; ++word) {
+            for (std::uint64_t bits = m_bits[word]; bits != 0; bits &= bits - 1) {
+                std::size_t i = (word << 6) + static_cast<std::size_t>(std::countr_zero(bits));
+                f(static_cast<unsigned>(i % m_mapSize.x), static_cast<unsigned>(i / m_mapSize.x));
+            }
+        }
+    }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    float m_radius;
+    sf::Color m_color;
+    sf::Vector2u m_mapSize{0, 0};
+    sf::Vector2u m_tileSize{32, 32};
+    std::array<std::uint64_t, WORDS> m_bits{}; // 1 bit per cella (indice y * larghezza + x)
+    std::size_t m_words = 0;                  // parole usate dalla mappa corrente
+    std::uint32_t m_count = 0;                // bit accesi
+};
@@ -4,7 +4,7 @@
 
 class Pinky : public Ghost {
 public:
-    Pinky(const sf::Vector2f& pos);
+    Pinky(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos);
     
     void update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
                 const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode, bool gameStarted = true, bool released = true);
@@ -16,10 +16,9 @@ protected:
 
 private:
     // --- Sprite e animazione Pinky ---
-    std::unique_ptr<sf::Texture> m_texture;
     std::unique_ptr<sf::Sprite> m_sprite;
     bool m_hasTexture = false;
     float m_animTime = 0.f;
     int m_animFrame = 0;
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    const sf::Sprite* currentSprite() const override;
 };
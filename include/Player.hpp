@@ -2,38 +2,63 @@
 #include <SFML/Graphics.hpp>
 #include <memory>
 #include "TileMap.hpp"
+#include "SpriteBatch.hpp"
+#include "ActorPositions.hpp"
 
 class Player : public sf::Drawable, public sf::Transformable {
 public:
-    Player(float speed, const sf::Vector2f& startPos, const sf::Vector2u& tileSize);
+    // Stato di gameplay e animazione di Pac-Man per GameState (la posizione sta in ActorPositions)
+    struct State {
+        sf::Vector2f direction;
+        sf::Vector2f nextDirection;
+        sf::Vector2f prevPosition;
+        float speed;
+        int lives;
+        float animTime;
+        int animFrame;
+        bool isDying;
+        float deathAnimTime;
+        int deathFrame;
+        bool deathAnimFinished;
+    };
 
-    // ora prende solo map per collisioni
-    void update(float dt, const TileMap& map, const sf::Vector2u& tileSize);
+    // La posizione logica vive nello slot ActorPositions::PLAYER di positions (posseduto dalla simulazione)
+    Player(ActorPositions& positions, float speed, const sf::Vector2f& startPos, const sf::Vector2u& tileSize);
 
-    sf::Vector2f getPosition() const { return m_shape.getPosition(); }
+    // requestedDir: direzione desiderata in questo frame ((0,0) se nessun input).
+    // L'input non viene più letto qui dalla tastiera: lo campiona il chiamante (main o simulazione headless)
+    void update(float dt, const TileMap& map, const sf::Vector2u& tileSize, const sf::Vector2f& requestedDir = {0.f, 0.f});
+
+    sf::Vector2f getPosition() const { return m_positions->get(ActorPositions::PLAYER); }
     sf::Vector2f getDirection() const { return m_direction; }
     void setDirection(const sf::Vector2f& dir);
 
     // Imposta la posizione di Pac-Man
     void setPosition(const sf::Vector2f& position) { 
-        m_shape.setPosition(position); 
-        m_logicalPosition = position;
-        if (m_hasTexture && m_sprite) {
-            m_sprite->setPosition(position);
-        }
+        m_positions->set(ActorPositions::PLAYER, position);
+        m_prevPosition = position; // nessuna interpolazione dopo uno spostamento forzato
     }
 
-    // Restituisce la posizione logica di Pac-Man
-    sf::Vector2f getLogicalPosition() const { return m_logicalPosition; }
+    // Interpolazione del disegno tra due tick fissi della simulazione:
+    // beginTick salva la posizione prima del tick, alpha (0..1) sceglie il punto tra precedente e attuale
+    void beginTick() { m_prevPosition = getPosition(); }
+    void setRenderAlpha(float alpha) { m_renderAlpha = alpha; }
+
+    // Aggiunge lo sprite corrente (o il cerchio di fallback) al batch degli attori
+    void appendTo(SpriteBatch& batch, const sf::Transform& transform = sf::Transform::Identity) const;
 
-    // Aggiorna la posizione logica di Pac-Man
-    void setLogicalPosition(const sf::Vector2f& position) { m_logicalPosition = position; }
+    // Restituisce la posizione logica di Pac-Man (la stessa di getPosition)
+    sf::Vector2f getLogicalPosition() const { return getPosition(); }
 
     // Gestione vite
     int getLives() const { return m_lives; }
     void setLives(int lives) { m_lives = lives; }
     void loseLife() { if (m_lives > 0) m_lives--; }
     
+    State getState() const;
+    // Ripristina lo stato e il frame dello sprite che ne deriva
+    void setState(const State& state);
+
     // Ferma il movimento di Pac-Man (per situazioni speciali come vita extra)
     void stopMovement() { 
         m_direction = {0.f, 0.f}; 
@@ -42,19 +67,23 @@ public:
 
 private:
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    // Posizione di disegno interpolata (nessuna interpolazione attraverso i tunnel)
+    sf::Vector2f renderPosition() const;
 
-    sf::CircleShape   m_shape;
+    ActorPositions*   m_positions;       // posizione logica: slot ActorPositions::PLAYER
+    float             m_radius;          // cerchio di fallback senza texture, costruito solo quando si disegna
     float             m_speed;
     sf::Vector2f      m_direction;      // direzione corrente (-1,0),(1,0),(0,-1),(0,1)
     sf::Vector2f      m_nextDirection;  // direzione desiderata dal giocatore
     sf::Vector2u      m_tileSize;
-    sf::Vector2f      m_logicalPosition; // Posizione logica di Pac-Man
     int               m_lives;           // Numero di vite del giocatore
+    sf::Vector2f      m_prevPosition;    // Posizione all'inizio dell'ultimo tick
+    float             m_renderAlpha = 1.f;
     
     // Texture e sprite per Pac-Man
-    std::unique_ptr<sf::Texture> m_texture;
-    std::unique_ptr<sf::Sprite>  m_sprite;
-    bool                         m_hasTexture;
+    std::shared_ptr<const sf::Texture> m_texture; // atlas condiviso (SpriteSheet)
+    std::unique_ptr<sf::Sprite>        m_sprite;
+    bool                               m_hasTexture;
     // --- Animazione Pac-Man ---
     float m_animTime = 0.f;
     int m_animFrame = 0;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "GameSimulation.hpp"
+
+// =========================
+// Replay di una partita
+// =========================
+// Formato binario compatto e in streaming, scritto mentre si gioca:
+//   intestazione  "PMXR", versione, tick al secondo, seme, nomi dei file mappa
+//   record        input a tratti (direzione + numero di tick consecutivi, varint),
+//                 snap di Pac-Man (entrata in pausa), checkpoint ai cambi di livello/vita,
+//                 fine partita con il riepilogo
+// Più replay possono stare uno dopo l'altro nello stesso stream (verifica in blocco).
+// La riproduzione risimula a passo fisso GameSimulation::TICK, headless e senza limiti di velocità,
+// e confronta ogni checkpoint: la prima divergenza ferma il replay con un errore.
+// =========================
+
+struct ReplayHeader {
+    std::uint32_t seed = 0;
+    std::uint16_t ticksPerSecond = 0;
+    std::vector<std::string> mapFiles; // solo i nomi dei file, la cartella la sceglie chi riproduce
+};
+
+class ReplayWriter {
+public:
+    explicit ReplayWriter(std::ostream& out) : m_out(out) {}
+
+    // Intestazione della partita appena iniziata (chiamare dopo GameSimulation::newGame)
+    void begin(const GameSimulation& sim);
+    // Chiamati da GameSimulation tramite setRecorder
+    void recordTick(const SimInput& input, const GameSimulation& sim);
+    void recordSnap();
+    // Riepilogo finale; il replay è completo solo dopo finish
+    void finish(const GameSimulation& sim);
+
+    bool isRecording() const { return m_recording; }
+
+private:
+    void flushRun();
+    void writeState(const GameSimulation& sim);
+
+    std::ostream& m_out;
+    bool m_recording = false;
+    std::uint8_t m_runInput = 0;   // codice direzione del tratto in corso
+    std::uint32_t m_runLength = 0; // tick del tratto non ancora scritti
+};
+
+struct ReplayResult {
+    bool ok = false;
+    std::string error;          // motivo del fallimento (divergenza, file troncato, mappa mancante)
+    std::uint32_t seed = 0;
+    std::uint64_t ticks = 0;
+    unsigned score = 0;
+    int level = 0;
+    int lives = 0;
+    double wallSeconds = 0.0;   // tempo reale impiegato dalla risimulazione
+    std::uint64_t ghostAllocations = 0; // allocazioni negli update dei fantasmi (solo build di debug)
+};
+
+// Legge il prossimo replay dallo stream e lo risimula; mapDir è la cartella delle mappe.
+// Ritorna false se lo stream è finito prima di un nuovo replay
+bool playReplay(std::istream& in, const std::string& mapDir, ReplayResult& result);
@@ -16,6 +16,9 @@ public:
     // Ottiene il punteggio corrente
     unsigned getScore() const { return m_score; }
 
+    // Imposta il punteggio (sincronizzato con la simulazione)
+    void setScore(unsigned value) { if (value != m_score) { m_score = value; updateText(); } }
+
     // Resetta il punteggio
     void resetScore() { m_score = 0; m_extraLifeThreshold = 10000; m_extraLifeGiven = false; updateText(); }
 
@@ -27,7 +30,7 @@ public:
 
 private:
     unsigned                     m_score;                 // punteggio attuale
-    sf::Font                     m_font;                  // font usato per il testo
+    const sf::Font&              m_font;                  // font usato per il testo (condiviso, TextCache)
     std::unique_ptr<sf::Text>    m_text;                  // sf::Text costruito dinamicamente
     unsigned                     m_extraLifeThreshold;    // soglia per vita extra (10000)
     bool                         m_extraLifeGiven;        // flag per tracciare se la vita extra è già stata assegnata
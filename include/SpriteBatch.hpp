@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Raccoglie i quad degli attori di un frame (pellet, frutti, fantasmi, Pac-Man) e li disegna
+// con un vertex array di triangoli per texture: le draw call sono una per texture usata
+// (l'atlas pacman.png) più una per le forme senza texture, qualunque sia il numero di entità.
+// I livelli si disegnano nell'ordine in cui compaiono la prima volta nel frame.
+// clear() svuota i vertici ma tiene la memoria, così a regime il frame non alloca.
+class SpriteBatch : public sf::Drawable {
+public:
+    // Punti usati per approssimare i cerchi (pellet e forme di fallback)
+    static constexpr unsigned CIRCLE_POINTS = 16;
+
+    // Da chiamare a inizio frame
+    void clear();
+
+    // Quad dello sprite (texture rect, trasformazione e colore correnti), composto con transform
+    void add(const sf::Sprite& sprite, const sf::Transform& transform = sf::Transform::Identity);
+    // Cerchio pieno senza texture centrato in center
+    void addCircle(const sf::Vector2f& center, float radius, sf::Color color,
+                   const sf::Transform& transform = sf::Transform::Identity);
+
+    // Draw call emesse da una draw() (livelli non vuoti)
+    std::size_t getDrawCallCount() const;
+    // Triangoli accumulati nel frame
+    std::size_t getTriangleCount() const;
+
+private:
+    struct Layer {
+        const sf::Texture* texture = nullptr; // nullptr = forme senza texture
+        sf::VertexArray vertices{sf::PrimitiveType::Triangles};
+    };
+
+    Layer& layerFor(const sf::Texture* texture);
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    // Pochi livelli (di solito due): ricerca lineare, nessuna mappa
+    std::vector<Layer> m_layers;
+    std::vector<std::size_t> m_order; // indici in m_layers nell'ordine del frame
+    std::vector<sf::Vector2f> m_unitCircle; // CIRCLE_POINTS punti sul cerchio unitario, calcolati una volta
+};
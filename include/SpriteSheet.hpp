@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+
+// Atlas delle texture condiviso da tutto il processo (assets/pacman.png).
+// Ogni file viene decodificato una sola volta e tenuto in cache: Pac-Man, fantasmi e frutti
+// ne condividono la stessa sf::Texture (shared_ptr) e ne ritagliano i frame con i rettangoli
+// BLINKY_FRAMES, FRIGHTENED_FRAMES, PACMAN_FRAMES, ... Ricreare le entità a ogni livello non rilegge il PNG.
+// In modalità headless (simulazione senza finestra) il caricamento è disabilitato:
+// le entità restano senza texture e usano le forme di fallback, senza toccare il disco né la GPU.
+// acquire e preload si possono chiamare da più thread (simulazioni costruite sui worker del pool).
+class SpriteSheet {
+public:
+    static constexpr const char* PATH = "assets/pacman.png";
+
+    // Abilita/disabilita il caricamento delle texture (false = headless).
+    // Atomico: più simulazioni headless su thread diversi lo impostano insieme (pacmux_bench)
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed) && !t_headless; }
+
+    // Disabilita il caricamento solo sul thread corrente finché l'oggetto vive: simulazioni headless
+    // accanto al gioco (Autopilot) senza togliere le texture a quella disegnata
+    class HeadlessScope {
+    public:
+        HeadlessScope() : m_previous(t_headless) { t_headless = true; }
+        ~HeadlessScope() { t_headless = m_previous; }
+        HeadlessScope(const HeadlessScope&) = delete;
+        HeadlessScope& operator=(const HeadlessScope&) = delete;
+    private:
+        bool m_previous;
+    };
+
+    // Texture condivisa; nullptr se disabilitata o se il file non si carica (il fallimento viene ricordato)
+    static std::shared_ptr<const sf::Texture> acquire(const std::string& path = PATH);
+
+    // Carica in cache un'immagine già decodificata (anche su un altro thread, es. AssetLoader):
+    // qui resta solo l'upload sulla GPU, dal thread della finestra. Le acquire successive la riusano.
+    // false se l'upload fallisce (ricordato come un file che non si carica)
+    static bool preload(const sf::Image& image, const std::string& path = PATH);
+
+    // Quante decodifiche di immagini sono state fatte dall'avvio (atteso: una per file)
+    static unsigned getDecodeCount() { return s_decodeCount.load(std::memory_order_relaxed); }
+
+private:
+    static std::atomic<bool> s_enabled;
+    static thread_local bool t_headless;
+    static std::atomic<unsigned> s_decodeCount;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include "TileMap.hpp"
+#include "PelletGrid.hpp"
+#include "SpriteBatch.hpp"
+
+// =========================
+// Sfondo statico di un livello: labirinto e pellet in una RenderTexture
+// =========================
+// Dentro un livello i muri non cambiano e i pellet possono solo sparire: il layer si disegna
+// una volta (mappa + pellet) e poi a ogni frame costa un solo quad con la sua texture.
+// update() confronta i bit della PelletGrid con quelli disegnati: i pellet spariti vengono
+// cancellati sul posto (un quadrato del colore di sfondo per pellet, tutti in una draw call),
+// mentre un pellet comparso, un livello diverso o una mappa di altre dimensioni ridisegnano tutto.
+// I Super Pellet restano fuori (lampeggiano ogni frame) e si disegnano con gli attori.
+// =========================
+class StaticLayer : public sf::Drawable {
+public:
+    explicit StaticLayer(sf::Color background = sf::Color::Black) : m_background(background) {}
+
+    // Da chiamare prima di draw a ogni frame; false se la RenderTexture non si crea
+    bool update(const TileMap& map, const PelletGrid& pellets, const sf::Vector2u& tileSize, int level);
+
+    // Ridisegni completi e pellet cancellati dall'avvio (per il log del rendering)
+    std::uint64_t getRebuildCount() const { return m_rebuilds; }
+    std::uint64_t getErasedCount() const { return m_erased; }
+
+private:
+    bool rebuild(const TileMap& map, const PelletGrid& pellets, const sf::Vector2u& tileSize);
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    sf::Color m_background;
+    sf::RenderTexture m_texture;
+    bool m_valid = false;
+    int m_level = -1;
+    sf::Vector2u m_mapSize{0, 0};
+    PelletGrid::State m_pellets{};  // pellet presenti nella texture
+    SpriteBatch m_batch;            // pellet del ridisegno completo
+    sf::VertexArray m_erase{sf::PrimitiveType::Triangles}; // quadrati dei pellet spariti nel frame
+    std::uint64_t m_rebuilds = 0;
+    std::uint64_t m_erased = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Cache condivisa di font e testi per menu, HUD e schermate.
+// Ogni font viene letto da disco una sola volta; i testi sono indicizzati per
+// (font, stringa, dimensione, stile) e vengono costruiti solo al primo uso:
+// un testo che cambia (es. "Vite: 2") è semplicemente una nuova chiave.
+// Il testo restituito è condiviso: chi lo usa reimposta ad ogni frame colori,
+// contorno e posizione che gli servono.
+class TextCache {
+public:
+    struct Stats {
+        unsigned fontLoads = 0;   // font letti da disco
+        unsigned textHits = 0;    // testi già pronti
+        unsigned textMisses = 0;  // testi costruiti (layout glifi)
+    };
+
+    static TextCache& instance();
+
+    // Font caricato una sola volta per percorso; lancia sf::Exception se il file non si apre
+    const sf::Font& font(const std::string& fontPath);
+
+    sf::Text& text(const std::string& fontPath, const std::string& str, unsigned size,
+                   std::uint32_t style = sf::Text::Regular);
+
+    // Statistiche dall'ultimo reset (per il log periodico in main)
+    const Stats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = Stats{}; }
+    std::size_t getTextCount() const { return m_texts.size(); }
+
+private:
+    // Oltre questa soglia si eliminano i testi non usati nelle ultime MAX_TEXTS richieste
+    static constexpr std::size_t MAX_TEXTS = 256;
+
+    struct Key {
+        const sf::Font* font;
+        std::string str;
+        unsigned size;
+        std::uint32_t style;
+        bool operator==(const Key& other) const {
+            return font == other.font && size == other.size && style == other.style && str == other.str;
+        }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+    struct Entry {
+        std::unique_ptr<sf::Text> text;
+        std::uint64_t lastUse = 0;
+    };
+
+    void evictUnused();
+
+    std::unordered_map<std::string, std::unique_ptr<sf::Font>> m_fonts;
+    std::unordered_map<Key, Entry, KeyHash> m_texts;
+    std::uint64_t m_useCounter = 0;
+    Stats m_stats;
+};
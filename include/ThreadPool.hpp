@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// =========================
+// Pool di thread con work stealing
+// =========================
+// Ogni worker ha la sua coda: prende i compiti dal fondo della propria (i più recenti, ancora in cache)
+// e, quando resta senza, li ruba dalla testa di quella di un altro. I compiti inviati da fuori
+// vengono distribuiti a turno tra le code; quelli inviati da un worker finiscono nella sua coda.
+// Così compiti di durata molto diversa (partite corte e lunghe) si bilanciano da soli.
+// I compiti non devono lanciare eccezioni.
+// =========================
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads = 0 -> un worker per core
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+    // Attende che tutti i compiti inviati (anche quelli inviati dai compiti) siano finiti
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()); }
+    // Indice del worker che esegue il compito corrente (0..size()-1), -1 fuori dal pool
+    static int currentWorker();
+    // Compiti presi dalla coda di un altro worker dall'avvio
+    std::uint64_t getStealCount() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void run(unsigned index);
+    bool popLocal(unsigned index, Task& task);
+    bool steal(unsigned thief, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;   // compiti nuovi o chiusura
+    std::condition_variable m_idle;   // nessun compito in sospeso
+    std::atomic<std::size_t> m_queued{0};  // in coda, non ancora presi
+    std::atomic<std::size_t> m_pending{0}; // in coda o in esecuzione
+    std::atomic<unsigned> m_nextQueue{0};
+    std::atomic<std::uint64_t> m_steals{0};
+    bool m_stop = false;
+};
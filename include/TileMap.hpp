@@ -4,53 +4,151 @@
 #include <string>
 #include <fstream>
 #include <algorithm> // Per std::count
+#include <cstdint>
 
 class TileMap : public sf::Drawable, public sf::Transformable {
 public:
+    // Batched: solo i quad dei muri in un unico vertex array/buffer, una draw call.
+    // PerTile: una RectangleShape per cella (vecchio percorso, tenuto per confrontare i tempi frame).
+    enum class RenderMode { Batched, PerTile };
+
     bool load(const std::string& filename, const sf::Vector2u& tileSize);
+
+    // Modalità di disegno condivisa da tutte le mappe (toggle F3 nel gioco)
+    static void setRenderMode(RenderMode mode) { s_renderMode = mode; }
+    static RenderMode getRenderMode() { return s_renderMode; }
+    // Draw call emesse da una draw() nella modalità corrente
+    std::size_t getDrawCallCount() const {
+        return s_renderMode == RenderMode::Batched ? 1 : static_cast<std::size_t>(m_size.x) * m_size.y;
+    }
+    // --- Celle (precalcolate in load) ---
+    // Un byte di flag per cella, riga per riga in un unico array: muri, ghost house, tunnel e pellet
+    // si leggono con un solo accesso. Caratteri della mappa: '1' muro, '0' pellet, 'S' Super Pellet,
+    // 'P' spawn di Pac-Man, 'G' ghost house, 'D' porta della ghost house, '2' (o altro) cella vuota.
+    // Una mappa senza 'G'/'D' usa la ghost house classica (riga 10, colonne 9-11, porta in 10,9).
+    enum CellFlag : std::uint8_t {
+        CELL_WALL         = 1 << 0,
+        CELL_GHOST_HOUSE  = 1 << 1,
+        CELL_DOOR         = 1 << 2,
+        CELL_TUNNEL       = 1 << 3, // estremo di un tunnel laterale: collegato all'estremo opposto della riga
+        CELL_PELLET       = 1 << 4,
+        CELL_SUPER_PELLET = 1 << 5,
+        CELL_PACMAN_SPAWN = 1 << 6
+    };
+    std::uint8_t cellFlags(unsigned x, unsigned y) const { return m_cells[y * m_size.x + x]; }
+
     bool isWall(unsigned x, unsigned y) const {
-        return m_data[y][x] == '1';
+        return (cellFlags(x, y) & CELL_WALL) != 0;
     }
     
-    // Controlla se una posizione è nella ghost house (per impedire il rientro ai fantasmi)
+    // Controlla se una posizione è nella ghost house o sulla sua porta (per impedire il rientro ai fantasmi).
+    // Coordinate fuori mappa (anche negative, come unsigned enormi): false
     bool isGhostHouse(unsigned x, unsigned y) const {
-        // Definisce l'area della ghost house: 
-        // - Riga 11 dove spawnano Inky, Pinky e Clyde
-        // - Tile sotto Blinky (porta della ghost house)
-        return (y == 10 && x >= 9 && x <= 11) || (y == 9 && x == 10);
+        return x < m_size.x && y < m_size.y && (cellFlags(x, y) & (CELL_GHOST_HOUSE | CELL_DOOR)) != 0;
     }
+    // Cella centrale della ghost house (dove tornano i fantasmi mangiati) e porta di uscita
+    sf::Vector2u getGhostHouseCenter() const { return m_houseCenter; }
+    sf::Vector2u getGhostHouseDoor() const { return m_houseDoor; }
     
     sf::Vector2u getSize() const { return m_size; }
 
-    // ← Getter per leggere la griglia di caratteri (per trovare 'P')
+    // ← Getter per leggere la griglia di caratteri così come è nel file
     const std::vector<std::string>& getData() const { return m_data; }
 
     // Ritorna true se la cella contiene un Super Pellet ('S')
     bool isSuperPellet(unsigned x, unsigned y) const {
-        return m_data[y][x] == 'S';
+        return (cellFlags(x, y) & CELL_SUPER_PELLET) != 0;
     }
 
     // Raccoglie (rimuove) un Super Pellet dalla cella, se presente
     void collectSuperPellet(unsigned x, unsigned y) {
-        if (m_data[y][x] == 'S') {
-            m_data[y][x] = '0';
-        }
+        m_cells[y * m_size.x + x] &= static_cast<std::uint8_t>(~CELL_SUPER_PELLET);
     }
 
     // Conta i Super Pellet rimasti sulla mappa
     int countSuperPellets() const {
-        int count = 0;
-        for (const auto& row : m_data) {
-            count += std::count(row.begin(), row.end(), 'S');
-        }
-        return count;
+        return static_cast<int>(std::count_if(m_cells.begin(), m_cells.end(),
+                                              [](std::uint8_t c) { return (c & CELL_SUPER_PELLET) != 0; }));
     }
 
+    // --- Grafo dei nodi (precalcolato in load) ---
+    // Le celle raggiungibili dallo spawn di Pac-Man, tunnel inclusi, con i 4 vicini di ciascuna:
+    // i campi di flusso dei fantasmi (FlowField) sono BFS su questo grafo, in O(nodi) per target.
+    // Direzioni nell'ordine di preferenza dei fantasmi: su, sinistra, giù, destra.
+    static constexpr int DIR_DX[4] = { 0, -1, 0, 1 };
+    static constexpr int DIR_DY[4] = { -1, 0, 1, 0 };
+    static constexpr std::uint8_t NO_DIRECTION = 0xFF;
+    static constexpr std::uint16_t UNREACHABLE = 0xFFFF;
+
+    // True se la riga y è un tunnel laterale ('2' ai due bordi, '1' sopra e sotto)
+    bool isTunnelRow(int y) const {
+        return y >= 0 && y < static_cast<int>(m_size.y) && m_size.x > 0 && (cellFlags(0, y) & CELL_TUNNEL) != 0;
+    }
+    // Cella adiacente in direzione dir (indice in DIR_DX/DIR_DY), attraversando i tunnel; false se fuori mappa
+    bool neighbor(int x, int y, int dir, int& nx, int& ny) const;
+    // Nodo del grafo per la cella (x, y); muri, celle isolate o fuori mappa -> nodo raggiungibile più vicino
+    int nodeAt(int x, int y) const;
+    std::size_t getNodeCount() const { return m_nodeTile.size(); }
+    // Nodo vicino in direzione dir, -1 se c'è un muro (tunnel compresi)
+    int adjacentNode(int node, int dir) const {
+        return m_adjacency[static_cast<std::size_t>(node) * 4 + dir];
+    }
+
+    // --- Grafo degli incroci dei fantasmi (precalcolato in load) ---
+    // Celle percorribili fuori dalla ghost house. Incrocio = cella che non è un corridoio dritto
+    // (bivi, curve, vicoli ciechi); corridoio = tratto dritto orientato tra due incroci, tunnel compresi.
+    // I fantasmi usciti dalla ghost house avanzano lungo un corridoio e decidono solo agli incroci.
+    struct Junction {
+        std::uint16_t tile;     // indice di cella y * larghezza + x
+        std::int16_t exits[4];  // corridoio in uscita per direzione (DIR_DX/DIR_DY), -1 se muro o ghost house
+    };
+    struct Corridor {
+        std::uint16_t from, to; // incroci di partenza e di arrivo
+        std::uint16_t length;   // in celle
+        std::int16_t reverse;   // stesso corridoio percorso al contrario
+        std::uint8_t dir;       // direzione di marcia
+        bool tunnel;            // attraversa il bordo della mappa
+    };
+    const std::vector<Junction>& getJunctions() const { return m_junctions; }
+    const std::vector<Corridor>& getCorridors() const { return m_corridors; }
+    // Incrocio della cella, -1 se la cella non è un incrocio
+    int junctionAt(int x, int y) const;
+    // Corridoio che passa per la cella (non incrocio) e distanza in celle dal suo incrocio di partenza
+    bool corridorAt(int x, int y, int& corridor, int& offset) const;
+
 private:
+    void buildCells();
+    void buildNodeGraph();
+    void buildJunctionGraph();
+    void buildTiles() const;
+    sf::Color wallColor() const;
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
     std::vector<std::string>          m_data;
-    std::vector<sf::RectangleShape>   m_tiles;
+    std::vector<std::uint8_t>         m_cells; // flag CellFlag, y * larghezza + x
+    sf::Vector2u                      m_houseCenter;
+    sf::Vector2u                      m_houseDoor;
     sf::Vector2u                      m_size;
+    sf::Vector2u                      m_tileSize;
     std::string                       m_filename; // Store the filename for wall color logic
+
+    // Geometria dei muri (2 triangoli per muro) preparata in load; il buffer GPU si carica
+    // alla prima draw, così la mappa si può caricare anche senza contesto OpenGL (headless)
+    static RenderMode                 s_renderMode;
+    sf::VertexArray                   m_wallVertices{sf::PrimitiveType::Triangles};
+    mutable sf::VertexBuffer          m_wallBuffer{sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static};
+    mutable bool                      m_wallBufferDirty = true;
+    mutable std::vector<sf::RectangleShape> m_tiles; // solo per RenderMode::PerTile, creato su richiesta
+
+    // Grafo: N nodi, 4 vicini per nodo
+    std::vector<std::int16_t>         m_tileNode;  // per ogni cella: nodo (o nodo più vicino), -1 se nessuno
+    std::vector<std::uint16_t>        m_nodeTile;  // per ogni nodo: indice di cella y * larghezza + x
+    std::vector<std::int16_t>         m_adjacency; // per ogni nodo e direzione: nodo vicino, -1 se muro
+    // Grafo degli incroci: per ogni cella incrocio (o -1), corridoio (o -1) e distanza dall'inizio del corridoio
+    std::vector<Junction>             m_junctions;
+    std::vector<Corridor>             m_corridors;
+    std::vector<std::int16_t>         m_tileJunction;
+    std::vector<std::int16_t>         m_tileCorridor;
+    std::vector<std::uint16_t>        m_tileOffset;
+    std::vector<std::string>          m_graphSource; // griglia da cui sono stati calcolati i grafi
 };
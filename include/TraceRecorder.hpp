@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// =========================
+// Registrazione di una traccia Chrome Trace Event (chrome://tracing, ui.perfetto.dev)
+// =========================
+// Con il gioco avviato con --trace out.json: fasi di ogni frame (quelle del FrameProfiler),
+// caricamenti di livello e upload/download della classifica globale diventano eventi B/E,
+// ognuno sul suo thread. record() accoda l'evento sotto un lock brevissimo; un thread di
+// scrittura svuota la coda ogni 100 ms e scrive il JSON in streaming, così il ciclo di gioco
+// non aspetta mai il disco. stop() scrive gli ultimi eventi e chiude il file.
+// Nomi e categorie devono essere stringhe statiche (letterali): si salva solo il puntatore.
+// Spenta (il caso normale) ogni chiamata costa una lettura atomica.
+// =========================
+class TraceRecorder {
+public:
+    // Apre il file e avvia il thread di scrittura; false se il file non si apre
+    static bool start(const std::string& path);
+    // Scrive gli eventi rimasti, chiude il JSON e ferma il thread (anche se mai avviata)
+    static void stop();
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    static void begin(const char* name, const char* category) {
+        if (isEnabled()) record('B', name, category);
+    }
+    static void end(const char* name, const char* category) {
+        if (isEnabled()) record('E', name, category);
+    }
+    // Nome del thread corrente nella traccia (es. "main")
+    static void setThreadName(const char* name) {
+        if (isEnabled()) record('M', name, "");
+    }
+    // Eventi scritti su disco dall'ultimo start
+    static std::uint64_t getWrittenCount();
+
+    // Evento B alla costruzione, E alla distruzione
+    class Scope {
+    public:
+        Scope(const char* name, const char* category) : m_name(name), m_category(category) {
+            begin(m_name, m_category);
+        }
+        ~Scope() { end(m_name, m_category); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        const char* m_category;
+    };
+
+private:
+    static void record(char phase, const char* name, const char* category);
+    static void writerLoop();
+
+    static std::atomic<bool> s_enabled;
+};
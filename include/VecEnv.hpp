@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "GameSimulation.hpp"
+
+class ThreadPool;
+
+// =========================
+// Ambiente vettoriale per reinforcement learning
+// =========================
+// K partite headless avanzano insieme: step() riceve un'azione per partita, fa actionTicks tick di
+// simulazione in ognuna (in parallelo sul pool) e scrive osservazioni, ricompense e fine episodio
+// nei buffer del chiamante. Le regole sono quelle di GameSimulation (mappe, fantasmi con i loro target,
+// frightened, punteggio: 10 per pellet, 200/400/800/1600 per i fantasmi in combo), quindi la
+// ricompensa è semplicemente il punteggio fatto durante lo step.
+// Osservazione di una partita: PLANE_COUNT piani float di height x width celle (0 o 1), piano per
+// piano e riga per riga; le partite sono una dopo l'altra nello stesso buffer (obsSize() float
+// ciascuna). Mappe più piccole di width x height sono allineate in alto a sinistra e il resto è muro.
+// Uno step non alloca: allocano solo la simulazione quando ricarica la mappa (inizio di un episodio,
+// di un livello o di una vita) e quando compare un frutto.
+// Un episodio finisce con il game over, una mappa che non si carica o dopo maxEpisodeSteps step;
+// la partita ricomincia subito (seme nuovo) e l'osservazione restituita è già del nuovo episodio.
+// =========================
+class VecEnv {
+public:
+    // Azioni: direzioni nell'ordine di TileMap::DIR_DX/DIR_DY (su, sinistra, giù, destra) o nessuna
+    enum Action : std::int32_t { ACTION_UP, ACTION_LEFT, ACTION_DOWN, ACTION_RIGHT, ACTION_NONE };
+    static constexpr int ACTION_COUNT = 5;
+
+    enum Plane : int {
+        PLANE_WALL,
+        PLANE_PELLET,
+        PLANE_SUPER_PELLET,
+        PLANE_PACMAN,
+        PLANE_BLINKY,       // un piano per fantasma (Ghost::Type), fantasmi mangiati esclusi
+        PLANE_PINKY,
+        PLANE_INKY,
+        PLANE_CLYDE,
+        PLANE_FRIGHTENED,   // fantasmi in frightened (mangiabili)
+        PLANE_FRUIT,
+        PLANE_COUNT
+    };
+
+    struct Config {
+        unsigned envs = 64;
+        unsigned threads = 0;               // 0 = un worker per core, 1 = tutto sul thread chiamante
+        unsigned actionTicks = 8;           // tick di simulazione per step (15 decisioni al secondo)
+        std::uint32_t maxEpisodeSteps = 0;  // 0 = fino al game over
+        std::uint32_t seed = 1;             // episodio e della partita i: seme seed + i + e * envs
+    };
+
+    // Esito dell'ultimo episodio finito di una partita
+    struct Episode {
+        unsigned score = 0;
+        std::uint32_t steps = 0;
+        int level = 0;
+        int difficulty = 0;
+    };
+
+    // simConfig: mappe della partita (le simulazioni sono sempre headless)
+    VecEnv(const GameSimulation::Config& simConfig, const Config& config);
+    ~VecEnv();
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    unsigned size() const { return m_config.envs; }
+    unsigned width() const { return m_width; }
+    unsigned height() const { return m_height; }
+    // Float per osservazione di una partita (PLANE_COUNT * height * width)
+    std::size_t obsSize() const { return std::size_t(PLANE_COUNT) * m_width * m_height; }
+
+    // Nuovo episodio in tutte le partite; obs: size() * obsSize() float
+    void reset(float* obs);
+    // actions: size() azioni; obs come in reset, rewards e dones: size() elementi (done = 1 se
+    // l'episodio è finito in questo step)
+    void step(const std::int32_t* actions, float* obs, float* rewards, std::uint8_t* dones);
+
+    const GameSimulation& getSim(unsigned env) const { return *m_envs[env].sim; }
+    const Episode& getLastEpisode(unsigned env) const { return m_envs[env].last; }
+    std::uint64_t getStepCount() const { return m_steps; }         // step di tutte le partite
+    std::uint64_t getEpisodeCount() const { return m_episodes; }   // episodi finiti
+    unsigned getWorkerCount() const;
+
+private:
+    struct Env {
+        std::unique_ptr<GameSimulation> sim;
+        std::uint32_t episode = 0;
+        std::uint32_t steps = 0;
+        unsigned lastScore = 0;
+        Episode last;
+    };
+
+    // Esegue reset o step (m_resetting) su tutte le partite, a blocchi sul pool, e aspetta la fine
+    void dispatch();
+    void runRange(unsigned first, unsigned last);
+    void resetEnv(unsigned index);
+    void stepEnv(unsigned index);
+    void writeObservation(unsigned index) const;
+
+    GameSimulation::Config m_simConfig;
+    Config m_config;
+    std::unique_ptr<ThreadPool> m_pool; // nullptr con threads = 1
+    std::vector<Env> m_envs;
+    unsigned m_width = 0;
+    unsigned m_height = 0;
+    unsigned m_chunk = 1;                         // partite per compito del pool
+    std::vector<std::vector<float>> m_wallPlanes; // piano dei muri per livello, già con il bordo
+
+    // Buffer dello step in corso (del chiamante)
+    const std::int32_t* m_actions = nullptr;
+    float* m_obs = nullptr;
+    float* m_rewards = nullptr;
+    std::uint8_t* m_dones = nullptr;
+    bool m_resetting = false;
+
+    std::uint64_t m_steps = 0;
+    std::uint64_t m_episodes = 0;
+};
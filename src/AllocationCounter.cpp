@@ -0,0 +1,38 @@
+#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifndef NDEBUG
+
+static thread_local std::uint64_t t_allocations = 0;
+
+static void* countedAlloc(std::size_t size) {
+    ++t_allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    ++t_allocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    ++t_allocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+bool AllocationCounter::isEnabled() { return true; }
+std::uint64_t AllocationCounter::count() { return t_allocations; }
+
+#else
+
+bool AllocationCounter::isEnabled() { return false; }
+std::uint64_t AllocationCounter::count() { return 0; }
+
+#endif
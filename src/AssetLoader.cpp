@@ -0,0 +1,64 @@
+#include "AssetLoader.hpp"
+#include "TraceRecorder.hpp"
+#include <chrono>
+#include <exception>
+
+using LoaderClock = std::chrono::steady_clock;
+
+AssetLoader::AssetLoader(unsigned threads) : m_pool(threads) {}
+
+AssetLoader::~AssetLoader() {
+    // I job possono riferirsi a oggetti del chiamante: nessuno deve restare in volo
+    if (m_started) m_pool.wait();
+}
+
+void AssetLoader::add(const char* name, Job job) {
+    m_jobs.push_back(std::move(job));
+    m_results.push_back(Result{name, 0.0, false});
+}
+
+void AssetLoader::start() {
+    if (m_started) return;
+    m_started = true;
+    const LoaderClock::time_point start = LoaderClock::now();
+    for (std::size_t i = 0; i < m_jobs.size(); ++i) {
+        m_pool.submit([this, i, start] {
+            Result& result = m_results[i];
+            TraceRecorder::Scope trace(result.name, "startup");
+            const LoaderClock::time_point begin = LoaderClock::now();
+            try {
+                result.ok = m_jobs[i]();
+            } catch (const std::exception&) {
+                result.ok = false;
+            }
+            const LoaderClock::time_point end = LoaderClock::now();
+            result.seconds = std::chrono::duration<double>(end - begin).count();
+
+            // Il job finito per ultimo segna la fine del caricamento
+            const double finishedAt = std::chrono::duration<double>(end - start).count();
+            double latest = m_finishedAt.load(std::memory_order_relaxed);
+            while (latest < finishedAt && !m_finishedAt.compare_exchange_weak(latest, finishedAt)) {
+            }
+            m_completed.fetch_add(1, std::memory_order_acq_rel);
+        });
+    }
+}
+
+float AssetLoader::getProgress() const {
+    if (m_jobs.empty()) return 1.f;
+    return float(m_completed.load(std::memory_order_acquire)) / float(m_jobs.size());
+}
+
+void AssetLoader::wait() {
+    if (!m_started) start();
+    if (m_waited) return;
+    m_pool.wait();
+    m_waited = true;
+    m_wallSeconds = m_finishedAt.load(std::memory_order_relaxed);
+}
+
+double AssetLoader::getWorkSeconds() const {
+    double sum = 0.0;
+    for (const Result& result : m_results) sum += result.seconds;
+    return sum;
+}
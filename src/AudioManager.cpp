@@ -0,0 +1,306 @@
+#include "AudioManager.hpp"
+#include "GameSimulation.hpp"
+#include "Logger.hpp"
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct SampleInfo {
+    const char* file;
+    float volume; // 0-100
+};
+
+// Nell'ordine di AudioManager::Sample
+constexpr std::array<SampleInfo, 8> SAMPLES = {{
+    {"PacmanChomp.mp3", 60.f},       // "wakawaka" mentre Pac-Man mangia (loop)
+    {"pacman_chomp.wav", 35.f},      // navigazione dei menu
+    {"pacman_eatghost.wav", 70.f},   // fantasma mangiato, conferme dei menu
+    {"pacman_death.wav", 75.f},
+    {"pacman_menupausa.wav", 55.f},  // pausa, ritorno al menu dal Game Over
+    {"GhostTurntoBlue.mp3", 65.f},   // Super Pellet
+    {"GhostReturntoHome.mp3", 20.f}, // occhi che tornano alla casa (loop)
+    {"GhostNormalMove.mp3", 15.f},   // sirena normale (loop)
+}};
+constexpr const char* INTRO_FILE = "pacman_beginning.wav"; // ultimo file, dopo i campioni
+
+constexpr auto TICK = std::chrono::milliseconds(5);
+constexpr auto CHOMP_IDLE = std::chrono::milliseconds(300);  // senza pellet il chomp sfuma
+constexpr auto MENU_MOVE_INTERVAL = std::chrono::milliseconds(100);
+constexpr float CROSSFADE_SECONDS = 0.25f; // cambio di sirena
+constexpr float FADE_SECONDS = 0.08f;      // chomp, pausa, schermate
+constexpr float CHOMP_ATTACK_SECONDS = 0.02f;
+
+} // namespace
+
+AudioManager::AudioManager(const Config& config) : m_enabled(config.enabled), m_audioDir(config.audioDir) {}
+
+const char* AudioManager::getFileName(std::size_t index) {
+    return index < SAMPLE_COUNT ? SAMPLES[index].file : INTRO_FILE;
+}
+
+bool AudioManager::loadFile(std::size_t index) {
+    static_assert(FILE_COUNT == SAMPLE_COUNT + 1);
+    if (!m_enabled || index >= FILE_COUNT) return false;
+    // Ogni indice tocca solo il suo buffer e il suo flag
+    if (index == SAMPLE_COUNT) {
+        m_introLoaded = m_intro.openFromFile(m_audioDir / INTRO_FILE);
+        if (!m_introLoaded) PACMUX_LOG_ERROR("[AUDIO] Errore caricamento musica di sottofondo!");
+        m_intro.setLooping(false);
+        return m_introLoaded;
+    }
+    m_loaded[index] = m_buffers[index].loadFromFile(m_audioDir / SAMPLES[index].file);
+    if (!m_loaded[index]) PACMUX_LOG_ERROR("[AUDIO] Errore caricamento effetto %s!", SAMPLES[index].file);
+    return m_loaded[index];
+}
+
+void AudioManager::start() {
+    if (!m_enabled || m_thread.joinable()) return;
+    m_thread = std::thread(&AudioManager::run, this);
+}
+
+AudioManager::~AudioManager() {
+    if (!m_thread.joinable()) return;
+    m_stopping.store(true, std::memory_order_release);
+    m_thread.join();
+    for (Voice& voice : m_voices) {
+        if (voice.sound) voice.sound->stop();
+    }
+    m_intro.stop();
+}
+
+void AudioManager::post(Event event) {
+    if (!m_enabled) return;
+    if (event == GameStarted) {
+        // La partita deve aspettare la musica già da questo frame, non da quando il thread audio la avvia
+        m_postedStarted = false;
+        m_postedSiren = SirenNormal;
+        if (!m_introRequested && m_introLoaded) {
+            m_introRequested = true;
+            m_introPlaying.store(true, std::memory_order_release);
+        }
+    }
+    const unsigned head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= QUEUE_SIZE) return; // thread audio fermo: si perde
+    m_queue[head % QUEUE_SIZE] = event;
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+void AudioManager::postSimulation(const GameSimulation& sim) {
+    if (!m_enabled) return;
+    if (!m_postedStarted && sim.isStarted()) {
+        m_postedStarted = true;
+        post(PlayerStarted);
+    }
+    if (sim.hasEvent(GameSimulation::PelletEaten)) post(PelletEaten);
+    if (sim.hasEvent(GameSimulation::SuperPelletEaten)) post(SuperPelletEaten);
+    if (sim.hasEvent(GameSimulation::GhostEaten)) post(GhostEaten);
+    if (sim.hasEvent(GameSimulation::PlayerDied)) post(PlayerDied);
+    // La sirena segue i fantasmi: ritorno alla casa ha la precedenza, frightened è silenzio
+    const Event siren = sim.anyGhostReturning() ? SirenReturning
+                      : sim.anyGhostFrightened() ? SirenFrightened : SirenNormal;
+    if (siren != m_postedSiren) {
+        m_postedSiren = siren;
+        post(siren);
+    }
+}
+
+void AudioManager::run() {
+    TraceRecorder::setThreadName("audio");
+    Clock::time_point last = Clock::now();
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        const Clock::time_point now = Clock::now();
+        const unsigned tail = m_tail.load(std::memory_order_relaxed);
+        const unsigned head = m_head.load(std::memory_order_acquire);
+        for (unsigned i = tail; i != head; ++i) handle(m_queue[i % QUEUE_SIZE], now);
+        m_tail.store(head, std::memory_order_release);
+
+        update(std::chrono::duration<float>(now - last).count(), now);
+        last = now;
+        std::this_thread::sleep_for(TICK);
+    }
+}
+
+void AudioManager::handle(Event event, Clock::time_point now) {
+    switch (event) {
+        case MenuMove:
+            if (now - m_lastMenuMove > MENU_MOVE_INTERVAL) {
+                playEffect(ChompMenu);
+                m_lastMenuMove = now;
+            }
+            break;
+        case Confirm:
+            playEffect(EatGhost);
+            break;
+        case MenuOpen:
+            playEffect(Menu);
+            break;
+        case GameStarted:
+            stopVoice(m_chompVoice);
+            stopVoice(m_sirenVoice);
+            m_chompVoice = m_sirenVoice = -1;
+            m_siren = SirenNormal;
+            m_sirenAllowed = false;
+            m_loopsActive = true;
+            if (!m_introStarted && m_introLoaded) {
+                m_introStarted = true;
+                m_intro.play();
+            }
+            break;
+        case LoopsPaused:
+            m_loopsActive = false;
+            silenceLoops(FADE_SECONDS);
+            break;
+        case LoopsResumed:
+            m_loopsActive = true;
+            updateSiren(CROSSFADE_SECONDS);
+            break;
+        case GameStopped:
+            m_loopsActive = false;
+            m_sirenAllowed = false;
+            silenceLoops(FADE_SECONDS);
+            stopVoice(m_chompVoice); // la prossima partita riparte dall'inizio del loop
+            m_chompVoice = -1;
+            break;
+        case PlayerStarted:
+            m_sirenAllowed = true;
+            updateSiren(CROSSFADE_SECONDS);
+            break;
+        case PelletEaten:
+            if (!m_loopsActive) break;
+            m_lastPellet = now;
+            if (m_chompVoice < 0) {
+                m_chompVoice = startVoice(Chomp, true, 0.f);
+            } else if (m_voices[m_chompVoice].sound->getStatus() != sf::SoundSource::Status::Playing) {
+                m_voices[m_chompVoice].sound->play(); // riprende dal punto della pausa, a tempo col loop
+            }
+            fade(m_chompVoice, SAMPLES[Chomp].volume, CHOMP_ATTACK_SECONDS);
+            break;
+        case SuperPelletEaten:
+            playEffect(GhostBlue);
+            break;
+        case GhostEaten:
+            playEffect(EatGhost);
+            break;
+        case PlayerDied:
+            m_loopsActive = false;
+            silenceLoops(FADE_SECONDS);
+            stopVoice(m_chompVoice);
+            m_chompVoice = -1;
+            playEffect(Death);
+            break;
+        case SirenNormal:
+        case SirenFrightened:
+        case SirenReturning:
+            m_siren = event;
+            updateSiren(CROSSFADE_SECONDS);
+            break;
+    }
+}
+
+void AudioManager::update(float dt, Clock::time_point now) {
+    if (m_introPlaying.load(std::memory_order_relaxed) && m_introStarted &&
+        m_intro.getStatus() != sf::SoundSource::Status::Playing) {
+        m_introPlaying.store(false, std::memory_order_release);
+    }
+    if (m_chompVoice >= 0 && m_voices[m_chompVoice].target > 0.f && now - m_lastPellet > CHOMP_IDLE) {
+        fade(m_chompVoice, 0.f, FADE_SECONDS, true);
+    }
+
+    for (Voice& voice : m_voices) {
+        if (!voice.sound || voice.volume == voice.target) continue;
+        const float step = voice.rate * dt;
+        voice.volume = voice.volume < voice.target ? std::min(voice.volume + step, voice.target)
+                                                   : std::max(voice.volume - step, voice.target);
+        voice.sound->setVolume(voice.volume);
+        if (voice.volume == 0.f) {
+            if (voice.pauseAtZero) voice.sound->pause();
+            else voice.sound->stop();
+        }
+    }
+}
+
+int AudioManager::startVoice(Sample sample, bool looping, float volume) {
+    if (!m_loaded[sample]) return -1;
+    // Una voce ferma; altrimenti l'effetto singolo partito per primo (i loop non si rubano)
+    int chosen = -1;
+    for (int i = 0; i < int(VOICES); ++i) {
+        if (i == m_chompVoice || i == m_sirenVoice) continue;
+        if (!isBusy(i)) {
+            chosen = i;
+            break;
+        }
+        if (!m_voices[i].sound->isLooping() &&
+            (chosen < 0 || m_voices[i].serial < m_voices[chosen].serial)) {
+            chosen = i;
+        }
+    }
+    if (chosen < 0) return -1;
+
+    Voice& voice = m_voices[chosen];
+    if (voice.sound) {
+        voice.sound->stop();
+        voice.sound->setBuffer(m_buffers[sample]);
+    } else {
+        voice.sound.emplace(m_buffers[sample]);
+    }
+    voice.sample = sample;
+    voice.volume = voice.target = volume;
+    voice.rate = 0.f;
+    voice.pauseAtZero = false;
+    voice.serial = ++m_voiceSerial;
+    voice.sound->setLooping(looping);
+    voice.sound->setVolume(volume);
+    voice.sound->play();
+    return chosen;
+}
+
+void AudioManager::playEffect(Sample sample) {
+    startVoice(sample, false, SAMPLES[sample].volume);
+}
+
+void AudioManager::fade(int voice, float target, float seconds, bool pauseAtZero) {
+    if (voice < 0) return;
+    Voice& v = m_voices[voice];
+    v.target = target;
+    v.rate = std::abs(target - v.volume) / seconds;
+    v.pauseAtZero = pauseAtZero;
+}
+
+void AudioManager::stopVoice(int voice) {
+    if (voice < 0 || !m_voices[voice].sound) return;
+    Voice& v = m_voices[voice];
+    v.sound->stop();
+    v.volume = v.target = 0.f;
+}
+
+bool AudioManager::isBusy(int voice) const {
+    const Voice& v = m_voices[voice];
+    // Una voce che sfuma verso lo stop (vecchia sirena) è ancora occupata
+    return v.sound && v.sound->getStatus() != sf::SoundSource::Status::Stopped;
+}
+
+void AudioManager::updateSiren(float seconds) {
+    Sample wanted = SAMPLE_COUNT; // frightened: nessuna sirena
+    if (m_loopsActive && m_sirenAllowed && !m_introPlaying.load(std::memory_order_relaxed)) {
+        if (m_siren == SirenNormal) wanted = GhostNormal;
+        else if (m_siren == SirenReturning) wanted = GhostReturn;
+    }
+    if (m_sirenVoice >= 0 && m_voices[m_sirenVoice].sample == wanted && isBusy(m_sirenVoice)) {
+        fade(m_sirenVoice, SAMPLES[wanted].volume, seconds); // stessa sirena: annulla un'eventuale dissolvenza
+        return;
+    }
+    // Dissolvenza incrociata: la vecchia sirena sfuma e si ferma mentre la nuova sale
+    fade(m_sirenVoice, 0.f, seconds);
+    m_sirenVoice = -1;
+    if (wanted == SAMPLE_COUNT) return;
+    m_sirenVoice = startVoice(wanted, true, 0.f);
+    fade(m_sirenVoice, SAMPLES[wanted].volume, seconds);
+}
+
+void AudioManager::silenceLoops(float seconds) {
+    fade(m_sirenVoice, 0.f, seconds);
+    m_sirenVoice = -1;
+    fade(m_chompVoice, 0.f, seconds, true);
+}
@@ -0,0 +1,273 @@
+#include "Autopilot.hpp"
+#include "SpriteSheet.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using SearchClock = std::chrono::steady_clock;
+
+static constexpr float SCORE_SCALE = 500.f;    // punti che valgono quanto una vita
+static constexpr float DEATH_PENALTY = 1.f;
+static constexpr float LEVEL_BONUS = 1.f;
+static constexpr float DISTANCE_WEIGHT = 0.1f; // distanza dal pellet più vicino, in frazione di w + h
+static constexpr std::uint32_t DEFAULT_ITERATIONS = 1000; // se né budget né maxIterations sono impostati
+static constexpr std::uint8_t ALL_ACTIONS = 0x0F;
+static constexpr std::uint32_t STOP_EVENTS = GameSimulation::PlayerDied | GameSimulation::GameOver |
+    GameSimulation::LevelCompleted | GameSimulation::AllLevelsCompleted | GameSimulation::LevelLoadFailed;
+
+static sf::Vector2f actionDirection(int dir) {
+    return {float(TileMap::DIR_DX[dir]), float(TileMap::DIR_DY[dir])};
+}
+
+Autopilot::Autopilot(const GameSimulation::Config& simConfig, const Config& config)
+    : m_simConfig(simConfig), m_config(config)
+{
+    // Le simulazioni dei worker non caricano texture (HeadlessScope) ma non spengono l'atlas del gioco
+    m_simConfig.headless = false;
+    m_config.actionTicks = std::max(1u, m_config.actionTicks);
+    m_config.horizonTicks = std::max(m_config.actionTicks, m_config.horizonTicks);
+    if (m_config.threads != 1) {
+        m_pool = std::make_unique<ThreadPool>(m_config.threads);
+    }
+    m_workers.resize(getWorkerCount());
+}
+
+Autopilot::~Autopilot() = default;
+
+unsigned Autopilot::getWorkerCount() const {
+    return m_pool ? m_pool->size() : 1u;
+}
+
+void Autopilot::reset(std::uint32_t seed) {
+    m_config.seed = seed;
+    m_searches = 0;
+    m_heading = {0.f, 0.f};
+    m_nextSearchTick = 0;
+    m_searchedLevel = -1;
+    m_searchedLives = -1;
+}
+
+SimInput Autopilot::next(const GameSimulation& sim) {
+    const std::uint64_t tick = sim.getTick();
+    const bool due = tick >= m_nextSearchTick || tick + m_config.actionTicks < m_nextSearchTick; // o partita nuova
+    if (due || sim.getLevel() != m_searchedLevel || sim.getLives() != m_searchedLives) {
+        return search(sim);
+    }
+    return SimInput{m_heading};
+}
+
+SimInput Autopilot::search(const GameSimulation& sim) {
+    m_stats = Stats{};
+    m_nextSearchTick = sim.getTick() + m_config.actionTicks;
+    m_searchedLevel = sim.getLevel();
+    m_searchedLives = sim.getLives();
+    if (sim.isGameOver()) {
+        return SimInput{m_heading};
+    }
+
+    const GameState root = sim.snapshot();
+    const auto start = SearchClock::now();
+    std::uint64_t iterations = m_config.maxIterations;
+    if (iterations == 0 && m_config.budgetSeconds <= 0.f) iterations = DEFAULT_ITERATIONS;
+    m_iterationsLeft.store(iterations > 0 ? iterations : std::numeric_limits<std::uint64_t>::max());
+    m_deadline = m_config.budgetSeconds > 0.f
+        ? start + std::chrono::duration_cast<SearchClock::duration>(std::chrono::duration<float>(m_config.budgetSeconds))
+        : SearchClock::time_point::max();
+    const std::uint32_t searchIndex = m_searches++;
+    for (Worker& worker : m_workers) {
+        worker.search = NO_SEARCH; // alberi della ricerca precedente
+    }
+
+    if (m_pool) {
+        // Un compito per worker; lo stato di ognuno è legato al thread (simulazione e albero restano caldi)
+        for (unsigned i = 0; i < m_pool->size(); ++i) {
+            m_pool->submit([this, &root, searchIndex] {
+                runWorker(m_workers[static_cast<std::size_t>(ThreadPool::currentWorker())], root, searchIndex);
+            });
+        }
+        m_pool->wait();
+    } else {
+        runWorker(m_workers[0], root, searchIndex);
+    }
+
+    // Somma delle visite alla radice di tutti gli alberi
+    float rewardSum[4] = {};
+    for (Worker& worker : m_workers) {
+        if (worker.search != searchIndex) continue; // nessun compito in questa ricerca
+        m_stats.iterations += worker.iterations;
+        m_stats.ticks += worker.ticks;
+        if (worker.nodes.empty()) continue;
+        const Node& rootNode = worker.nodes[0];
+        for (int dir = 0; dir < 4; ++dir) {
+            const std::int32_t child = rootNode.child[dir];
+            if (child < 0) continue;
+            m_stats.visits[dir] += worker.nodes[child].visits;
+            rewardSum[dir] += worker.nodes[child].reward;
+        }
+    }
+    int best = -1;
+    for (int dir = 0; dir < 4; ++dir) {
+        if (m_stats.visits[dir] == 0) continue;
+        m_stats.value[dir] = rewardSum[dir] / m_stats.visits[dir];
+        if (best < 0 || m_stats.visits[dir] > m_stats.visits[best] ||
+            (m_stats.visits[dir] == m_stats.visits[best] && m_stats.value[dir] > m_stats.value[best])) {
+            best = dir;
+        }
+    }
+    m_stats.action = best;
+    ++m_totalSearches;
+    m_totalTicks += m_stats.ticks;
+    m_stats.seconds = std::chrono::duration<double>(SearchClock::now() - start).count();
+    if (best >= 0) {
+        m_heading = actionDirection(best);
+    }
+    return SimInput{m_heading};
+}
+
+void Autopilot::runWorker(Worker& worker, const GameState& root, std::uint32_t searchIndex) {
+    SpriteSheet::HeadlessScope headless;
+    if (!worker.sim) {
+        worker.sim = std::make_unique<GameSimulation>(m_simConfig);
+        worker.nodes.reserve(4096);
+        worker.path.reserve(m_config.horizonTicks / m_config.actionTicks + 2);
+    }
+    // Un worker che ruba il compito di un altro nella stessa ricerca prosegue il proprio albero
+    if (worker.search != searchIndex) {
+        worker.search = searchIndex;
+        worker.rng.seed((std::uint64_t(m_config.seed) << 32) ^ (std::uint64_t(searchIndex) << 8) ^
+                        static_cast<std::uint64_t>(&worker - m_workers.data()));
+        worker.nodes.clear();
+        worker.nodes.push_back(Node{{-1, -1, -1, -1}, 0, 0.f, ALL_ACTIONS});
+        worker.iterations = 0;
+        worker.ticks = 0;
+    }
+
+    while (SearchClock::now() < m_deadline) {
+        std::uint64_t left = m_iterationsLeft.load(std::memory_order_relaxed);
+        do {
+            if (left == 0) return;
+        } while (!m_iterationsLeft.compare_exchange_weak(left, left - 1, std::memory_order_relaxed));
+        iterate(worker, root);
+        ++worker.iterations;
+    }
+}
+
+float Autopilot::iterate(Worker& worker, const GameState& root) {
+    GameSimulation& sim = *worker.sim;
+    if (!sim.restore(root)) return 0.f;
+
+    unsigned ticks = 0;
+    std::uint32_t events = 0;
+    bool running = true;
+    std::int32_t node = 0;
+    worker.path.clear();
+    worker.path.push_back(0);
+
+    // Selezione (UCB1) ed espansione di un nodo nuovo
+    while (running && ticks + m_config.actionTicks <= m_config.horizonTicks) {
+        Node& current = worker.nodes[node];
+        int dir;
+        bool expand = current.untried != 0;
+        if (expand) {
+            int options[4], count = 0;
+            for (int d = 0; d < 4; ++d) {
+                if (current.untried & (1u << d)) options[count++] = d;
+            }
+            dir = options[worker.rng() % count];
+            current.untried &= static_cast<std::uint8_t>(~(1u << dir));
+        } else {
+            const float logVisits = std::log(float(std::max(current.visits, 1u)));
+            float bestScore = -std::numeric_limits<float>::infinity();
+            dir = 0;
+            for (int d = 0; d < 4; ++d) {
+                const Node& child = worker.nodes[current.child[d]];
+                const float score = child.reward / child.visits +
+                    m_config.exploration * std::sqrt(logVisits / child.visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    dir = d;
+                }
+            }
+        }
+        running = applyAction(worker, dir, ticks, events);
+        if (expand) {
+            const std::int32_t child = static_cast<std::int32_t>(worker.nodes.size());
+            worker.nodes[node].child[dir] = child; // current non è più valido dopo il push_back
+            worker.nodes.push_back(Node{{-1, -1, -1, -1}, 0, 0.f, ALL_ACTIONS});
+            worker.path.push_back(child);
+            break;
+        }
+        node = worker.nodes[node].child[dir];
+        worker.path.push_back(node);
+    }
+
+    // Rollout casuale fino all'orizzonte
+    while (running && ticks < m_config.horizonTicks) {
+        running = applyAction(worker, rolloutAction(worker), ticks, events);
+    }
+    worker.ticks += ticks;
+
+    const float reward = evaluate(sim, root, events);
+    for (std::int32_t index : worker.path) {
+        worker.nodes[index].visits++;
+        worker.nodes[index].reward += reward;
+    }
+    return reward;
+}
+
+bool Autopilot::applyAction(Worker& worker, int dir, unsigned& ticks, std::uint32_t& events) {
+    const SimInput input{actionDirection(dir)};
+    for (unsigned i = 0; i < m_config.actionTicks && ticks < m_config.horizonTicks; ++i) {
+        worker.sim->step(GameSimulation::TICK, input);
+        ++ticks;
+        events |= worker.sim->getEvents();
+        if (events & STOP_EVENTS) return false;
+    }
+    return true;
+}
+
+// Un'uscita libera a caso dalla cella di Pac-Man, evitando di tornare indietro se ce n'è un'altra
+int Autopilot::rolloutAction(Worker& worker) const {
+    const GameSimulation& sim = *worker.sim;
+    const TileMap& map = sim.getMap();
+    const sf::Vector2u tileSize = sim.getTileSize();
+    const sf::Vector2f pos = sim.getPlayer().getPosition();
+    const sf::Vector2f heading = sim.getPlayer().getDirection();
+    const int x = static_cast<int>(pos.x / tileSize.x);
+    const int y = static_cast<int>(pos.y / tileSize.y);
+    int open[4], forward[4];
+    int openCount = 0, forwardCount = 0;
+    for (int dir = 0; dir < 4; ++dir) {
+        int nx, ny;
+        if (!map.neighbor(x, y, dir, nx, ny) || map.isWall(nx, ny) || map.isGhostHouse(nx, ny)) continue;
+        open[openCount++] = dir;
+        if (actionDirection(dir) != -heading) forward[forwardCount++] = dir;
+    }
+    if (forwardCount > 0) return forward[worker.rng() % forwardCount];
+    if (openCount > 0) return open[worker.rng() % openCount];
+    return static_cast<int>(worker.rng() % 4);
+}
+
+float Autopilot::evaluate(const GameSimulation& sim, const GameState& root, std::uint32_t events) const {
+    float reward = (float(sim.getScore()) - float(root.score)) / SCORE_SCALE;
+    if (events & (GameSimulation::PlayerDied | GameSimulation::GameOver)) {
+        return reward - DEATH_PENALTY;
+    }
+    if (events & (GameSimulation::LevelCompleted | GameSimulation::AllLevelsCompleted)) {
+        return reward + LEVEL_BONUS;
+    }
+    // Distanza (Manhattan, in celle) dal pellet più vicino
+    const sf::Vector2u tileSize = sim.getTileSize();
+    const sf::Vector2u mapSize = sim.getMap().getSize();
+    const sf::Vector2f pos = sim.getPlayer().getPosition();
+    const int px = static_cast<int>(pos.x / tileSize.x);
+    const int py = static_cast<int>(pos.y / tileSize.y);
+    int nearest = int(mapSize.x + mapSize.y);
+    auto closer = [&](unsigned x, unsigned y) {
+        nearest = std::min(nearest, std::abs(int(x) - px) + std::abs(int(y) - py));
+    };
+    sim.getPellets().forEach(closer);
+    sim.getSuperPellets().forEach(closer);
+    return reward - DISTANCE_WEIGHT * float(nearest) / float(mapSize.x + mapSize.y);
+}
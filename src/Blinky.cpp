@@ -1,12 +1,14 @@
 #include "Blinky.hpp"
+#include "FlowField.hpp"
 #include <cmath>
-#include <iostream>
+#include "Logger.hpp"
+#include <cstdint>
 
 // Blinky: il fantasma rosso, insegue direttamente Pac-Man
-Blinky::Blinky(const sf::Vector2f& pos) : Ghost(pos, sf::Color::Red, 12.0f, Type::Blinky) {
-    // Carica la texture solo una volta
-    m_texture = std::make_unique<sf::Texture>();
-    if (m_texture->loadFromFile("assets/pacman.png")) {
+Blinky::Blinky(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos)
+    : Ghost(positions, slot, pos, sf::Color::Red, 12.0f, Type::Blinky) {
+    // Atlas condiviso già acquisito dal costruttore di Ghost
+    if (m_texture) {
         m_sprite = std::make_unique<sf::Sprite>(*m_texture);
         m_sprite->setTextureRect(BLINKY_FRAMES[2][0]); // frame iniziale: destra, anim 0
         m_sprite->setOrigin(sf::Vector2f{8.f, 8.f}); // centro per 16x16
@@ -26,20 +28,51 @@ sf::Vector2f Blinky::calculateTarget(const sf::Vector2f& pacmanPos, const sf::Ve
     return pacmanPos;
 }
 
+// In chase il target è Pac-Man: usa direttamente il cammino minimo precalcolato
+sf::Vector2f Blinky::findPath(const sf::Vector2f& target, const TileMap& map, const sf::Vector2u& tileSize) {
+    if (m_mode == Mode::Chase && !m_isFrightened) {
+        return findPathToPacman(target, map, tileSize);
+    }
+    return Ghost::findPath(target, map, tileSize);
+}
+
+sf::Vector2f Blinky::findPathToPacman(const sf::Vector2f& pacmanPos, const TileMap& map, const sf::Vector2u& tileSize) {
+    sf::Vector2f pos = position();
+    int startX = int(std::round((pos.x - tileSize.x/2.f) / tileSize.x));
+    int startY = int(std::round((pos.y - tileSize.y/2.f) / tileSize.y));
+    int fromNode = map.nodeAt(startX, startY);
+    int toNode = map.nodeAt(int(std::floor(pacmanPos.x / tileSize.x)), int(std::floor(pacmanPos.y / tileSize.y)));
+    std::uint8_t hop = m_flowFields ? m_flowFields->toward(toNode).nextHop(map, fromNode) : TileMap::NO_DIRECTION;
+    if (hop != TileMap::NO_DIRECTION) {
+        sf::Vector2f dir{float(TileMap::DIR_DX[hop]), float(TileMap::DIR_DY[hop])};
+        bool isReverse = (dir + m_direction == sf::Vector2f(0,0) && m_direction != sf::Vector2f(0,0));
+        if (!isReverse && canMove(dir, map, tileSize)) {
+            return dir;
+        }
+    }
+    return greedyFallback(pacmanPos, map, tileSize);
+}
+
+sf::Vector2f Blinky::greedyFallback(const sf::Vector2f& pacmanPos, const TileMap& map, const sf::Vector2u& tileSize) {
+    return Ghost::findPath(pacmanPos, map, tileSize);
+}
+
 void Blinky::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
                   const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode, bool gameStarted) {
-    static float debugTimer = 0.f;
     m_mode = mode;
-    sf::Vector2f pos = m_shape.getPosition();
-    debugTimer += dt;
-    if (debugTimer >= 1.0f) {
-        std::string modeStr = (m_mode == Mode::Chase) ? "Chase" : (m_mode == Mode::Scatter) ? "Scatter" : "Other";
-        std::cout << "[BLINKY] Pos: (" << pos.x << "," << pos.y << ") Dir: (" << m_direction.x << "," << m_direction.y << ") Pacman: (" << pacmanPos.x << "," << pacmanPos.y << ") Mode: " << modeStr << std::endl;
-        debugTimer = 0.f;
+    sf::Vector2f pos = position();
+    // Log di debug una volta al secondo: senza il livello Debug compilato non resta nemmeno il timer
+    if constexpr (Logger::compiledIn(Logger::Debug)) {
+        m_debugTimer += dt;
+        if (m_debugTimer >= 1.0f) {
+            const char* modeStr = (m_mode == Mode::Chase) ? "Chase" : (m_mode == Mode::Scatter) ? "Scatter" : "Other";
+            PACMUX_LOG_DEBUG("[BLINKY] Pos: (%g,%g) Dir: (%g,%g) Pacman: (%g,%g) Mode: %s", pos.x, pos.y,
+                             m_direction.x, m_direction.y, pacmanPos.x, pacmanPos.y, modeStr);
+            m_debugTimer = 0.f;
+        }
     }
     // --- Animazione sprite ---
     if (m_hasTexture && m_sprite) {
-        m_sprite->setPosition(m_shape.getPosition());
         m_animTime += dt;
         if (m_direction != sf::Vector2f{0,0}) {
             if (m_animTime >= GHOST_ANIMATION_INTERVAL) {
@@ -73,41 +106,35 @@ void Blinky::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
     Ghost::update(dt, map, tileSize, pacmanPos, pacmanDirection, mode, gameStarted);
 }
 
-// Disegna Blinky (override draw se vuoi sprite)
-void Blinky::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    states.transform *= getTransform();
-    if (m_hasTexture && m_sprite) {
-        m_sprite->setPosition(m_drawPos);
-        if (m_eaten || m_isReturningToHouse) {
-            int dir = 2;
-            if (m_direction.x < 0) dir = 0;
-            else if (m_direction.x > 0) dir = 2;
-            else if (m_direction.y < 0) dir = 1;
-            else if (m_direction.y > 0) dir = 3;
-            m_sprite->setTextureRect(EYES_FRAMES[dir]);
-        } else if (m_isFrightened) {
-            if (m_frightenedDuration - m_frightenedTimer < 2.f) {
-                bool white = (int((m_frightenedTimer * 8)) % 2) == 1;
-                if (white) {
-                    m_sprite->setTextureRect(FRIGHTENED_WHITE_FRAMES[m_animFrame % 2]);
-                } else {
-                    m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
-                }
+// Frame di Blinky: occhi, frightened (bianco negli ultimi 2s) o animazione per direzione
+const sf::Sprite* Blinky::currentSprite() const {
+    if (!m_hasTexture || !m_sprite) return nullptr;
+    m_sprite->setPosition(renderPosition());
+    if (m_eaten || m_isReturningToHouse) {
+        int dir = 2;
+        if (m_direction.x < 0) dir = 0;
+        else if (m_direction.x > 0) dir = 2;
+        else if (m_direction.y < 0) dir = 1;
+        else if (m_direction.y > 0) dir = 3;
+        m_sprite->setTextureRect(EYES_FRAMES[dir]);
+    } else if (m_isFrightened) {
+        if (m_frightenedDuration - m_frightenedTimer < 2.f) {
+            bool white = (int((m_frightenedTimer * 8)) % 2) == 1;
+            if (white) {
+                m_sprite->setTextureRect(FRIGHTENED_WHITE_FRAMES[m_animFrame % 2]);
             } else {
                 m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
             }
         } else {
-            int dir = 2;
-            if (m_direction.x < 0) dir = 0;
-            else if (m_direction.x > 0) dir = 2;
-            else if (m_direction.y < 0) dir = 1;
-            else if (m_direction.y > 0) dir = 3;
-            m_sprite->setTextureRect(BLINKY_FRAMES[dir][m_animFrame]);
+            m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
         }
-        target.draw(*m_sprite, states);
     } else {
-        sf::CircleShape shape = m_shape;
-        shape.setPosition(m_drawPos);
-        target.draw(shape, states);
+        int dir = 2;
+        if (m_direction.x < 0) dir = 0;
+        else if (m_direction.x > 0) dir = 2;
+        else if (m_direction.y < 0) dir = 1;
+        else if (m_direction.y > 0) dir = 3;
+        m_sprite->setTextureRect(BLINKY_FRAMES[dir][m_animFrame]);
     }
+    return m_sprite.get();
 }
@@ -0,0 +1,69 @@
+#include "FlowField.hpp"
+
+void FlowField::reserve(std::size_t nodeCount) {
+    m_dist.reserve(nodeCount);
+    m_frontier.reserve(nodeCount);
+}
+
+void FlowField::build(const TileMap& map, int targetNode) {
+    const std::size_t n = map.getNodeCount();
+    m_target = targetNode;
+    m_dist.assign(n, TileMap::UNREACHABLE);
+    m_frontier.clear();
+    if (targetNode < 0 || static_cast<std::size_t>(targetNode) >= n) return;
+
+    m_dist[targetNode] = 0;
+    m_frontier.push_back(static_cast<std::int16_t>(targetNode));
+    for (std::size_t head = 0; head < m_frontier.size(); ++head) {
+        const int cur = m_frontier[head];
+        for (int d = 0; d < 4; ++d) {
+            const int next = map.adjacentNode(cur, d);
+            if (next < 0 || m_dist[next] != TileMap::UNREACHABLE) continue;
+            m_dist[next] = static_cast<std::uint16_t>(m_dist[cur] + 1);
+            m_frontier.push_back(static_cast<std::int16_t>(next));
+        }
+    }
+}
+
+std::uint8_t FlowField::nextHop(const TileMap& map, int node) const {
+    if (node < 0 || node == m_target || static_cast<std::size_t>(node) >= m_dist.size()) return TileMap::NO_DIRECTION;
+    std::uint16_t best = TileMap::UNREACHABLE;
+    std::uint8_t hop = TileMap::NO_DIRECTION;
+    for (int d = 0; d < 4; ++d) {
+        const int next = map.adjacentNode(node, d);
+        if (next >= 0 && m_dist[next] < best) {
+            best = m_dist[next];
+            hop = static_cast<std::uint8_t>(d);
+        }
+    }
+    return hop;
+}
+
+void FlowFieldCache::reset(const TileMap& map) {
+    m_map = &map;
+    m_clock = 0;
+    for (Slot& slot : m_slots) {
+        slot.valid = false;
+        slot.lastUse = 0;
+        slot.field.reserve(map.getNodeCount());
+    }
+}
+
+const FlowField& FlowFieldCache::toward(int targetNode) {
+    ++m_clock;
+    Slot* oldest = &m_slots[0];
+    for (Slot& slot : m_slots) {
+        if (slot.valid && slot.field.getTarget() == targetNode) {
+            slot.lastUse = m_clock;
+            return slot.field;
+        }
+        if (!slot.valid || (oldest->valid && slot.lastUse < oldest->lastUse)) {
+            oldest = &slot;
+        }
+    }
+    oldest->field.build(*m_map, targetNode);
+    oldest->valid = true;
+    oldest->lastUse = m_clock;
+    ++m_builds;
+    return oldest->field;
+}
@@ -0,0 +1,68 @@
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <cstdio>
+
+FrameProfiler::FrameProfiler() {
+    for (auto& row : m_rows) {
+        for (auto& sample : row) sample.store(0.f, std::memory_order_relaxed);
+    }
+}
+
+FrameProfiler::Summary FrameProfiler::summarize(Phase phase, std::size_t frames) const {
+    Summary summary;
+    const std::uint64_t published = getFrameCount();
+    const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>({published, frames, HISTORY - 1}));
+    if (count == 0) return summary;
+
+    // La riga in scrittura (published % HISTORY) non è tra quelle lette
+    std::array<float, HISTORY> values;
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i] = m_rows[(published - 1 - i) % HISTORY][phase].load(std::memory_order_relaxed);
+        sum += values[i];
+    }
+    const auto [minIt, maxIt] = std::minmax_element(values.begin(), values.begin() + count);
+    summary.min = *minIt;
+    summary.max = *maxIt;
+    summary.avg = static_cast<float>(sum / count);
+    // p99: il valore sotto cui sta il 99% dei frame (rango ceil(0.99 * n))
+    const std::size_t rank = (count * 99 + 99) / 100 - 1;
+    std::nth_element(values.begin(), values.begin() + rank, values.begin() + count);
+    summary.p99 = values[rank];
+    summary.frames = count;
+    return summary;
+}
+
+std::string FrameProfiler::report(std::size_t frames) const {
+    std::string out;
+    char line[96];
+    std::snprintf(line, sizeof(line), "%-12s %7s %7s %7s %7s  ms\n", "fase", "min", "media", "p99", "max");
+    out += line;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        const Summary s = summarize(static_cast<Phase>(p), frames);
+        std::snprintf(line, sizeof(line), "%-12s %7.3f %7.3f %7.3f %7.3f\n", phaseName(static_cast<Phase>(p)),
+                      s.min, s.avg, s.p99, s.max);
+        out += line;
+    }
+    return out;
+}
+
+const char* FrameProfiler::phaseName(Phase phase) {
+    switch (phase) {
+        case Frame:         return "frame";
+        case Events:        return "eventi";
+        case Simulation:    return "simulazione";
+        case SimPlayer:     return " pacman";
+        case SimGhosts:     return " fantasmi";
+        case SimPellets:    return " pellet";
+        case SimFruits:     return " frutti";
+        case SimCollisions: return " collisioni";
+        case SimLevelLoad:  return " livelli";
+        case Audio:         return "audio";
+        case DrawMap:       return "mappa";
+        case DrawActors:    return "attori";
+        case DrawHud:       return "hud";
+        case Display:       return "display";
+        default:            return "?";
+    }
+}
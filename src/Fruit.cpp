@@ -1,4 +1,5 @@
 #include "Fruit.hpp"
+#include "SpriteSheet.hpp"
 #include <filesystem>
 
 using namespace std;
@@ -23,11 +24,11 @@ static const sf::IntRect FRUIT_RECTS[4] = {
 static const int FRUIT_SCORES[4] = {100, 300, 500, 700};
 
 Fruit::Fruit(const sf::Vector2f& pos, Type type)
-    : m_type(type), m_fallbackShape(8.f) // fallback radius ~8px
+    : m_position(pos), m_type(type), m_fallbackShape(8.f) // fallback radius ~8px
 {
     // Carica texture come fanno Pac-Man e Ghost
-    m_texture = std::make_unique<sf::Texture>();
-    if (m_texture->loadFromFile("assets/pacman.png")) {
+    m_texture = SpriteSheet::acquire();
+    if (m_texture) {
         m_sprite = std::make_unique<sf::Sprite>(*m_texture);
         auto idx = static_cast<int>(type);
         m_sprite->setTextureRect(FRUIT_RECTS[idx]);
@@ -74,3 +75,12 @@ void Fruit::draw(sf::RenderTarget& target, sf::RenderStates states) const {
         target.draw(m_fallbackShape, states);
     }
 }
+
+void Fruit::appendTo(SpriteBatch& batch, const sf::Transform& transform) const {
+    const sf::Transform t = transform * getTransform();
+    if (m_hasTexture) {
+        if (m_sprite) batch.add(*m_sprite, t);
+    } else {
+        batch.addCircle(m_fallbackShape.getPosition(), m_fallbackShape.getRadius(), m_fallbackShape.getFillColor(), t);
+    }
+}
@@ -0,0 +1,617 @@
+#include "GameSimulation.hpp"
+#include "SpriteSheet.hpp"
+#include "Blinky.hpp"
+#include "Pinky.hpp"
+#include "Inky.hpp"
+#include "Clyde.hpp"
+#include "Replay.hpp"
+#include "AllocationCounter.hpp"
+#include "TraceRecorder.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Tabella classica scatter/chase (in secondi), -1 = chase infinito
+static const float SCATTER_CHASE_TIMES[] = {7.f, 20.f, 7.f, 20.f, 5.f, 20.f, 5.f, -1.f};
+static constexpr int NUM_MODE_PHASES = sizeof(SCATTER_CHASE_TIMES) / sizeof(SCATTER_CHASE_TIMES[0]);
+
+static constexpr float MIN_FRIGHTENED = 1.5f;
+static constexpr float MIN_RELEASE = 0.5f;
+
+// Centro in pixel della cella (x, y)
+static sf::Vector2f tileCenter(unsigned x, unsigned y, const sf::Vector2u& tileSize) {
+    return {x * float(tileSize.x) + tileSize.x / 2.f, y * float(tileSize.y) + tileSize.y / 2.f};
+}
+
+using ProfileClock = std::chrono::steady_clock;
+
+// Cronometro a giri per i sottosistemi: ogni lap() somma il tempo dall'ultimo giro nello slot indicato.
+// Se il profiling è spento non legge mai l'orologio
+class SubsystemStopwatch {
+public:
+    explicit SubsystemStopwatch(bool enabled) : m_enabled(enabled) {
+        if (m_enabled) m_mark = ProfileClock::now();
+    }
+    void lap(double& slot) {
+        if (!m_enabled) return;
+        const ProfileClock::time_point now = ProfileClock::now();
+        slot += std::chrono::duration<double>(now - m_mark).count();
+        m_mark = now;
+    }
+private:
+    bool m_enabled;
+    ProfileClock::time_point m_mark;
+};
+
+GameSimulation::SubsystemTimes& GameSimulation::SubsystemTimes::operator+=(const SubsystemTimes& other) {
+    player += other.player;
+    ghosts += other.ghosts;
+    pellets += other.pellets;
+    fruits += other.fruits;
+    collisions += other.collisions;
+    levelLoad += other.levelLoad;
+    return *this;
+}
+
+GameSimulation::HeadlessInit::HeadlessInit(bool headless) {
+    if (headless) {
+        SpriteSheet::setEnabled(false);
+    }
+}
+
+GameSimulation::GameSimulation(const Config& config)
+    : m_headlessInit(config.headless), m_config(config), m_tileSize(config.tileSize), m_rng(config.seed), m_seed(config.seed),
+      m_player(m_actorPositions, PLAYER_SPEED, {0.f, 0.f}, config.tileSize)
+{
+    // Il buffer di log del thread si alloca qui, non al primo messaggio dentro update
+    Logger::prepareThread();
+}
+
+bool GameSimulation::newGame(std::uint32_t seed) {
+    m_seed = seed;
+    m_rng.seed(seed);
+    m_tick = 0;
+    m_ghostUpdateAllocations = 0;
+    m_accumulator = 0.f;
+    m_score = 0;
+    m_extraLifeGiven = false;
+    m_currentLevel = 0;
+    m_difficultyLevel = 1;
+    m_gameOver = false;
+    applyDifficulty();
+    m_player.setLives(START_LIVES);
+    return loadLevel(0);
+}
+
+// Ricalcola i parametri dipendenti dalla difficoltà
+void GameSimulation::applyDifficulty() {
+    float k = float(m_difficultyLevel - 1);
+    // Velocità fantasmi +20% per livello di difficoltà
+    m_ghostBaseSpeed = 90.f * std::pow(1.2f, k);
+    // Frightened -20% per livello (minimo 1.5s)
+    m_frightenedBaseDuration = std::max(MIN_FRIGHTENED, 6.0f * std::pow(0.8f, k));
+    // Tempi di rilascio -20% per livello (minimo 0.5s, il primo resta 0)
+    for (size_t i = 1; i < m_ghostReleaseDelays.size(); ++i) {
+        m_ghostReleaseDelays[i] = std::max(MIN_RELEASE, 3.f * std::pow(0.8f, k));
+    }
+    // Attesa in ghost house dopo essere stati mangiati -20% per livello
+    m_ghostRespawnDuration = std::max(0.5f, 3.0f * std::pow(0.8f, k));
+}
+
+bool GameSimulation::loadLevel(int levelIdx, bool resetPellets) {
+    TraceRecorder::Scope trace("loadLevel", "sim");
+    SubsystemStopwatch stopwatch(m_profiling);
+    m_loadedLevel = -1;
+    if (levelIdx < 0 || levelIdx >= int(m_config.mapFiles.size()) ||
+        !m_map.load(m_config.mapFiles[levelIdx], m_tileSize)) {
+        m_events |= LevelLoadFailed;
+        return false;
+    }
+    m_mapSize = m_map.getSize();
+    // I pellet (e GameState) hanno spazio per al più PelletGrid::MAX_CELLS celle
+    if (std::size_t(m_mapSize.x) * m_mapSize.y > PelletGrid::MAX_CELLS) {
+        PACMUX_LOG_ERROR("[ERROR] Mappa troppo grande (%ux%u, massimo %zu celle): %s", m_mapSize.x, m_mapSize.y,
+                         PelletGrid::MAX_CELLS, m_config.mapFiles[levelIdx].c_str());
+        m_events |= LevelLoadFailed;
+        return false;
+    }
+    m_loadedLevel = levelIdx;
+    m_flowFields.reset(m_map);
+
+    // Trova spawn Pac-Man ('P') o usa il centro
+    m_startPos = {(m_mapSize.x * m_tileSize.x) / 2.f, (m_mapSize.y * m_tileSize.y) / 2.f};
+    for (unsigned y = 0; y < m_mapSize.y; ++y) {
+        for (unsigned x = 0; x < m_mapSize.x; ++x) {
+            if (m_map.cellFlags(x, y) & TileMap::CELL_PACMAN_SPAWN) {
+                m_startPos = tileCenter(x, y, m_tileSize);
+            }
+        }
+    }
+
+    // Reset pellet e super pellet solo se richiesto (non dopo una vita persa)
+    if (resetPellets) {
+        m_pellets.reset(m_mapSize, m_tileSize);
+        m_superPellets.reset(m_mapSize, m_tileSize);
+        m_fruits.clear();
+        m_pelletsEatenCount = 0;
+        m_fruit30Spawned = false;
+        m_fruit70Spawned = false;
+        m_firstFruitTypeSet = false;
+        for (unsigned y = 0; y < m_mapSize.y; ++y) {
+            for (unsigned x = 0; x < m_mapSize.x; ++x) {
+                const std::uint8_t cell = m_map.cellFlags(x, y);
+                sf::Vector2f pos = tileCenter(x, y, m_tileSize);
+                bool isPacmanSpawn = (std::abs(pos.x - m_startPos.x) < 1e-2f && std::abs(pos.y - m_startPos.y) < 1e-2f);
+                // Pellet solo sui tile '0', esclusa la cella di spawn di Pac-Man
+                if ((cell & TileMap::CELL_PELLET) && !isPacmanSpawn) {
+                    m_pellets.add(x, y);
+                }
+                if (cell & TileMap::CELL_SUPER_PELLET) {
+                    m_superPellets.add(x, y);
+                }
+            }
+        }
+    }
+
+    // Reset fantasmi nelle posizioni della ghost house (porta e cella centrale lette dalla mappa)
+    const sf::Vector2u door = m_map.getGhostHouseDoor();
+    const sf::Vector2u house = m_map.getGhostHouseCenter();
+    m_ghosts.clear();
+    m_ghosts.push_back(std::make_unique<Blinky>(m_actorPositions, 1, tileCenter(door.x, door.y, m_tileSize)));  // porta della ghost house
+    m_ghosts.push_back(std::make_unique<Pinky>(m_actorPositions, 2, tileCenter(house.x, house.y, m_tileSize)));
+    m_ghosts.push_back(std::make_unique<Inky>(m_actorPositions, 3, tileCenter(house.x + 1, house.y, m_tileSize)));
+    m_ghosts.push_back(std::make_unique<Clyde>(m_actorPositions, 4, tileCenter(house.x - 1, house.y, m_tileSize)));
+    for (auto& g : m_ghosts) {
+        g->setSpeed(m_ghostBaseSpeed);
+        g->setFrightened(0.f);
+        g->setEaten(false);
+        g->setReleased(false);
+        g->setRespawnDuration(m_ghostRespawnDuration);
+        g->setRandomSeed(static_cast<std::uint32_t>(m_rng()));
+        g->setFlowFields(&m_flowFields);
+    }
+    m_nextGhostToRelease = 0;
+    m_ghostReleaseTimer = 0.f;
+
+    // Il ciclo scatter/chase riparte a ogni livello e dopo ogni vita persa
+    m_ghostMode = Ghost::Mode::Scatter;
+    m_modeTimer = 0.f;
+    m_modePhase = 0;
+
+    m_ghostEatPauseTimer = 0.f;
+    m_ghostEatCombo = 0;
+
+    // Ricrea Pac-Man mantenendo le vite
+    int currentLives = m_player.getLives();
+    m_player = Player(m_actorPositions, PLAYER_SPEED, m_startPos, m_tileSize);
+    m_player.setLives(currentLives);
+
+    m_started = false;
+    stopwatch.lap(m_times.levelLoad);
+    return true;
+}
+
+void GameSimulation::addScore(unsigned value) {
+    m_score += value;
+    // Vita extra (una sola volta per partita)
+    if (!m_extraLifeGiven && m_score >= EXTRA_LIFE_SCORE) {
+        m_extraLifeGiven = true;
+        m_player.setLives(m_player.getLives() + 1);
+        m_player.stopMovement();
+        m_events |= ExtraLife;
+    }
+}
+
+void GameSimulation::step(float dt, const SimInput& input) {
+    m_events = 0;
+    if (m_gameOver) return;
+    update(dt, input);
+    ++m_tick;
+    if (m_recorder) {
+        m_recorder->recordTick(input, *this);
+    }
+}
+
+void GameSimulation::update(float dt, const SimInput& input) {
+    // Pausa dopo aver mangiato un fantasma: tutto fermo
+    if (m_ghostEatPauseTimer > 0.f) {
+        m_ghostEatPauseTimer -= dt;
+        return;
+    }
+
+    SubsystemStopwatch stopwatch(m_profiling);
+
+    // Animazione di morte: aggiorna solo Pac-Man
+    if (m_player.isDying()) {
+        m_player.update(dt, m_map, m_tileSize);
+        stopwatch.lap(m_times.player);
+        if (m_player.isDeathAnimationFinished()) {
+            handleDeathFinished();
+        }
+        return;
+    }
+
+    // Attendi la prima mossa del giocatore
+    if (!m_started) {
+        if (input.direction == sf::Vector2f{0.f, 0.f}) return;
+        m_started = true;
+    }
+
+    // completeLevel e handleDeathFinished misurano da sé il caricamento del livello (levelLoad)
+    updateModeTimer(dt);
+    m_player.update(dt, m_map, m_tileSize, input.direction);
+    stopwatch.lap(m_times.player);
+    updateGhostRelease(dt);
+    updateGhosts(dt);
+    stopwatch.lap(m_times.ghosts);
+    updatePellets();
+    stopwatch.lap(m_times.pellets);
+    updateFruits(dt);
+    stopwatch.lap(m_times.fruits);
+    updateSuperPellets();
+    stopwatch.lap(m_times.pellets);
+
+    // Tutti i pellet raccolti: livello successivo
+    if (m_pellets.empty()) {
+        completeLevel();
+        return;
+    }
+
+    updateGhostCollisions();
+    stopwatch.lap(m_times.collisions);
+
+    // Reset combo solo se nessun fantasma è frightened
+    if (!anyGhostFrightened()) {
+        m_ghostEatCombo = 0;
+    }
+}
+
+int GameSimulation::advance(float frameDt, const SimInput& input) {
+    m_accumulator += std::min(frameDt, MAX_FRAME_TIME);
+    std::uint32_t frameEvents = 0;
+    int ticks = 0;
+    while (m_accumulator >= TICK) {
+        m_accumulator -= TICK;
+        m_player.beginTick();
+        for (auto& g : m_ghosts) {
+            g->beginTick();
+        }
+        step(TICK, input);
+        frameEvents |= m_events;
+        ++ticks;
+        if (m_events & INTERRUPT_EVENTS) {
+            m_accumulator = 0.f;
+            break;
+        }
+    }
+    m_events = frameEvents;
+    return ticks;
+}
+
+void GameSimulation::setRenderAlpha(float alpha) {
+    m_player.setRenderAlpha(alpha);
+    for (auto& g : m_ghosts) {
+        g->setRenderAlpha(alpha);
+    }
+}
+
+void GameSimulation::updateModeTimer(float dt) {
+    if (m_modePhase < NUM_MODE_PHASES && SCATTER_CHASE_TIMES[m_modePhase] > 0.f) {
+        m_modeTimer += dt;
+        if (m_modeTimer >= SCATTER_CHASE_TIMES[m_modePhase]) {
+            m_modeTimer = 0.f;
+            m_modePhase++;
+            m_ghostMode = (m_ghostMode == Ghost::Mode::Scatter) ? Ghost::Mode::Chase : Ghost::Mode::Scatter;
+        }
+    }
+}
+
+void GameSimulation::updateGhostRelease(float dt) {
+    if (m_nextGhostToRelease < int(m_ghosts.size())) {
+        m_ghostReleaseTimer += dt;
+        if (m_ghostReleaseTimer >= m_ghostReleaseDelays[m_nextGhostToRelease]) {
+            m_ghosts[m_nextGhostToRelease]->setReleased(true);
+            m_nextGhostToRelease++;
+            m_ghostReleaseTimer = 0.f; // resetta il timer SOLO dopo il rilascio
+        }
+    }
+}
+
+void GameSimulation::updateGhosts(float dt) {
+    const sf::Vector2f pacPos = m_player.getPosition();
+    const sf::Vector2f pacDir = m_player.getDirection();
+    const std::uint64_t allocationsBefore = AllocationCounter::count();
+    for (size_t i = 0; i < m_ghosts.size(); ++i) {
+        if (auto* inky = dynamic_cast<Inky*>(m_ghosts[i].get())) {
+            inky->update(dt, m_map, m_tileSize, pacPos, pacDir, m_ghostMode, m_ghosts[0]->getPosition(), m_started);
+        } else if (auto* pinky = dynamic_cast<Pinky*>(m_ghosts[i].get())) {
+            pinky->update(dt, m_map, m_tileSize, pacPos, pacDir, m_ghostMode, m_started);
+        } else if (auto* clyde = dynamic_cast<Clyde*>(m_ghosts[i].get())) {
+            clyde->update(dt, m_map, m_tileSize, pacPos, pacDir, m_ghostMode, m_started);
+        } else {
+            m_ghosts[i]->update(dt, m_map, m_tileSize, pacPos, pacDir, m_ghostMode, m_started);
+        }
+    }
+    m_ghostUpdateAllocations += AllocationCounter::count() - allocationsBefore;
+}
+
+// Pac-Man mangia il pellet della sua cella quando il centro entra nel cerchio del pellet
+void GameSimulation::updatePellets() {
+    const sf::Vector2f pacPos = m_player.getPosition();
+    if (pacPos.x < 0.f || pacPos.y < 0.f)
+        return;
+    unsigned pacTileX = static_cast<unsigned>(pacPos.x / m_tileSize.x);
+    unsigned pacTileY = static_cast<unsigned>(pacPos.y / m_tileSize.y);
+    if (!m_pellets.has(pacTileX, pacTileY))
+        return;
+    sf::Vector2f center = m_pellets.tileCenter(pacTileX, pacTileY);
+    float r = m_pellets.getRadius();
+    if (std::abs(pacPos.x - center.x) > r || std::abs(pacPos.y - center.y) > r)
+        return;
+    m_pellets.eatAt(pacTileX, pacTileY);
+    addScore(10);
+    ++m_pelletsEatenCount;
+    m_events |= PelletEaten;
+    spawnFruits();
+}
+
+// Spawn frutti casuali al raggiungimento delle soglie (30 e 70 pellet)
+void GameSimulation::spawnFruits() {
+    auto spawnFruitAtRandomPellet = [&](Fruit::Type type) -> bool {
+        unsigned x, y;
+        if (!m_pellets.randomTile(m_rng, x, y))
+            return false;
+        m_fruits.emplace_back(m_pellets.tileCenter(x, y), type);
+        return true;
+    };
+    // Selezione pesata tra 4 tipi: Cherry 40%, Strawberry 30%, Mushroom 20%, Egg 10%
+    auto pickTypeWeighted = [&]() {
+        int r = static_cast<int>(m_rng() % 100) + 1; // portabile tra librerie standard (vedi PelletGrid::randomTile)
+        if (r <= 40) return Fruit::Type::Cherry;
+        if (r <= 70) return Fruit::Type::Strawberry;
+        if (r <= 90) return Fruit::Type::Mushroom;
+        return Fruit::Type::Egg;
+    };
+
+    if (!m_fruit30Spawned && m_pelletsEatenCount >= 30) {
+        Fruit::Type t = pickTypeWeighted();
+        if (spawnFruitAtRandomPellet(t)) {
+            m_fruit30Spawned = true;
+            m_firstFruitType = t;
+            m_firstFruitTypeSet = true;
+        }
+    }
+    if (!m_fruit70Spawned && m_pelletsEatenCount >= 70) {
+        Fruit::Type t = pickTypeWeighted();
+        // Evita duplicato rispetto al primo frutto del livello
+        if (m_firstFruitTypeSet) {
+            int guard = 0; // prevenzione loop infinito
+            while (t == m_firstFruitType && guard < 10) {
+                t = pickTypeWeighted();
+                ++guard;
+            }
+        }
+        if (spawnFruitAtRandomPellet(t))
+            m_fruit70Spawned = true;
+    }
+}
+
+void GameSimulation::updateFruits(float dt) {
+    const sf::Vector2f pacPos = m_player.getPosition();
+    for (auto itf = m_fruits.begin(); itf != m_fruits.end();) {
+        itf->update(dt);
+        if (itf->eaten(pacPos)) {
+            addScore(itf->getScore());
+            m_events |= FruitEaten;
+            itf = m_fruits.erase(itf);
+        } else if (itf->expired()) {
+            // Auto-despawn dopo 10s
+            itf = m_fruits.erase(itf);
+        } else {
+            ++itf;
+        }
+    }
+}
+
+void GameSimulation::updateSuperPellets() {
+    unsigned pacTileX = static_cast<unsigned>(m_player.getPosition().x / m_tileSize.x);
+    unsigned pacTileY = static_cast<unsigned>(m_player.getPosition().y / m_tileSize.y);
+    if (m_superPellets.eatAt(pacTileX, pacTileY)) {
+        m_events |= SuperPelletEaten;
+        // Attiva frightened SOLO per fantasmi già usciti
+        for (auto& g : m_ghosts) {
+            if (g->isReleased())
+                g->setFrightened(m_frightenedBaseDuration);
+        }
+    }
+}
+
+void GameSimulation::updateGhostCollisions() {
+    static const int ghostScores[] = {200, 400, 800, 1600};
+    for (size_t i = 0; i < m_ghosts.size() && !m_player.isDying(); ++i) {
+        const auto& ghost = m_ghosts[i];
+        sf::Vector2f d = m_player.getPosition() - ghost->getPosition();
+        float minDist = 24.f * 24.f; // raggio Pac-Man + raggio Ghost (approssimato)
+        if (d.x * d.x + d.y * d.y >= minDist)
+            continue;
+        if (ghost->isFrightened() && !ghost->isEaten()) {
+            ghost->setEaten(true);
+            // Combo: 200, 400, 800, 1600
+            m_ghostEatScore = ghostScores[std::min(m_ghostEatCombo, 3)];
+            addScore(m_ghostEatScore);
+            m_ghostEatCombo++;
+            m_ghostEatPauseTimer = GHOST_EAT_PAUSE;
+            m_events |= GhostEaten;
+        } else if (!ghost->isEaten() && !ghost->isReturningToHouse()) {
+            m_player.startDeathAnimation();
+            m_events |= PlayerDied;
+        }
+    }
+}
+
+void GameSimulation::completeLevel() {
+    m_currentLevel++;
+    if (m_currentLevel >= int(m_config.mapFiles.size())) {
+        // Tutte le mappe completate: ricomincia dalla prima con difficoltà aumentata
+        m_difficultyLevel++;
+        m_currentLevel = 0;
+        applyDifficulty();
+        m_events |= AllLevelsCompleted;
+    } else {
+        m_events |= LevelCompleted;
+    }
+    loadLevel(m_currentLevel);
+}
+
+void GameSimulation::handleDeathFinished() {
+    m_player.resetDeathAnimation();
+    m_player.loseLife();
+    if (m_player.getLives() <= 0) {
+        m_gameOver = true;
+        m_events |= GameOver;
+    } else {
+        // Ricarica il livello corrente SENZA resettare i pellet
+        loadLevel(m_currentLevel, false);
+        m_events |= LifeLost;
+    }
+}
+
+bool GameSimulation::anyGhostFrightened() const {
+    for (const auto& g : m_ghosts) {
+        if (g->isFrightened() && !g->isEaten())
+            return true;
+    }
+    return false;
+}
+
+bool GameSimulation::anyGhostReturning() const {
+    for (const auto& g : m_ghosts) {
+        if (g->isEaten() && g->isReturningToHouse())
+            return true;
+    }
+    return false;
+}
+
+void GameSimulation::snapPlayerToTile() {
+    sf::Vector2f p = m_player.getPosition();
+    unsigned cx = static_cast<unsigned>(p.x / m_tileSize.x);
+    unsigned cy = static_cast<unsigned>(p.y / m_tileSize.y);
+    m_player.setPosition(tileCenter(cx, cy, m_tileSize));
+    m_player.setDirection({0.f, 0.f});
+    if (m_recorder) {
+        m_recorder->recordSnap();
+    }
+}
+
+GameState GameSimulation::snapshot() const {
+    GameState state;
+    state.rng = m_rng;
+    state.seed = m_seed;
+    state.tick = m_tick;
+    state.accumulator = m_accumulator;
+    state.events = m_events;
+
+    state.positions = m_actorPositions;
+    state.player = m_player.getState();
+    state.ghostCount = static_cast<std::uint32_t>(std::min(m_ghosts.size(), GameState::MAX_GHOSTS));
+    for (std::size_t i = 0; i < state.ghostCount; ++i) {
+        state.ghosts[i] = m_ghosts[i]->getState();
+    }
+
+    m_pellets.saveState(state.pellets);
+    m_superPellets.saveState(state.superPellets);
+    state.fruitCount = static_cast<std::uint32_t>(std::min(m_fruits.size(), GameState::MAX_FRUITS));
+    for (std::size_t i = 0; i < state.fruitCount; ++i) {
+        state.fruits[i] = {m_fruits[i].getCenter(), m_fruits[i].getType(), m_fruits[i].getTimeAlive()};
+    }
+    state.pelletsEatenCount = m_pelletsEatenCount;
+    state.fruit30Spawned = m_fruit30Spawned;
+    state.fruit70Spawned = m_fruit70Spawned;
+    state.firstFruitTypeSet = m_firstFruitTypeSet;
+    state.firstFruitType = m_firstFruitType;
+
+    state.score = m_score;
+    state.extraLifeGiven = m_extraLifeGiven;
+    state.currentLevel = m_currentLevel;
+    state.difficultyLevel = m_difficultyLevel;
+    state.ghostBaseSpeed = m_ghostBaseSpeed;
+    state.frightenedBaseDuration = m_frightenedBaseDuration;
+    state.ghostRespawnDuration = m_ghostRespawnDuration;
+    std::copy(m_ghostReleaseDelays.begin(), m_ghostReleaseDelays.end(), state.ghostReleaseDelays);
+
+    state.ghostMode = m_ghostMode;
+    state.modeTimer = m_modeTimer;
+    state.modePhase = m_modePhase;
+    state.nextGhostToRelease = m_nextGhostToRelease;
+    state.ghostReleaseTimer = m_ghostReleaseTimer;
+    state.ghostEatPauseTimer = m_ghostEatPauseTimer;
+    state.ghostEatCombo = m_ghostEatCombo;
+    state.ghostEatScore = m_ghostEatScore;
+
+    state.started = m_started;
+    state.gameOver = m_gameOver;
+    return state;
+}
+
+bool GameSimulation::restore(const GameState& state) {
+    // Mappa, griglie e fantasmi del livello dello snapshot (il loro stato si sovrascrive subito dopo)
+    if (state.currentLevel != m_loadedLevel && !loadLevel(state.currentLevel))
+        return false;
+
+    m_rng = state.rng;
+    m_seed = state.seed;
+    m_tick = state.tick;
+    m_accumulator = state.accumulator;
+    m_events = state.events;
+
+    m_actorPositions = state.positions;
+    m_player.setState(state.player);
+    for (std::size_t i = 0; i < state.ghostCount && i < m_ghosts.size(); ++i) {
+        m_ghosts[i]->setState(state.ghosts[i]);
+    }
+
+    m_pellets.restoreState(state.pellets);
+    m_superPellets.restoreState(state.superPellets);
+    // I frutti hanno sprite propri: si ricreano solo se non sono già quelli dello snapshot
+    bool sameFruits = m_fruits.size() == state.fruitCount;
+    for (std::size_t i = 0; sameFruits && i < state.fruitCount; ++i) {
+        sameFruits = m_fruits[i].getType() == state.fruits[i].type && m_fruits[i].getCenter() == state.fruits[i].center;
+    }
+    if (!sameFruits) {
+        m_fruits.clear();
+        for (std::size_t i = 0; i < state.fruitCount; ++i) {
+            m_fruits.emplace_back(state.fruits[i].center, state.fruits[i].type);
+        }
+    }
+    for (std::size_t i = 0; i < state.fruitCount; ++i) {
+        m_fruits[i].setTimeAlive(state.fruits[i].timeAlive);
+    }
+    m_pelletsEatenCount = state.pelletsEatenCount;
+    m_fruit30Spawned = state.fruit30Spawned;
+    m_fruit70Spawned = state.fruit70Spawned;
+    m_firstFruitTypeSet = state.firstFruitTypeSet;
+    m_firstFruitType = state.firstFruitType;
+
+    m_score = state.score;
+    m_extraLifeGiven = state.extraLifeGiven;
+    m_currentLevel = state.currentLevel;
+    m_difficultyLevel = state.difficultyLevel;
+    m_ghostBaseSpeed = state.ghostBaseSpeed;
+    m_frightenedBaseDuration = state.frightenedBaseDuration;
+    m_ghostRespawnDuration = state.ghostRespawnDuration;
+    std::copy(std::begin(state.ghostReleaseDelays), std::end(state.ghostReleaseDelays), m_ghostReleaseDelays.begin());
+
+    m_ghostMode = state.ghostMode;
+    m_modeTimer = state.modeTimer;
+    m_modePhase = state.modePhase;
+    m_nextGhostToRelease = state.nextGhostToRelease;
+    m_ghostReleaseTimer = state.ghostReleaseTimer;
+    m_ghostEatPauseTimer = state.ghostEatPauseTimer;
+    m_ghostEatCombo = state.ghostEatCombo;
+    m_ghostEatScore = state.ghostEatScore;
+
+    m_started = state.started;
+    m_gameOver = state.gameOver;
+    return true;
+}
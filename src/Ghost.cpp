@@ -1,25 +1,30 @@
 #include "Ghost.hpp"
+#include "SpriteSheet.hpp"
+#include "FlowField.hpp"
+#include "Logger.hpp"
 #include <cmath>
-#include <iostream>
-#include <algorithm> // for std::random_shuffle
-#include <random>
-#include <ctime>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 
 // =========================
 // Classe base Ghost
 // =========================
-// Contiene tutta la logica comune di movimento, pathfinding greedy, tunnel, ghost house, scatter/chase.
+// Contiene tutta la logica comune di movimento, pathfinding sui campi di flusso condivisi, tunnel, ghost house, scatter/chase.
 // Ogni fantasma ridefinisce solo il calcolo del target (e opzionalmente il pathfinding).
 // =========================
 
-Ghost::Ghost(const sf::Vector2f& pos, sf::Color color, float radius, Type type)
-    : m_shape(radius), m_direction(0, -1), m_speed(90.f), m_type(type), m_mode(Mode::Chase), 
+// Direzioni provate in frightened, prima del mescolamento (su, destra, giù, sinistra)
+static constexpr std::array<sf::Vector2f, 4> FRIGHTENED_DIRECTIONS = {{{0.f, -1.f}, {1.f, 0.f}, {0.f, 1.f}, {-1.f, 0.f}}};
+
+Ghost::Ghost(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos, sf::Color color, float radius, Type type)
+    : m_positions(&positions), m_slot(slot), m_radius(radius), m_color(color),
+      m_direction(0, -1), m_speed(90.f), m_type(type), m_mode(Mode::Chase), 
       m_drawPos(pos), m_hasLeftGhostHouse(false), m_eaten(false), m_isReturningToHouse(false),
       m_texture(nullptr), m_sprite(nullptr), m_hasTexture(false), m_animTime(0.f), m_animFrame(0)
 {
-    m_shape.setFillColor(color);
-    m_shape.setOrigin({radius, radius});
-    m_shape.setPosition(pos);
+    placeAt(pos);
+    m_prevDrawPos = pos;
     m_target = pos;
     // Imposta il delay di uscita classico
     switch (m_type) {
@@ -30,8 +35,8 @@ Ghost::Ghost(const sf::Vector2f& pos, sf::Color color, float radius, Type type)
     }
     m_canLeaveHouse = false;
     // Carica la texture e sprite come fallback generico (puoi personalizzare nei figli)
-    m_texture = std::make_unique<sf::Texture>();
-    if (m_texture->loadFromFile("assets/pacman.png")) {
+    m_texture = SpriteSheet::acquire();
+    if (m_texture) {
         m_sprite = std::make_unique<sf::Sprite>(*m_texture);
         m_sprite->setOrigin(sf::Vector2f{8.f, 8.f});
         float scale = radius / 8.f;
@@ -42,26 +47,84 @@ Ghost::Ghost(const sf::Vector2f& pos, sf::Color color, float radius, Type type)
     }
 }
 
+Ghost::State Ghost::getState() const {
+    State state;
+    state.direction = m_direction;
+    state.target = m_target;
+    state.drawPos = m_drawPos;
+    state.prevDrawPos = m_prevDrawPos;
+    state.speed = m_speed;
+    state.normalSpeed = m_normalSpeed;
+    state.mode = m_mode;
+    state.hasLeftGhostHouse = m_hasLeftGhostHouse;
+    state.isFrightened = m_isFrightened;
+    state.frightenedTimer = m_frightenedTimer;
+    state.frightenedDuration = m_frightenedDuration;
+    state.eaten = m_eaten;
+    state.isReturningToHouse = m_isReturningToHouse;
+    state.respawnTimer = m_respawnTimer;
+    state.respawnDuration = m_respawnDuration;
+    state.releaseDelay = m_releaseDelay;
+    state.canLeaveHouse = m_canLeaveHouse;
+    state.released = m_released;
+    state.rng = m_rng;
+    state.corridor = m_corridor;
+    state.corridorReverse = m_corridorReverse;
+    state.corridorProgress = m_corridorProgress;
+    state.corridorLength = m_corridorLength;
+    state.animTime = m_animTime;
+    state.animFrame = m_animFrame;
+    return state;
+}
+
+void Ghost::setState(const State& state) {
+    m_direction = state.direction;
+    m_target = state.target;
+    m_drawPos = state.drawPos;
+    m_prevDrawPos = state.prevDrawPos;
+    m_speed = state.speed;
+    m_normalSpeed = state.normalSpeed;
+    m_mode = state.mode;
+    m_hasLeftGhostHouse = state.hasLeftGhostHouse;
+    m_isFrightened = state.isFrightened;
+    m_frightenedTimer = state.frightenedTimer;
+    m_frightenedDuration = state.frightenedDuration;
+    m_eaten = state.eaten;
+    m_isReturningToHouse = state.isReturningToHouse;
+    m_respawnTimer = state.respawnTimer;
+    m_respawnDuration = state.respawnDuration;
+    m_releaseDelay = state.releaseDelay;
+    m_canLeaveHouse = state.canLeaveHouse;
+    m_released = state.released;
+    m_rng = state.rng;
+    m_corridor = state.corridor;
+    m_corridorReverse = state.corridorReverse;
+    m_corridorProgress = state.corridorProgress;
+    m_corridorLength = state.corridorLength;
+    m_animTime = state.animTime;
+    m_animFrame = state.animFrame;
+}
+
 void Ghost::update(float dt, const TileMap& map, const sf::Vector2u& tileSize, 
                   const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode, bool gameStarted) {
     // Blocca il fantasma finché non è rilasciato
     if (!m_released) {
-        m_drawPos = m_shape.getPosition();
+        m_drawPos = position();
         return;
     }
     // --- Ghost eaten/respawn logic: gestisci PRIMA di tutto ---
     if (m_isReturningToHouse) {
-        int houseX = 10, houseY = 10;
+        int houseX = map.getGhostHouseCenter().x, houseY = map.getGhostHouseCenter().y;
         sf::Vector2f houseCenter = {houseX * float(tileSize.x) + tileSize.x/2.f, houseY * float(tileSize.y) + tileSize.y/2.f};
-        sf::Vector2f pos = m_shape.getPosition();
+        sf::Vector2f pos = position();
         float distToHouse = std::hypot(pos.x - houseCenter.x, pos.y - houseCenter.y);
         if (distToHouse < tileSize.x * 1.0f) {
-            std::cout << "[GHOST] Arrived at ghost house, waiting to respawn.\n";
+            PACMUX_LOG_DEBUG("[GHOST] Arrived at ghost house, waiting to respawn.");
             m_isReturningToHouse = false;
             m_eaten = true;
             m_speed = 0.f;
             m_respawnTimer = 0.f;
-            m_shape.setPosition(houseCenter);
+            placeAt(houseCenter);
             m_drawPos = houseCenter;
             return;
         }
@@ -70,173 +133,154 @@ void Ghost::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
         float dist = std::hypot(delta.x, delta.y);
         if (dist > 0) {
             sf::Vector2f normalizedDelta = delta / dist;
-            m_shape.move(normalizedDelta * step);
+            moveBy(normalizedDelta * step);
         }
-        m_drawPos = m_shape.getPosition();
+        m_drawPos = position();
         return;
     }
     if (m_eaten) {
         m_respawnTimer += dt;
         if (m_respawnTimer >= m_respawnDuration) {
-            std::cout << "[GHOST] Respawn timer done, ghost leaves house.\n";
+            PACMUX_LOG_DEBUG("[GHOST] Respawn timer done, ghost leaves house.");
             m_eaten = false;
             m_speed = m_normalSpeed;
             m_isFrightened = false;
             m_direction = {0, -1};
             m_hasLeftGhostHouse = false; // deve uscire di nuovo!
-            m_shape.move(sf::Vector2f(0, -static_cast<float>(tileSize.y)));
-            m_drawPos = m_shape.getPosition();
+            moveBy(sf::Vector2f(0, -static_cast<float>(tileSize.y)));
+            m_drawPos = position();
         } else {
-            m_drawPos = m_shape.getPosition();
+            m_drawPos = position();
             return;
         }
     }
 
     m_mode = mode;
-    sf::Vector2f pos = m_shape.getPosition();
-    float cx = std::round((pos.x - tileSize.x/2.f) / tileSize.x);
-    float cy = std::round((pos.y - tileSize.y/2.f) / tileSize.y);
-    sf::Vector2f center{
-        cx * tileSize.x + tileSize.x/2.f,
-        cy * tileSize.y + tileSize.y/2.f
-    };
-    bool centered = (std::abs(pos.x - center.x) < 2.0f && std::abs(pos.y - center.y) < 2.0f);
-    int w = map.getSize().x, h = map.getSize().y;
 
     // Release logic is now handled in main.cpp cascade system
     // m_canLeaveHouse is set via setReleased() from main.cpp
     // Blocca il movimento dei fantasmi finché il gioco non è partito
     if (!gameStarted) {
-        m_drawPos = m_shape.getPosition();
+        m_drawPos = position();
         return;
     }
 
-    // Check ghost house status every frame (moved outside shouldUpdateDirection)
-    int sx = int(std::round(cx));
-    int sy = int(std::round(cy));
-    if (!m_hasLeftGhostHouse && !map.isGhostHouse(sx, sy) && m_canLeaveHouse) {
-        m_hasLeftGhostHouse = true;
-        std::cout << "[GHOST] " << Ghost::getTypeName(m_type) << " has left ghost house at (" << sx << "," << sy << ")!\n";
-    }
-    // Resetta solo se il fantasma è nella ghost house centrale (tile 10,10)
-    if (m_hasLeftGhostHouse && map.isGhostHouse(sx, sy) && !m_isReturningToHouse && sx == 10 && sy == 10) {
-        std::cout << "[GHOST] " << Ghost::getTypeName(m_type) << " re-entered ghost house at (" << sx << "," << sy << ")!\n";
-        m_hasLeftGhostHouse = false;
-    }
+    // Dentro un corridoio del grafo il fantasma avanza solo in pixel fino al prossimo incrocio:
+    // cella arrotondata e centratura servono solo fuori dal grafo (ghost house, aggancio, movimento per celle)
+    bool centered = false;
+    bool onGraph = m_hasLeftGhostHouse && m_corridor >= 0;
+    if (onGraph) {
+        travelGraph(dt, map, tileSize, pacmanPos, pacmanDirection);
+    } else {
+        sf::Vector2f pos = position();
+        float cx = std::round((pos.x - tileSize.x/2.f) / tileSize.x);
+        float cy = std::round((pos.y - tileSize.y/2.f) / tileSize.y);
+        sf::Vector2f center{
+            cx * tileSize.x + tileSize.x/2.f,
+            cy * tileSize.y + tileSize.y/2.f
+        };
+        centered = (std::abs(pos.x - center.x) < 2.0f && std::abs(pos.y - center.y) < 2.0f);
+        int w = map.getSize().x, h = map.getSize().y;
 
-    bool shouldUpdateDirection = centered && 
-                               ((m_direction.x == 0 && m_direction.y == -1) ||
-                               !canMove(m_direction, map, tileSize));
-    if (shouldUpdateDirection) {
-        // Uscita forzata dalla ghost house per tutti i fantasmi
-        sf::Vector2f target;
-        if (map.isGhostHouse(sx, sy)) {
-            // Solo se può uscire
-            if (m_canLeaveHouse) {
-                target = getGhostHouseExit(map, tileSize);
-            } else {
-                target = {sx * float(tileSize.x) + tileSize.x/2.f, sy * float(tileSize.y) + tileSize.y/2.f}; // resta fermo
-            }
-        } else if (m_mode == Mode::Scatter) {
-            switch (m_type) {
-                case Type::Blinky: target = {(w-1) * float(tileSize.x), 0}; break;
-                case Type::Pinky:  target = {0, 0}; break;
-                case Type::Inky:   target = {(w-1) * float(tileSize.x), (h-1) * float(tileSize.y)}; break;
-                case Type::Clyde:  target = {0, (h-1) * float(tileSize.y)}; break;
-            }
-            // sf::Vector2f pos = m_shape.getPosition();
-            // std::cout << "[SCATTER] " << Ghost::getTypeName(m_type) << " Target: (" << target.x << ", " << target.y << ") Pos: (" << pos.x << ", " << pos.y << ")" << std::endl;
-        } else {
-            target = calculateTarget(pacmanPos, pacmanDirection, map, tileSize);
+        // Stato della ghost house (fuori dal grafo: i corridoi non passano dalla ghost house)
+        int sx = int(std::round(cx));
+        int sy = int(std::round(cy));
+        if (!m_hasLeftGhostHouse && !map.isGhostHouse(sx, sy) && m_canLeaveHouse) {
+            m_hasLeftGhostHouse = true;
+            PACMUX_LOG_DEBUG("[GHOST] %s has left ghost house at (%d,%d)!", Ghost::getTypeName(m_type), sx, sy);
         }
-        m_direction = findPath(target, map, tileSize);
-    }
-    // Movimento e gestione tunnel
-    int nextX = int(std::round(cx + m_direction.x));
-    int nextY = int(std::round(cy + m_direction.y));
-    bool validMove = true;
-    
-    // Gestione tunnel automatica: rileva tunnel secondo la regola specifica
-    if (nextY >= 0 && nextY < h) {
-        if (nextX < 0) {
-            // Controlla se è un tunnel valido a sinistra
-            bool isTunnel = (map.getData()[nextY][0] == '2');
-            if (nextY > 0) isTunnel = isTunnel && (map.getData()[nextY-1][0] == '1');
-            if (nextY < h-1) isTunnel = isTunnel && (map.getData()[nextY+1][0] == '1');
-            
-            if (isTunnel) {
-                nextX = w - 1; // Tunnel: entra dal lato destro
-            }
-        } else if (nextX >= w) {
-            // Controlla se è un tunnel valido a destra
-            bool isTunnel = (map.getData()[nextY][w-1] == '2');
-            if (nextY > 0) isTunnel = isTunnel && (map.getData()[nextY-1][w-1] == '1');
-            if (nextY < h-1) isTunnel = isTunnel && (map.getData()[nextY+1][w-1] == '1');
-            
-            if (isTunnel) {
-                nextX = 0; // Tunnel: entra dal lato sinistro
-            }
+        // Resetta solo se il fantasma è nella cella centrale della ghost house
+        if (m_hasLeftGhostHouse && map.isGhostHouse(sx, sy) && !m_isReturningToHouse &&
+            sx == int(map.getGhostHouseCenter().x) && sy == int(map.getGhostHouseCenter().y)) {
+            PACMUX_LOG_DEBUG("[GHOST] %s re-entered ghost house at (%d,%d)!", Ghost::getTypeName(m_type), sx, sy);
+            m_hasLeftGhostHouse = false;
         }
-    }
-    
-    // Dopo la gestione tunnel, controlla i limiti
-    if (nextX < 0 || nextX >= w) validMove = false;
-    if (nextY < 0 || nextY >= h) validMove = false;
-    if (validMove && canMove(m_direction, map, tileSize)) {
-        sf::Vector2f dest{nextX * float(tileSize.x) + tileSize.x/2.f, nextY * float(tileSize.y) + tileSize.y/2.f};
-        sf::Vector2f delta = dest - m_shape.getPosition();
-        float step = m_speed * dt;
-        if (std::hypot(delta.x, delta.y) <= step) {
-            m_shape.setPosition(dest);
+
+        // Il movimento per celle resta per la ghost house e per arrivare al centro della prima cella dopo l'uscita
+        if (!m_hasLeftGhostHouse) m_corridor = -1;
+        onGraph = m_hasLeftGhostHouse && centered && attachToGraph(map, tileSize, pacmanPos, pacmanDirection);
+        if (onGraph) {
+            travelGraph(dt, map, tileSize, pacmanPos, pacmanDirection);
         } else {
-            float deltaLen = std::hypot(delta.x, delta.y);
-            if (deltaLen > 0) {
-                sf::Vector2f normalizedDelta = delta / deltaLen;
-                m_shape.move(normalizedDelta * step);
-            }
-        }
-        // Tunnel teleport automatico: rileva tunnel secondo la regola specifica
-        float mapWidth = map.getSize().x * tileSize.x;
-        sf::Vector2f currentPos = m_shape.getPosition();
-        int currentTileY = static_cast<int>(currentPos.y / tileSize.y);
-        
-        // Controlla se la riga corrente è un tunnel valido
-        if (currentTileY >= 0 && currentTileY < h) {
-            bool isTunnel = (map.getData()[currentTileY][0] == '2' && map.getData()[currentTileY][w-1] == '2');
-            if (currentTileY > 0) {
-                isTunnel = isTunnel && (map.getData()[currentTileY-1][0] == '1' && map.getData()[currentTileY-1][w-1] == '1');
+            bool shouldUpdateDirection = centered && 
+                                       ((m_direction.x == 0 && m_direction.y == -1) ||
+                                       !canMove(m_direction, map, tileSize));
+            if (shouldUpdateDirection) {
+                // Uscita forzata dalla ghost house per tutti i fantasmi
+                sf::Vector2f target;
+                if (map.isGhostHouse(sx, sy)) {
+                    // Solo se può uscire
+                    if (m_canLeaveHouse) {
+                        target = getGhostHouseExit(map, tileSize);
+                    } else {
+                        target = {sx * float(tileSize.x) + tileSize.x/2.f, sy * float(tileSize.y) + tileSize.y/2.f}; // resta fermo
+                    }
+                } else if (m_mode == Mode::Scatter) {
+                    target = scatterTarget(map, tileSize);
+                    // sf::Vector2f pos = position();
+                    // std::cout << "[SCATTER] " << Ghost::getTypeName(m_type) << " Target: (" << target.x << ", " << target.y << ") Pos: (" << pos.x << ", " << pos.y << ")" << std::endl;
+                } else {
+                    target = calculateTarget(pacmanPos, pacmanDirection, map, tileSize);
+                }
+                m_direction = findPath(target, map, tileSize);
             }
-            if (currentTileY < h-1) {
-                isTunnel = isTunnel && (map.getData()[currentTileY+1][0] == '1' && map.getData()[currentTileY+1][w-1] == '1');
+            // Movimento e gestione tunnel
+            int nextX = int(std::round(cx + m_direction.x));
+            int nextY = int(std::round(cy + m_direction.y));
+            bool validMove = true;
+    
+            // Gestione tunnel: oltre il bordo di una riga tunnel si entra dal lato opposto
+            if (map.isTunnelRow(nextY)) {
+                if (nextX < 0) nextX = w - 1;
+                else if (nextX >= w) nextX = 0;
             }
-            
-            if (isTunnel) {
-                if (currentPos.x < 0) {
-                    m_shape.setPosition({mapWidth - tileSize.x/2.f, currentPos.y});
-                } else if (currentPos.x >= mapWidth) {
-                    m_shape.setPosition({tileSize.x/2.f, currentPos.y});
+    
+            // Dopo la gestione tunnel, controlla i limiti
+            if (nextX < 0 || nextX >= w) validMove = false;
+            if (nextY < 0 || nextY >= h) validMove = false;
+            if (validMove && canMove(m_direction, map, tileSize)) {
+                // Destinazione nella cella adiacente "virtuale" (anche fuori mappa nei tunnel):
+                // il teleport sotto riporta il fantasma dall'altro lato appena supera il bordo
+                int destX = int(std::round(cx + m_direction.x));
+                int destY = int(std::round(cy + m_direction.y));
+                sf::Vector2f dest{destX * float(tileSize.x) + tileSize.x/2.f, destY * float(tileSize.y) + tileSize.y/2.f};
+                sf::Vector2f delta = dest - position();
+                float step = m_speed * dt;
+                if (std::hypot(delta.x, delta.y) <= step) {
+                    placeAt(dest);
+                } else {
+                    float deltaLen = std::hypot(delta.x, delta.y);
+                    if (deltaLen > 0) {
+                        sf::Vector2f normalizedDelta = delta / deltaLen;
+                        moveBy(normalizedDelta * step);
+                    }
                 }
+                // Tunnel teleport automatico
+                float mapWidth = map.getSize().x * tileSize.x;
+                sf::Vector2f currentPos = position();
+                if (map.isTunnelRow(static_cast<int>(currentPos.y / tileSize.y))) {
+                    if (currentPos.x < 0) {
+                        placeAt({mapWidth - tileSize.x/2.f, currentPos.y});
+                    } else if (currentPos.x >= mapWidth) {
+                        placeAt({tileSize.x/2.f, currentPos.y});
+                    }
+                }
+            } else {
+                // Se bloccato, forza aggiornamento direzione
+                int sx = int(std::round(cx));
+                int sy = int(std::round(cy));
+                sf::Vector2f target;
+                if (m_mode == Mode::Scatter) {
+                    target = scatterTarget(map, tileSize);
+                } else {
+                    target = calculateTarget(pacmanPos, pacmanDirection, map, tileSize);
+                }
+                m_direction = findPath(target, map, tileSize);
+                if (m_direction == sf::Vector2f(0,0)) m_direction = {0, -1};
             }
         }
-    } else {
-        // Se bloccato, forza aggiornamento direzione
-        int sx = int(std::round(cx));
-        int sy = int(std::round(cy));
-        sf::Vector2f target;
-        if (m_mode == Mode::Scatter) {
-            switch (m_type) {
-                case Type::Blinky: target = {(w-1) * float(tileSize.x), 0}; break;
-                case Type::Pinky:  target = {0, 0}; break;
-                case Type::Inky:   target = {(w-1) * float(tileSize.x), (h-1) * float(tileSize.y)}; break;
-                case Type::Clyde:  target = {0, (h-1) * float(tileSize.y)}; break;
-            }
-        } else {
-            target = calculateTarget(pacmanPos, pacmanDirection, map, tileSize);
-        }
-        m_direction = findPath(target, map, tileSize);
-        if (m_direction == sf::Vector2f(0,0)) m_direction = {0, -1};
     }
-    m_drawPos = m_shape.getPosition();
+    m_drawPos = position();
 
     // --- Frightened mode logic ---
     if (m_isFrightened) {
@@ -258,11 +302,14 @@ void Ghost::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
         m_animTime = 0.f;
     }
 
-    // If frightened, move randomly at intersections
-    if (m_isFrightened && centered) {
-        std::vector<sf::Vector2f> directions = {{0,-1}, {1,0}, {0,1}, {-1,0}};
-        // Shuffle directions for randomness (C++17+)
-        std::shuffle(directions.begin(), directions.end(), std::default_random_engine(static_cast<unsigned>(std::time(nullptr))));
+    // If frightened, move randomly at intersections (sul grafo la scelta è in chooseCorridor)
+    if (m_isFrightened && centered && !onGraph) {
+        std::array<sf::Vector2f, 4> directions = FRIGHTENED_DIRECTIONS; // copia sullo stack, nessuna allocazione
+        // Ordine casuale dal generatore del fantasma (seme dalla simulazione).
+        // Fisher-Yates esplicito: std::shuffle dipende dalla libreria standard e romperebbe i replay tra compilatori
+        for (std::size_t i = directions.size() - 1; i > 0; --i) {
+            std::swap(directions[i], directions[m_rng() % (i + 1)]);
+        }
         for (const auto& dir : directions) {
             bool isReverse = (dir + m_direction == sf::Vector2f(0,0) && m_direction != sf::Vector2f(0,0));
             if (canMove(dir, map, tileSize) && !isReverse) {
@@ -274,19 +321,19 @@ void Ghost::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
 
     // --- Ghost eaten/respawn logic ---
     if (m_isReturningToHouse) {
-        // Move towards ghost house center (e.g., tile 10,10)
-        int houseX = 10, houseY = 10;
+        // Move towards ghost house center (TileMap::getGhostHouseCenter)
+        int houseX = map.getGhostHouseCenter().x, houseY = map.getGhostHouseCenter().y;
         sf::Vector2f houseCenter = {houseX * float(tileSize.x) + tileSize.x/2.f, houseY * float(tileSize.y) + tileSize.y/2.f};
-        sf::Vector2f pos = m_shape.getPosition();
+        sf::Vector2f pos = position();
         float distToHouse = std::hypot(pos.x - houseCenter.x, pos.y - houseCenter.y);
         if (distToHouse < tileSize.x * 1.0f) {
             // Arrived at ghost house
-            std::cout << "[GHOST] Arrived at ghost house, waiting to respawn.\n";
+            PACMUX_LOG_DEBUG("[GHOST] Arrived at ghost house, waiting to respawn.");
             m_isReturningToHouse = false;
             m_eaten = true;
             m_speed = 0.f;
             m_respawnTimer = 0.f;
-            m_shape.setPosition(houseCenter);
+            placeAt(houseCenter);
             m_drawPos = houseCenter;
             return;
         }
@@ -296,26 +343,26 @@ void Ghost::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
         float dist = std::hypot(delta.x, delta.y);
         if (dist > 0) {
             sf::Vector2f normalizedDelta = delta / dist;
-            m_shape.move(normalizedDelta * step);
+            moveBy(normalizedDelta * step);
         }
-        m_drawPos = m_shape.getPosition();
+        m_drawPos = position();
         return;
     }
     if (m_eaten) {
         // Wait in ghost house, then respawn
         m_respawnTimer += dt;
         if (m_respawnTimer >= m_respawnDuration) {
-            std::cout << "[GHOST] Respawn timer done, ghost leaves house.\n";
+            PACMUX_LOG_DEBUG("[GHOST] Respawn timer done, ghost leaves house.");
             m_eaten = false;
             m_speed = m_normalSpeed;
             m_isFrightened = false;
             m_direction = {0, -1};
             m_hasLeftGhostHouse = false; // deve uscire di nuovo!
             // Place just outside ghost house
-            m_shape.move(sf::Vector2f(0, -static_cast<float>(tileSize.y)));
-            m_drawPos = m_shape.getPosition();
+            moveBy(sf::Vector2f(0, -static_cast<float>(tileSize.y)));
+            m_drawPos = position();
         } else {
-            m_drawPos = m_shape.getPosition();
+            m_drawPos = position();
             return;
         }
     }
@@ -326,86 +373,113 @@ void Ghost::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
 // Sostituisci i valori con le coordinate reali della tua sprite sheet
 // Esempio: BLINKY_FRAMES[LEFT][0] = frame sinistra, animazione 1
 //          BLINKY_FRAMES[LEFT][1] = frame sinistra, animazione 2
-static const sf::IntRect BLINKY_FRAMES[4][2] = {
+const sf::IntRect BLINKY_FRAMES[4][2] = {
     { sf::IntRect(sf::Vector2i{100,566}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{117,566}, sf::Vector2i{16,16}) },   // SINISTRA
     { sf::IntRect(sf::Vector2i{134,566}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{151,566}, sf::Vector2i{16,16}) }, // SU
     { sf::IntRect(sf::Vector2i{168,566}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{185,566}, sf::Vector2i{16,16}) }, // DESTRA
     { sf::IntRect(sf::Vector2i{202,566}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{219,566}, sf::Vector2i{16,16}) }  // GIÙ
 };
-static const sf::IntRect PINKY_FRAMES[4][2] = {
+const sf::IntRect PINKY_FRAMES[4][2] = {
     { sf::IntRect(sf::Vector2i{100,583}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{117,583}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{134,583}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{151,583}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{168,583}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{185,583}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{202,583}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{219,583}, sf::Vector2i{16,16}) }
 };
-static const sf::IntRect INKY_FRAMES[4][2] = {
+const sf::IntRect INKY_FRAMES[4][2] = {
     { sf::IntRect(sf::Vector2i{100,600}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{117,600}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{134,600}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{151,600}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{168,600}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{185,600}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{202,600}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{219,600}, sf::Vector2i{16,16}) }
 };
-static const sf::IntRect CLYDE_FRAMES[4][2] = {
+const sf::IntRect CLYDE_FRAMES[4][2] = {
     { sf::IntRect(sf::Vector2i{100,617}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{117,617}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{134,617}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{151,617}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{168,617}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{185,617}, sf::Vector2i{16,16}) },
     { sf::IntRect(sf::Vector2i{202,617}, sf::Vector2i{16,16}), sf::IntRect(sf::Vector2i{219,617}, sf::Vector2i{16,16}) }
 };
-static const sf::IntRect FRIGHTENED_FRAMES[2] = {
+const sf::IntRect FRIGHTENED_FRAMES[2] = {
     sf::IntRect(sf::Vector2i{389,566}, sf::Vector2i{16,16}), // blu
     sf::IntRect(sf::Vector2i{406,566}, sf::Vector2i{16,16})  
 };
 // Nuovo: array per le texture bianche degli ultimi 2 secondi frightened
-static const sf::IntRect FRIGHTENED_WHITE_FRAMES[2] = {
+const sf::IntRect FRIGHTENED_WHITE_FRAMES[2] = {
     sf::IntRect(sf::Vector2i{390,746}, sf::Vector2i{16,16}), // bianco 1 (nuova texture, da sprite sheet)
     sf::IntRect(sf::Vector2i{406,746}, sf::Vector2i{16,16})  // bianco 2 (nuova texture, da sprite sheet)
 };
-static const sf::IntRect EYES_FRAMES[4] = {
+const sf::IntRect EYES_FRAMES[4] = {
     sf::IntRect(sf::Vector2i{389,583}, sf::Vector2i{16,16}), // sinistra
     sf::IntRect(sf::Vector2i{406,583}, sf::Vector2i{16,16}), // su
     sf::IntRect(sf::Vector2i{423,583}, sf::Vector2i{16,16}), // destra
     sf::IntRect(sf::Vector2i{440,583}, sf::Vector2i{16,16})  // giù
 };
-static constexpr float GHOST_ANIMATION_INTERVAL = 0.12f; // secondi tra un frame e l'altro
+const float GHOST_ANIMATION_INTERVAL = 0.12f; // secondi tra un frame e l'altro
+
+const sf::Sprite* Ghost::currentSprite() const {
+    // --- ANIMAZIONE SPRITE: usa sprite membro se presente, fallback cerchio ---
+    if (!m_sprite || !m_hasTexture) return nullptr;
+    m_sprite->setPosition(renderPosition());
+    if (m_eaten || m_isReturningToHouse) {
+        int dirIdx = 0;
+        if (m_direction.x < 0) dirIdx = 0; // sinistra
+        else if (m_direction.y < 0) dirIdx = 1; // su
+        else if (m_direction.x > 0) dirIdx = 2; // destra
+        else if (m_direction.y > 0) dirIdx = 3; // giù
+        m_sprite->setTextureRect(EYES_FRAMES[dirIdx]);
+    } else if (m_isFrightened) {
+        // RIMOSSO lampeggiamento: la logica frightened/blink è ora solo nei figli
+        m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
+    } else {
+        // Fantasma normale: fallback, puoi personalizzare per ogni tipo
+        int dirIdx = 2;
+        if (m_direction.x < 0) dirIdx = 0;
+        else if (m_direction.x > 0) dirIdx = 2;
+        else if (m_direction.y < 0) dirIdx = 1;
+        else if (m_direction.y > 0) dirIdx = 3;
+        // Usa BLINKY_FRAMES come default, override nei figli
+        m_sprite->setTextureRect(BLINKY_FRAMES[dirIdx][0]);
+    }
+    return m_sprite.get();
+}
 
 void Ghost::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     states.transform *= getTransform();
-    // --- ANIMAZIONE SPRITE: usa sprite membro se presente, fallback cerchio ---
-    if (m_sprite && m_hasTexture) {
-        m_sprite->setPosition(m_drawPos);
-        if (m_eaten || m_isReturningToHouse) {
-            int dirIdx = 0;
-            if (m_direction.x < 0) dirIdx = 0; // sinistra
-            else if (m_direction.y < 0) dirIdx = 1; // su
-            else if (m_direction.x > 0) dirIdx = 2; // destra
-            else if (m_direction.y > 0) dirIdx = 3; // giù
-            m_sprite->setTextureRect(EYES_FRAMES[dirIdx]);
-        } else if (m_isFrightened) {
-            // RIMOSSO lampeggiamento: la logica frightened/blink è ora solo nei figli
-            m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
-        } else {
-            // Fantasma normale: fallback, puoi personalizzare per ogni tipo
-            int dirIdx = 2;
-            if (m_direction.x < 0) dirIdx = 0;
-            else if (m_direction.x > 0) dirIdx = 2;
-            else if (m_direction.y < 0) dirIdx = 1;
-            else if (m_direction.y > 0) dirIdx = 3;
-            // Usa BLINKY_FRAMES come default, override nei figli
-            m_sprite->setTextureRect(BLINKY_FRAMES[dirIdx][0]);
-        }
-        target.draw(*m_sprite, states);
+    if (const sf::Sprite* sprite = currentSprite()) {
+        target.draw(*sprite, states);
         return;
     }
     // Fallback: disegna il cerchio se non hai sprite
-    sf::CircleShape shape = m_shape;
-    shape.setPosition(m_drawPos);
+    sf::CircleShape shape(m_radius);
+    shape.setFillColor(m_color);
+    shape.setOrigin({m_radius, m_radius});
+    shape.setPosition(renderPosition());
     target.draw(shape, states);
 }
 
+sf::Vector2f Ghost::renderPosition() const {
+    const sf::Vector2f delta = m_drawPos - m_prevDrawPos;
+    // Salto più lungo del diametro: teletrasporto (tunnel, respawn), disegna direttamente la posizione nuova
+    const float maxStep = 2.f * m_radius;
+    if (std::abs(delta.x) > maxStep || std::abs(delta.y) > maxStep)
+        return m_drawPos;
+    return m_prevDrawPos + delta * m_renderAlpha;
+}
+
+void Ghost::appendTo(SpriteBatch& batch, const sf::Transform& transform) const {
+    const sf::Transform t = transform * getTransform();
+    if (const sf::Sprite* sprite = currentSprite()) {
+        batch.add(*sprite, t);
+    } else {
+        batch.addCircle(renderPosition(), m_radius, m_color, t);
+    }
+}
+
 void Ghost::setPosition(const sf::Vector2f& pos) {
-    m_shape.setPosition(pos);
+    placeAt(pos);
     m_direction = {0, -1};
     m_drawPos = pos;
+    m_prevDrawPos = pos;
     m_hasLeftGhostHouse = false;
+    m_corridor = -1;
 }
 
 void Ghost::setFrightened(float duration) {
@@ -424,6 +498,10 @@ void Ghost::setFrightened(float duration) {
     m_speed = 60.f; // slower when frightened
     // Reverse direction
     m_direction = {-m_direction.x, -m_direction.y};
+    if (m_corridor >= 0 && m_corridorReverse >= 0) {
+        std::swap(m_corridor, m_corridorReverse);
+        m_corridorProgress = m_corridorLength - m_corridorProgress;
+    }
 }
 
 void Ghost::setEaten(bool eaten) {
@@ -433,98 +511,59 @@ void Ghost::setEaten(bool eaten) {
         m_isReturningToHouse = true;
         m_speed = 180.f; // fast return to house
         m_respawnTimer = 0.f;
-        std::cout << "[GHOST] EATEN! Returning to ghost house as eyes.\n";
+        m_corridor = -1; // gli occhi tornano in linea retta, fuori dal grafo
+        PACMUX_LOG_DEBUG("[GHOST] EATEN! Returning to ghost house as eyes.");
     } else {
     m_eaten = false;
     m_isReturningToHouse = false;
     m_speed = m_normalSpeed;
-        std::cout << "[GHOST] Respawned, back to normal.\n";
+        PACMUX_LOG_DEBUG("[GHOST] Respawned, back to normal.");
     }
 }
 
-// Pathfinding greedy base: cerca la direzione che avvicina di più al target, evitando reverse se possibile
+// Pathfinding base: tra le direzioni percorribili sceglie quella il cui vicino è più vicino al target
+// secondo il campo di flusso verso il target (tunnel compresi), evitando il reverse se possibile
 sf::Vector2f Ghost::findPath(const sf::Vector2f& target, const TileMap& map, const sf::Vector2u& tileSize) {
-    sf::Vector2f pos = m_shape.getPosition();
+    sf::Vector2f bestDir = {0, -1};
+    if (!m_flowFields) return bestDir;
+    sf::Vector2f pos = position();
     int startX = int(std::round((pos.x - tileSize.x/2.f) / tileSize.x));
     int startY = int(std::round((pos.y - tileSize.y/2.f) / tileSize.y));
-    std::vector<sf::Vector2f> directions = {{0,-1}, {-1,0}, {0,1}, {1,0}};
-    float minDist = 1e9f;
-    sf::Vector2f bestDir = {0, -1};
+    int targetNode = map.nodeAt(int(std::floor(target.x / tileSize.x)), int(std::floor(target.y / tileSize.y)));
+    const FlowField& field = m_flowFields->toward(targetNode);
+    std::uint32_t minDist = 0;
     bool foundValidMove = false;
-    for (const auto& dir : directions) {
-        bool isReverse = (dir + m_direction == sf::Vector2f(0,0) && m_direction != sf::Vector2f(0,0));
-        if (canMove(dir, map, tileSize)) {
-            int nextX = startX + int(dir.x);
-            int nextY = startY + int(dir.y);
-            sf::Vector2f nextPos{nextX * float(tileSize.x) + tileSize.x/2.f, 
-                               nextY * float(tileSize.y) + tileSize.y/2.f};
-            float dist = std::hypot(target.x - nextPos.x, target.y - nextPos.y);
-            if (!isReverse && (!foundValidMove || dist < minDist)) {
+    for (int pass = 0; pass < 2 && !foundValidMove; ++pass) {
+        for (int d = 0; d < 4; ++d) {
+            sf::Vector2f dir{float(TileMap::DIR_DX[d]), float(TileMap::DIR_DY[d])};
+            bool isReverse = (dir + m_direction == sf::Vector2f(0,0) && m_direction != sf::Vector2f(0,0));
+            if (pass == 0 && isReverse) continue; // il reverse solo se non c'è altra scelta
+            int nextX, nextY;
+            if (!canMove(dir, map, tileSize) || !map.neighbor(startX, startY, d, nextX, nextY)) continue;
+            std::uint32_t dist = field.distance(map.nodeAt(nextX, nextY));
+            if (!foundValidMove || dist < minDist) {
                 minDist = dist;
                 bestDir = dir;
                 foundValidMove = true;
             }
         }
     }
-    if (!foundValidMove) {
-        for (const auto& dir : directions) {
-            if (canMove(dir, map, tileSize)) {
-                int nextX = startX + int(dir.x);
-                int nextY = startY + int(dir.y);
-                sf::Vector2f nextPos{nextX * float(tileSize.x) + tileSize.x/2.f, 
-                                   nextY * float(tileSize.y) + tileSize.y/2.f};
-                float dist = std::hypot(target.x - nextPos.x, target.y - nextPos.y);
-                if (!foundValidMove || dist < minDist) {
-                    minDist = dist;
-                    bestDir = dir;
-                    foundValidMove = true;
-                }
-            }
-        }
-    }
     return bestDir;
 }
 
 // Controlla se la direzione è valida (no muri, no ghost house dopo essere usciti, gestisce tunnel)
 bool Ghost::canMove(const sf::Vector2f& direction, const TileMap& map, const sf::Vector2u& tileSize) {
-    sf::Vector2f pos = m_shape.getPosition();
+    sf::Vector2f pos = position();
     float cx = std::round((pos.x - tileSize.x/2.f) / tileSize.x);
     float cy = std::round((pos.y - tileSize.y/2.f) / tileSize.y);
     int nextX = int(std::round(cx + direction.x));
     int nextY = int(std::round(cy + direction.y));
     int w = map.getSize().x, h = map.getSize().y;
     
-    // Gestione tunnel automatica: rileva tunnel secondo la regola specifica
-    if (nextY >= 0 && nextY < h) { // Assicurati che Y sia valido
-        if (nextX < 0) {
-            // Controlla se è un tunnel valido a sinistra:
-            // - Prima cella della riga corrente = '2'
-            // - Prima cella riga sopra = '1' (se esiste)
-            // - Prima cella riga sotto = '1' (se esiste)
-            bool isTunnel = (map.getData()[nextY][0] == '2');
-            if (nextY > 0) isTunnel = isTunnel && (map.getData()[nextY-1][0] == '1');
-            if (nextY < h-1) isTunnel = isTunnel && (map.getData()[nextY+1][0] == '1');
-            
-            if (isTunnel) {
-                nextX = w - 1; // Tunnel: entra dal lato destro
-            } else {
-                return false; // No tunnel disponibile
-            }
-        } else if (nextX >= w) {
-            // Controlla se è un tunnel valido a destra:
-            // - Ultima cella della riga corrente = '2'
-            // - Ultima cella riga sopra = '1' (se esiste)
-            // - Ultima cella riga sotto = '1' (se esiste)
-            bool isTunnel = (map.getData()[nextY][w-1] == '2');
-            if (nextY > 0) isTunnel = isTunnel && (map.getData()[nextY-1][w-1] == '1');
-            if (nextY < h-1) isTunnel = isTunnel && (map.getData()[nextY+1][w-1] == '1');
-            
-            if (isTunnel) {
-                nextX = 0; // Tunnel: entra dal lato sinistro
-            } else {
-                return false; // No tunnel disponibile
-            }
-        }
+    // Gestione tunnel: oltre il bordo si passa solo dalle righe tunnel
+    if (nextX < 0 || nextX >= w) {
+        if (!map.isTunnelRow(nextY)) return false; // No tunnel disponibile
+        nextX = (nextX < 0) ? w - 1 : 0;
     }
     
     // Dopo la gestione tunnel, controlla i limiti
@@ -536,7 +575,7 @@ bool Ghost::canMove(const sf::Vector2f& direction, const TileMap& map, const sf:
 
 // Trova la porta di uscita della ghost house: cerca verso l'alto, poi lateralmente se serve
 sf::Vector2f Ghost::getGhostHouseExit(const TileMap& map, const sf::Vector2u& tileSize) const {
-    sf::Vector2f pos = m_shape.getPosition();
+    sf::Vector2f pos = position();
     int x = int(std::round((pos.x - tileSize.x/2.f) / tileSize.x));
     int y = int(std::round((pos.y - tileSize.y/2.f) / tileSize.y));
     // Cerca verso l'alto
@@ -555,3 +594,139 @@ sf::Vector2f Ghost::getGhostHouseExit(const TileMap& map, const sf::Vector2u& ti
     // Fallback: ritorna la posizione attuale
     return pos;
 }
+
+sf::Vector2f Ghost::scatterTarget(const TileMap& map, const sf::Vector2u& tileSize) const {
+    int w = map.getSize().x, h = map.getSize().y;
+    switch (m_type) {
+        case Type::Blinky: return {(w-1) * float(tileSize.x), 0};
+        case Type::Pinky:  return {0, 0};
+        case Type::Inky:   return {(w-1) * float(tileSize.x), (h-1) * float(tileSize.y)};
+        case Type::Clyde:  return {0, (h-1) * float(tileSize.y)};
+    }
+    return {0, 0};
+}
+
+// Indice (DIR_DX/DIR_DY) di una direzione unitaria, -1 se ferma
+static int directionIndex(const sf::Vector2f& dir) {
+    for (int d = 0; d < 4; ++d) {
+        if (dir.x == float(TileMap::DIR_DX[d]) && dir.y == float(TileMap::DIR_DY[d])) return d;
+    }
+    return -1;
+}
+
+static sf::Vector2f cellCenter(int tile, const TileMap& map, const sf::Vector2u& tileSize) {
+    int w = map.getSize().x;
+    return {(tile % w) * float(tileSize.x) + tileSize.x/2.f, (tile / w) * float(tileSize.y) + tileSize.y/2.f};
+}
+
+bool Ghost::attachToGraph(const TileMap& map, const sf::Vector2u& tileSize,
+                          const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection) {
+    sf::Vector2f pos = position();
+    int x = int(std::round((pos.x - tileSize.x/2.f) / tileSize.x));
+    int y = int(std::round((pos.y - tileSize.y/2.f) / tileSize.y));
+    int junction = map.junctionAt(x, y);
+    int corridor = -1, offset = 0;
+    if (junction < 0 && !map.corridorAt(x, y, corridor, offset)) return false;
+
+    placeAt(cellCenter(y * int(map.getSize().x) + x, map, tileSize));
+    if (junction >= 0) {
+        corridor = chooseCorridor(junction, map, tileSize, pacmanPos, pacmanDirection);
+        if (corridor < 0) return false;
+        enterCorridor(corridor, 0.f, map, tileSize);
+        placeOnCorridor(map, tileSize);
+        return true;
+    }
+    // A metà corridoio: si continua nel verso attuale se è lungo il corridoio (es. dopo setPosition),
+    // altrimenti (uscita dalla ghost house) si sceglie il verso come a un incrocio
+    const TileMap::Corridor& c = map.getCorridors()[corridor];
+    int d = directionIndex(m_direction);
+    if (d != c.dir && d != (c.dir + 2) % 4) {
+        d = directionIndex(decideDirection(map, tileSize, pacmanPos, pacmanDirection));
+    }
+    const float cell = (TileMap::DIR_DX[c.dir] != 0) ? float(tileSize.x) : float(tileSize.y);
+    if (d == (c.dir + 2) % 4 && c.reverse >= 0) {
+        enterCorridor(c.reverse, (c.length - offset) * cell, map, tileSize);
+    } else {
+        enterCorridor(corridor, offset * cell, map, tileSize);
+    }
+    placeOnCorridor(map, tileSize);
+    return true;
+}
+
+void Ghost::travelGraph(float dt, const TileMap& map, const sf::Vector2u& tileSize,
+                        const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection) {
+    float step = m_speed * dt;
+    // Più incroci nello stesso tick solo a velocità enormi: il limite evita di girare a vuoto
+    for (int hops = 0; hops < 4 && m_corridor >= 0; ++hops) {
+        if (m_corridorProgress + step < m_corridorLength) {
+            m_corridorProgress += step;
+            break;
+        }
+        // Arrivo all'incrocio: lo spazio che avanza prosegue sul corridoio scelto
+        step -= m_corridorLength - m_corridorProgress;
+        int junction = map.getCorridors()[m_corridor].to;
+        placeAt(cellCenter(map.getJunctions()[junction].tile, map, tileSize));
+        int next = chooseCorridor(junction, map, tileSize, pacmanPos, pacmanDirection);
+        if (next < 0) {
+            m_corridor = -1;
+            return;
+        }
+        enterCorridor(next, 0.f, map, tileSize);
+    }
+    placeOnCorridor(map, tileSize);
+}
+
+sf::Vector2f Ghost::decideDirection(const TileMap& map, const sf::Vector2u& tileSize,
+                                    const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection) {
+    if (m_isFrightened) {
+        std::array<sf::Vector2f, 4> directions = FRIGHTENED_DIRECTIONS;
+        // Stesso mescolamento del movimento per celle (Fisher-Yates esplicito, riproducibile)
+        for (std::size_t i = directions.size() - 1; i > 0; --i) {
+            std::swap(directions[i], directions[m_rng() % (i + 1)]);
+        }
+        for (const auto& dir : directions) {
+            bool isReverse = (dir + m_direction == sf::Vector2f(0,0) && m_direction != sf::Vector2f(0,0));
+            if (canMove(dir, map, tileSize) && !isReverse) return dir;
+        }
+        return {-m_direction.x, -m_direction.y};
+    }
+    sf::Vector2f target = (m_mode == Mode::Scatter) ? scatterTarget(map, tileSize)
+                                                    : calculateTarget(pacmanPos, pacmanDirection, map, tileSize);
+    return findPath(target, map, tileSize);
+}
+
+int Ghost::chooseCorridor(int junction, const TileMap& map, const sf::Vector2u& tileSize,
+                          const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection) {
+    const std::int16_t* exits = map.getJunctions()[junction].exits;
+    int current = directionIndex(m_direction);
+    int reverse = current >= 0 ? (current + 2) % 4 : -1;
+    int d = directionIndex(decideDirection(map, tileSize, pacmanPos, pacmanDirection));
+    if (d >= 0 && d != reverse && exits[d] >= 0) return exits[d];
+    // Direzione non disponibile (es. nessun campo di flusso): prima uscita utile, il reverse per ultimo
+    for (int i = 0; i < 4; ++i) {
+        if (i != reverse && exits[i] >= 0) return exits[i];
+    }
+    return reverse >= 0 ? exits[reverse] : -1;
+}
+
+void Ghost::enterCorridor(int corridor, float progress, const TileMap& map, const sf::Vector2u& tileSize) {
+    const TileMap::Corridor& c = map.getCorridors()[corridor];
+    const float cell = (TileMap::DIR_DX[c.dir] != 0) ? float(tileSize.x) : float(tileSize.y);
+    m_corridor = corridor;
+    m_corridorReverse = c.reverse;
+    m_corridorProgress = progress;
+    m_corridorLength = c.length * cell;
+}
+
+void Ghost::placeOnCorridor(const TileMap& map, const sf::Vector2u& tileSize) {
+    const TileMap::Corridor& c = map.getCorridors()[m_corridor];
+    m_direction = {float(TileMap::DIR_DX[c.dir]), float(TileMap::DIR_DY[c.dir])};
+    sf::Vector2f pos = cellCenter(map.getJunctions()[c.from].tile, map, tileSize) + m_direction * m_corridorProgress;
+    if (c.tunnel) {
+        // Oltre il bordo si rientra dal lato opposto
+        const float mapWidth = map.getSize().x * float(tileSize.x);
+        pos.x = std::fmod(pos.x, mapWidth);
+        if (pos.x < 0.f) pos.x += mapWidth;
+    }
+    placeAt(pos);
+}
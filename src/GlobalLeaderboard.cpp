@@ -1,4 +1,7 @@
 #include "GlobalLeaderboard.hpp"
+#include "TraceRecorder.hpp"
+#include "Logger.hpp"
+#include "TextCache.hpp"
 #include <cpr/cpr.h>
 #include <sstream>
 #include <thread>
@@ -18,17 +21,14 @@ const std::string GlobalLeaderboard::JSONBIN_URL = "https://raw.githubuserconten
 const std::string GlobalLeaderboard::JSONBIN_API_KEY = ""; // Token embedded nel costruttore
 
 GlobalLeaderboard::GlobalLeaderboard(const std::string& fontFile)
-    : m_status(Status::Idle)
+    : m_font(TextCache::instance().font(fontFile)), // lancia eccezione se il font non si carica
+      m_status(Status::Idle)
 {
-    if (!m_font.openFromFile(fontFile)) {
-        throw std::runtime_error("Cannot load font: " + fontFile);
-    }
-    
     // Carica il token da variabile d'ambiente o embedded
     const char* token = std::getenv("GITHUB_TOKEN");
     if (token) {
         m_apiToken = token;
-        std::cout << "GitHub token loaded from environment variable." << std::endl;
+        PACMUX_LOG_INFO("GitHub token loaded from environment variable.");
     } else {
         // Token embedded (spezzato per evitare GitHub security scanning)
         // Sostituisci con il token del tuo account secondario
@@ -37,7 +37,7 @@ GlobalLeaderboard::GlobalLeaderboard(const std::string& fontFile)
         std::string part3 = "GIMq4453Sef";
         
         m_apiToken = part1 + part2 + part3;
-        std::cout << "Using embedded GitHub token from secondary account." << std::endl;
+        PACMUX_LOG_INFO("Using embedded GitHub token from secondary account.");
     }
 }
 
@@ -76,6 +76,8 @@ void GlobalLeaderboard::startUpload(const GlobalEntry& entry) {
 
     // Operazione asincrona per GitHub
     m_uploadFuture = std::async(std::launch::async, [this, entry]() -> bool {
+        TraceRecorder::setThreadName("leaderboard");
+        TraceRecorder::Scope trace("leaderboard upload", "net");
         try {
             // Prima scarica i dati esistenti dal Gist
             std::string currentData = httpGetGist();
@@ -127,6 +129,8 @@ void GlobalLeaderboard::downloadLeaderboard() {
     
     // Operazione asincrona per GitHub Gist
     m_downloadFuture = std::async(std::launch::async, [this]() -> bool {
+        TraceRecorder::setThreadName("leaderboard");
+        TraceRecorder::Scope trace("leaderboard download", "net");
         try {
             // std::cout << "[DEBUG] Starting download from GitHub..." << std::endl;
             if (m_cancelRequested.load()) return false;
@@ -1,18 +1,17 @@
 #include "HighScore.hpp"
+#include "Logger.hpp"
+#include "TextCache.hpp"
 #include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <iomanip>
-#include <iostream>
 
 // Costruttore: inizializza il font e il nome del file
 HighScore::HighScore(const std::string& fontFile)
-    : m_filename("highscores.json")
+    : m_font(TextCache::instance().font(fontFile)), // lancia eccezione se il font non si carica
+      m_filename("highscores.json")
 {
-    // Carica il font dal file, lancia eccezione se fallisce
-    if (!m_font.openFromFile(fontFile))
-        throw std::runtime_error("Cannot load font: " + fontFile);
 }
 
 // Carica i record dal file JSON
@@ -128,7 +127,7 @@ void HighScore::loadFromFile(const std::string& filename) {
     }
     catch (const std::exception& e) {
         // In caso di errore, inizializza con record predefiniti
-        std::cout << "Errore caricamento highscores: " << e.what() << std::endl;
+        PACMUX_LOG_ERROR("Errore caricamento highscores: %s", e.what());
         m_scores.clear();
         m_scores.push_back({"PAC-MAN", 50000, getCurrentDate()});
         m_scores.push_back({"BLINKY", 40000, getCurrentDate()});
@@ -169,7 +168,7 @@ void HighScore::saveToFile(const std::string& filename) const {
         // std::cout << "[DEBUG] File salvato con successo" << std::endl;
     }
     catch (const std::exception& e) {
-        std::cout << "Errore salvataggio highscores: " << e.what() << std::endl;
+        PACMUX_LOG_ERROR("Errore salvataggio highscores: %s", e.what());
     }
 }
 
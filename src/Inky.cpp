@@ -1,12 +1,13 @@
 #include "Inky.hpp"
 #include "Ghost.hpp"
 #include <cmath>
-#include <iostream>
+#include "Logger.hpp"
 
 // Inky: targeting collaborativo (Blinky + Pac-Man)
-Inky::Inky(const sf::Vector2f& pos) : Ghost(pos, sf::Color::Cyan, 12.0f, Type::Inky) {
-    m_texture = std::make_unique<sf::Texture>();
-    if (m_texture->loadFromFile("assets/pacman.png")) {
+Inky::Inky(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos)
+    : Ghost(positions, slot, pos, sf::Color::Cyan, 12.0f, Type::Inky) {
+    // Atlas condiviso già acquisito dal costruttore di Ghost
+    if (m_texture) {
         m_sprite = std::make_unique<sf::Sprite>(*m_texture);
         m_sprite->setTextureRect(INKY_FRAMES[2][0]); // frame iniziale: destra, anim 0
         m_sprite->setOrigin(sf::Vector2f{8.f, 8.f});
@@ -63,7 +64,7 @@ void Inky::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
                   const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode,
                   const sf::Vector2f& blinkyPos, bool gameStarted, bool released) {
     if (!m_released) {
-        m_drawPos = m_shape.getPosition();
+        m_drawPos = position();
         return;
     }
     // Se è in stato eaten/returning, lascia che la base gestisca tutto!
@@ -72,22 +73,22 @@ void Inky::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
         return;
     }
     m_mode = mode;
-    sf::Vector2f pos = m_shape.getPosition();
+    sf::Vector2f pos = position();
     float cx = std::round((pos.x - tileSize.x/2.f) / tileSize.x);
     float cy = std::round((pos.y - tileSize.y/2.f) / tileSize.y);
     int sx = int(std::round(cx));
     int sy = int(std::round(cy));
-    static float debugTimer = 0.f;
-    debugTimer += dt;
-    std::string modeStr = (m_mode == Mode::Chase) ? "Chase" : (m_mode == Mode::Scatter) ? "Scatter" : "Other";
-    sf::Vector2f target = calculateTarget(pacmanPos, pacmanDirection, map, tileSize, blinkyPos);
-    if (debugTimer >= 1.0f) {
-        if (map.isGhostHouse(sx, sy)) {
-            std::cout << "[INKY] GHOUSE Pos: (" << pos.x << "," << pos.y << ") Dir: (" << m_direction.x << "," << m_direction.y << ") Pacman: (" << pacmanPos.x << "," << pacmanPos.y << ") Target: (" << target.x << "," << target.y << ") Mode: " << modeStr << std::endl;
-        } else {
-            std::cout << "[INKY] OUT Pos: (" << pos.x << "," << pos.y << ") Dir: (" << m_direction.x << "," << m_direction.y << ") Pacman: (" << pacmanPos.x << "," << pacmanPos.y << ") Target: (" << target.x << "," << target.y << ") Mode: " << modeStr << std::endl;
+    if constexpr (Logger::compiledIn(Logger::Debug)) {
+        m_debugTimer += dt;
+        if (m_debugTimer >= 1.0f) {
+            // Target calcolato solo per il log: la scelta della direzione avviene agli incroci
+            const char* modeStr = (m_mode == Mode::Chase) ? "Chase" : (m_mode == Mode::Scatter) ? "Scatter" : "Other";
+            sf::Vector2f target = calculateTarget(pacmanPos, pacmanDirection, map, tileSize, blinkyPos);
+            PACMUX_LOG_DEBUG("[INKY] %s Pos: (%g,%g) Dir: (%g,%g) Pacman: (%g,%g) Target: (%g,%g) Mode: %s",
+                             map.isGhostHouse(sx, sy) ? "GHOUSE" : "OUT", pos.x, pos.y, m_direction.x, m_direction.y,
+                             pacmanPos.x, pacmanPos.y, target.x, target.y, modeStr);
+            m_debugTimer = 0.f;
         }
-        debugTimer = 0.f;
     }
     if (map.isGhostHouse(sx, sy)) {
         // Usa il pathfinding verso la porta di uscita
@@ -96,65 +97,59 @@ void Inky::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
         float nextX = cx + m_direction.x;
         float nextY = cy + m_direction.y;
         int w = map.getSize().x, h = map.getSize().y;
-        if (nextY == 10) {
+        if (map.isTunnelRow(int(nextY))) {
             if (nextX < 0) nextX = w - 1;
             else if (nextX >= w) nextX = 0;
         }
         if (nextX >= 0 && nextX < w && nextY >= 0 && nextY < h && canMove(m_direction, map, tileSize)) {
             sf::Vector2f dest{nextX * float(tileSize.x) + tileSize.x/2.f, nextY * float(tileSize.y) + float(tileSize.y/2.f)};
-            sf::Vector2f delta = dest - m_shape.getPosition();
+            sf::Vector2f delta = dest - position();
             float step = m_speed * dt;
             if (std::hypot(delta.x, delta.y) <= step) {
-                m_shape.setPosition(dest);
+                placeAt(dest);
             } else {
                 float deltaLen = std::hypot(delta.x, delta.y);
                 if (deltaLen > 0) {
                     sf::Vector2f normalizedDelta = delta / deltaLen;
-                    m_shape.move(normalizedDelta * step);
+                    moveBy(normalizedDelta * step);
                 }
             }
         }
-        m_drawPos = m_shape.getPosition();
+        m_drawPos = position();
     } else {
         // Comportamento normale: delega alla base
         Ghost::update(dt, map, tileSize, pacmanPos, pacmanDirection, mode, gameStarted);
     }
 }
 
-void Inky::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    states.transform *= getTransform();
-    if (m_hasTexture && m_sprite) {
-        m_sprite->setPosition(m_drawPos);
-        if (m_eaten || m_isReturningToHouse) {
-            int dir = 2;
-            if (m_direction.x < 0) dir = 0;
-            else if (m_direction.x > 0) dir = 2;
-            else if (m_direction.y < 0) dir = 1;
-            else if (m_direction.y > 0) dir = 3;
-            m_sprite->setTextureRect(EYES_FRAMES[dir]);
-        } else if (m_isFrightened) {
-            if (m_frightenedDuration - m_frightenedTimer < 2.f) {
-                bool white = (int((m_frightenedTimer * 8)) % 2) == 1;
-                if (white) {
-                    m_sprite->setTextureRect(FRIGHTENED_WHITE_FRAMES[m_animFrame % 2]);
-                } else {
-                    m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
-                }
+const sf::Sprite* Inky::currentSprite() const {
+    if (!m_hasTexture || !m_sprite) return nullptr;
+    m_sprite->setPosition(renderPosition());
+    if (m_eaten || m_isReturningToHouse) {
+        int dir = 2;
+        if (m_direction.x < 0) dir = 0;
+        else if (m_direction.x > 0) dir = 2;
+        else if (m_direction.y < 0) dir = 1;
+        else if (m_direction.y > 0) dir = 3;
+        m_sprite->setTextureRect(EYES_FRAMES[dir]);
+    } else if (m_isFrightened) {
+        if (m_frightenedDuration - m_frightenedTimer < 2.f) {
+            bool white = (int((m_frightenedTimer * 8)) % 2) == 1;
+            if (white) {
+                m_sprite->setTextureRect(FRIGHTENED_WHITE_FRAMES[m_animFrame % 2]);
             } else {
                 m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
             }
         } else {
-            int dir = 2;
-            if (m_direction.x < 0) dir = 0;
-            else if (m_direction.x > 0) dir = 2;
-            else if (m_direction.y < 0) dir = 1;
-            else if (m_direction.y > 0) dir = 3;
-            m_sprite->setTextureRect(INKY_FRAMES[dir][m_animFrame]);
+            m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
         }
-        target.draw(*m_sprite, states);
     } else {
-        sf::CircleShape shape = m_shape;
-        shape.setPosition(m_drawPos);
-        target.draw(shape, states);
+        int dir = 2;
+        if (m_direction.x < 0) dir = 0;
+        else if (m_direction.x > 0) dir = 2;
+        else if (m_direction.y < 0) dir = 1;
+        else if (m_direction.y > 0) dir = 3;
+        m_sprite->setTextureRect(INKY_FRAMES[dir][m_animFrame]);
     }
+    return m_sprite.get();
 }
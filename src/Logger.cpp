@@ -0,0 +1,187 @@
+#include "Logger.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Record {
+    int level;
+    int length;
+    char text[Logger::MESSAGE_SIZE];
+};
+
+// Buffer circolare di un thread: il thread scrive in head, il thread di scrittura legge da tail
+struct Ring {
+    std::array<Record, Logger::CAPACITY> records;
+    alignas(64) std::atomic<unsigned> head{0};
+    alignas(64) std::atomic<unsigned> tail{0};
+    std::atomic<bool> owned{false}; // false dopo l'uscita del thread: riusabile una volta vuoto
+};
+
+// Stato del log (uno per processo). Mai distrutto: thread ancora vivi all'uscita (es. i task
+// della classifica globale) possono ancora scrivere dopo shutdown()
+struct LogState {
+    std::mutex registryMutex;                  // rings, avvio e arresto del thread di scrittura
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::mutex drainMutex;                     // un solo lettore alla volta (thread di scrittura o flush)
+    std::condition_variable wake;
+    std::thread writer;
+    bool stopping = false;
+    std::atomic<bool> closed{false};
+    std::atomic<unsigned long long> dropped{0};
+    unsigned long long droppedReported = 0;
+};
+
+LogState& state() {
+    static LogState* s = new LogState;
+    return *s;
+}
+
+std::FILE* streamFor(int level) {
+    return level >= Logger::Warning ? stderr : stdout;
+}
+
+// Svuota tutti i buffer; da chiamare con drainMutex preso
+void drain(LogState& s) {
+    bool wrote = false;
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        for (const std::unique_ptr<Ring>& ring : s.rings) {
+            const unsigned tail = ring->tail.load(std::memory_order_relaxed);
+            const unsigned head = ring->head.load(std::memory_order_acquire);
+            for (unsigned i = tail; i != head; ++i) {
+                const Record& record = ring->records[i % Logger::CAPACITY];
+                std::FILE* out = streamFor(record.level);
+                std::fwrite(record.text, 1, static_cast<std::size_t>(record.length), out);
+                std::fputc('\n', out);
+            }
+            ring->tail.store(head, std::memory_order_release);
+            wrote = wrote || head != tail;
+        }
+    }
+    const unsigned long long dropped = s.dropped.load(std::memory_order_relaxed);
+    if (dropped != s.droppedReported) {
+        std::fprintf(stderr, "[LOG] %llu messaggi persi (buffer pieno)\n", dropped - s.droppedReported);
+        s.droppedReported = dropped;
+        wrote = true;
+    }
+    if (wrote) {
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+}
+
+void writerLoop() {
+    LogState& s = state();
+    std::unique_lock<std::mutex> lock(s.registryMutex);
+    while (!s.stopping) {
+        s.wake.wait_for(lock, std::chrono::milliseconds(10), [&] { return s.stopping; });
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> drainLock(s.drainMutex);
+            drain(s);
+        }
+        lock.lock();
+    }
+}
+
+// Buffer del thread corrente, restituito al registro all'uscita del thread
+struct ThreadRing {
+    Ring* ring = nullptr;
+    ~ThreadRing() {
+        if (ring) ring->owned.store(false, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+Ring* currentRing() {
+    if (t_ring.ring) return t_ring.ring;
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.registryMutex);
+    if (s.closed.load(std::memory_order_relaxed)) return nullptr;
+    if (!s.writer.joinable()) {
+        s.writer = std::thread(writerLoop);
+        std::atexit(Logger::shutdown);
+    }
+    // Riusa il buffer (già svuotato) di un thread terminato: i task async non lo fanno crescere
+    auto reusable = std::find_if(s.rings.begin(), s.rings.end(), [](const std::unique_ptr<Ring>& ring) {
+        return !ring->owned.load(std::memory_order_acquire) &&
+               ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire);
+    });
+    if (reusable == s.rings.end()) {
+        s.rings.push_back(std::make_unique<Ring>());
+        reusable = s.rings.end() - 1;
+    }
+    (*reusable)->owned.store(true, std::memory_order_relaxed);
+    t_ring.ring = reusable->get();
+    return t_ring.ring;
+}
+
+} // namespace
+
+std::atomic<int> Logger::s_level{PACMUX_LOG_LEVEL};
+
+void Logger::write(Level level, const char* format, ...) {
+    LogState& s = state();
+    Ring* ring = s.closed.load(std::memory_order_acquire) ? nullptr : currentRing();
+    std::va_list args;
+    va_start(args, format);
+    if (!ring) {
+        // Dopo shutdown: direttamente in console
+        char text[MESSAGE_SIZE];
+        const int length = std::vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        if (length >= 0) std::fprintf(streamFor(level), "%s\n", text);
+        return;
+    }
+
+    const unsigned head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= CAPACITY) {
+        va_end(args);
+        s.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Record& record = ring->records[head % CAPACITY];
+    const int length = std::vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+    record.level = level;
+    record.length = std::clamp(length, 0, MESSAGE_SIZE - 1);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Logger::prepareThread() {
+    if (!state().closed.load(std::memory_order_acquire)) currentRing();
+}
+
+void Logger::flush() {
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.drainMutex);
+    drain(s);
+}
+
+void Logger::shutdown() {
+    LogState& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        if (s.closed.load(std::memory_order_relaxed)) return;
+        s.closed.store(true, std::memory_order_release);
+        s.stopping = true;
+    }
+    s.wake.notify_one();
+    if (s.writer.joinable()) s.writer.join();
+    flush();
+}
+
+unsigned long long Logger::getDroppedCount() {
+    return state().dropped.load(std::memory_order_relaxed);
+}
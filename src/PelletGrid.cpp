@@ -0,0 +1,54 @@
+#include "PelletGrid.hpp"
+
+PelletGrid::PelletGrid(float radius, sf::Color color)
+    : m_radius(radius), m_color(color)
+{
+}
+
+bool PelletGrid::reset(const sf::Vector2u& mapSize, const sf::Vector2u& tileSize) {
+    m_bits.fill(0);
+    m_count = 0;
+    std::size_t cells = static_cast<std::size_t>(mapSize.x) * mapSize.y;
+    if (cells > MAX_CELLS) {
+        m_mapSize = {0, 0};
+        m_words = 0;
+        return false;
+    }
+    m_mapSize = mapSize;
+    m_tileSize = tileSize;
+    m_words = (cells + 63) / 64;
+    return true;
+}
+
+void PelletGrid::add(unsigned x, unsigned y) {
+    if (x >= m_mapSize.x || y >= m_mapSize.y || has(x, y)) return;
+    std::uint32_t i = y * m_mapSize.x + x;
+    m_bits[i >> 6] |= std::uint64_t(1) << (i & 63);
+    ++m_count;
+}
+
+bool PelletGrid::eatAt(unsigned x, unsigned y) {
+    if (!has(x, y)) return false;
+    std::uint32_t i = y * m_mapSize.x + x;
+    m_bits[i >> 6] &= ~(std::uint64_t(1) << (i & 63));
+    --m_count;
+    return true;
+}
+
+// Disegna un cerchio per ogni bit acceso
+void PelletGrid::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    sf::CircleShape shape(m_radius);
+    shape.setFillColor(m_color);
+    shape.setOrigin(sf::Vector2f(m_radius, m_radius));
+    forEach([&](unsigned x, unsigned y) {
+        shape.setPosition(tileCenter(x, y));
+        target.draw(shape, states);
+    });
+}
+
+void PelletGrid::appendTo(SpriteBatch& batch, sf::Color color, const sf::Transform& transform) const {
+    if (color.a == 0) return; // invisibile (lampeggio dei Super Pellet): niente vertici
+    forEach([&](unsigned x, unsigned y) {
+        batch.addCircle(tileCenter(x, y), m_radius, color, transform);
+    });
+}
@@ -5,9 +5,10 @@
 #include <iostream>
 
 // Pinky: il fantasma rosa, mira 4 caselle avanti a Pac-Man
-Pinky::Pinky(const sf::Vector2f& pos) : Ghost(pos, sf::Color::Magenta, 12.0f, Type::Pinky) {
-    m_texture = std::make_unique<sf::Texture>();
-    if (m_texture->loadFromFile("assets/pacman.png")) {
+Pinky::Pinky(ActorPositions& positions, std::size_t slot, const sf::Vector2f& pos)
+    : Ghost(positions, slot, pos, sf::Color::Magenta, 12.0f, Type::Pinky) {
+    // Atlas condiviso già acquisito dal costruttore di Ghost
+    if (m_texture) {
         m_sprite = std::make_unique<sf::Sprite>(*m_texture);
         m_sprite->setTextureRect(PINKY_FRAMES[2][0]); // frame iniziale: destra, anim 0
         m_sprite->setOrigin(sf::Vector2f{8.f, 8.f});
@@ -52,7 +53,6 @@ sf::Vector2f Pinky::calculateTarget(const sf::Vector2f& pacmanPos, const sf::Vec
 void Pinky::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
                   const sf::Vector2f& pacmanPos, const sf::Vector2f& pacmanDirection, Mode mode, bool gameStarted, bool released) {
     if (m_hasTexture && m_sprite) {
-        m_sprite->setPosition(m_shape.getPosition());
         m_animTime += dt;
         if (m_direction != sf::Vector2f{0,0}) {
             if (m_animTime >= GHOST_ANIMATION_INTERVAL) {
@@ -86,40 +86,34 @@ void Pinky::update(float dt, const TileMap& map, const sf::Vector2u& tileSize,
     Ghost::update(dt, map, tileSize, pacmanPos, pacmanDirection, mode, gameStarted);
 }
 
-void Pinky::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    states.transform *= getTransform();
-    if (m_hasTexture && m_sprite) {
-        m_sprite->setPosition(m_drawPos);
-        if (m_eaten || m_isReturningToHouse) {
-            int dir = 2;
-            if (m_direction.x < 0) dir = 0;
-            else if (m_direction.x > 0) dir = 2;
-            else if (m_direction.y < 0) dir = 1;
-            else if (m_direction.y > 0) dir = 3;
-            m_sprite->setTextureRect(EYES_FRAMES[dir]);
-        } else if (m_isFrightened) {
-            if (m_frightenedDuration - m_frightenedTimer < 2.f) {
-                bool white = (int((m_frightenedTimer * 8)) % 2) == 1;
-                if (white) {
-                    m_sprite->setTextureRect(FRIGHTENED_WHITE_FRAMES[m_animFrame % 2]);
-                } else {
-                    m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
-                }
+const sf::Sprite* Pinky::currentSprite() const {
+    if (!m_hasTexture || !m_sprite) return nullptr;
+    m_sprite->setPosition(renderPosition());
+    if (m_eaten || m_isReturningToHouse) {
+        int dir = 2;
+        if (m_direction.x < 0) dir = 0;
+        else if (m_direction.x > 0) dir = 2;
+        else if (m_direction.y < 0) dir = 1;
+        else if (m_direction.y > 0) dir = 3;
+        m_sprite->setTextureRect(EYES_FRAMES[dir]);
+    } else if (m_isFrightened) {
+        if (m_frightenedDuration - m_frightenedTimer < 2.f) {
+            bool white = (int((m_frightenedTimer * 8)) % 2) == 1;
+            if (white) {
+                m_sprite->setTextureRect(FRIGHTENED_WHITE_FRAMES[m_animFrame % 2]);
             } else {
                 m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
             }
         } else {
-            int dir = 2;
-            if (m_direction.x < 0) dir = 0;
-            else if (m_direction.x > 0) dir = 2;
-            else if (m_direction.y < 0) dir = 1;
-            else if (m_direction.y > 0) dir = 3;
-            m_sprite->setTextureRect(PINKY_FRAMES[dir][m_animFrame]);
+            m_sprite->setTextureRect(FRIGHTENED_FRAMES[m_animFrame % 2]);
         }
-        target.draw(*m_sprite, states);
     } else {
-        sf::CircleShape shape = m_shape;
-        shape.setPosition(m_drawPos);
-        target.draw(shape, states);
+        int dir = 2;
+        if (m_direction.x < 0) dir = 0;
+        else if (m_direction.x > 0) dir = 2;
+        else if (m_direction.y < 0) dir = 1;
+        else if (m_direction.y > 0) dir = 3;
+        m_sprite->setTextureRect(PINKY_FRAMES[dir][m_animFrame]);
     }
+    return m_sprite.get();
 }
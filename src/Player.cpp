@@ -1,8 +1,8 @@
 // src/Player.cpp
 #include "Player.hpp"
-#include <SFML/Window/Keyboard.hpp>
+#include "SpriteSheet.hpp"
+#include "Logger.hpp"
 #include <cmath>
-#include <iostream>
 
 // Imposta la direzione di Pac-Man
 void Player::setDirection(const sf::Vector2f& dir) {
@@ -40,8 +40,9 @@ static constexpr float DEATH_ANIMATION_INTERVAL = 0.09f; // secondi tra i frame
 enum PacmanDir { LEFT=0, UP=1, RIGHT=2, DOWN=3, NONE=4 };
 
 // Costruttore: inizializza Pac-Man con velocità, posizione e dimensione cella
-Player::Player(float speed, const sf::Vector2f& startPos, const sf::Vector2u& tileSize)
-    : m_shape(tileSize.x * 0.4f)
+Player::Player(ActorPositions& positions, float speed, const sf::Vector2f& startPos, const sf::Vector2u& tileSize)
+    : m_positions(&positions)
+    , m_radius(tileSize.x * 0.4f)
     , m_speed(speed)
     , m_direction{0.f, 0.f}
     , m_nextDirection{0.f, 0.f}
@@ -56,20 +57,18 @@ Player::Player(float speed, const sf::Vector2f& startPos, const sf::Vector2u& ti
     , m_deathFrame(0)
     , m_deathAnimFinished(false)
 {
-    m_shape.setFillColor(sf::Color::Yellow);
-    m_shape.setOrigin(sf::Vector2f(m_shape.getRadius(), m_shape.getRadius()));
-    m_shape.setPosition(startPos);
-    m_logicalPosition = startPos; // Inizializza la posizione logica
+    m_positions->set(ActorPositions::PLAYER, startPos);
+    m_prevPosition = startPos;
     
     // Prova a caricare la texture di Pac-Man
-    m_texture = std::make_unique<sf::Texture>();
-    if (m_texture->loadFromFile("assets/pacman.png")) {
-        std::cout << "[DEBUG] Texture Pac-Man caricata con successo!" << std::endl;
+    m_texture = SpriteSheet::acquire();
+    if (m_texture) {
+        PACMUX_LOG_DEBUG("[DEBUG] Texture Pac-Man caricata con successo!");
         // Crea lo sprite
         m_sprite = std::make_unique<sf::Sprite>(*m_texture);
         // Imposta il frame iniziale: DESTRA, bocca chiusa
         m_sprite->setTextureRect(PACMAN_FRAMES[2][0]);
-        std::cout << "[DEBUG] Frame iniziale impostato a destra, bocca chiusa (1,563,32,32)" << std::endl;
+        PACMUX_LOG_DEBUG("[DEBUG] Frame iniziale impostato a destra, bocca chiusa (1,563,32,32)");
         
         // Imposta origine al centro
         m_sprite->setOrigin(sf::Vector2f{16.f, 16.f});
@@ -77,14 +76,12 @@ Player::Player(float speed, const sf::Vector2f& startPos, const sf::Vector2u& ti
         // Scala lo sprite per adattarlo alla dimensione della cella (ridotto all'80%)
         float scale = static_cast<float>(tileSize.x) / 32.f * 0.75f;
         m_sprite->setScale(sf::Vector2f{scale, scale});
-        
-        // Posiziona lo sprite
-        m_sprite->setPosition(startPos);
+
         
         m_hasTexture = true;
-        std::cout << "[DEBUG] Sprite Pac-Man configurato (scala: " << scale << ")" << std::endl;
-    } else {
-        std::cout << "[WARNING] Impossibile caricare assets/pacman.png, uso cerchio giallo" << std::endl;
+        PACMUX_LOG_DEBUG("[DEBUG] Sprite Pac-Man configurato (scala: %g)", scale);
+    } else if (SpriteSheet::isEnabled()) {
+        PACMUX_LOG_WARNING("[WARNING] Impossibile caricare assets/pacman.png, uso cerchio giallo");
     }
 }
 
@@ -111,8 +108,54 @@ bool Player::isDeathAnimationFinished() const {
     return m_deathAnimFinished;
 }
 
+Player::State Player::getState() const {
+    State state;
+    state.direction = m_direction;
+    state.nextDirection = m_nextDirection;
+    state.prevPosition = m_prevPosition;
+    state.speed = m_speed;
+    state.lives = m_lives;
+    state.animTime = m_animTime;
+    state.animFrame = m_animFrame;
+    state.isDying = m_isDying;
+    state.deathAnimTime = m_deathAnimTime;
+    state.deathFrame = m_deathFrame;
+    state.deathAnimFinished = m_deathAnimFinished;
+    return state;
+}
+
+void Player::setState(const State& state) {
+    m_direction = state.direction;
+    m_nextDirection = state.nextDirection;
+    m_prevPosition = state.prevPosition;
+    m_speed = state.speed;
+    m_lives = state.lives;
+    m_animTime = state.animTime;
+    m_animFrame = state.animFrame;
+    m_isDying = state.isDying;
+    m_deathAnimTime = state.deathAnimTime;
+    m_deathFrame = state.deathFrame;
+    m_deathAnimFinished = state.deathAnimFinished;
+    if (!m_hasTexture || !m_sprite)
+        return;
+    // Lo sprite segue il frame ripristinato: morte (frame 16x16) o camminata (32x32)
+    if (m_isDying || m_deathAnimFinished) {
+        m_sprite->setTextureRect(PACMAN_DEATH_FRAMES[m_deathFrame]);
+        m_sprite->setOrigin(sf::Vector2f{8.f, 8.f});
+        m_sprite->setScale(sf::Vector2f(m_tileSize.x / 16.f * 0.75f, m_tileSize.y / 16.f * 0.75f));
+    } else {
+        PacmanDir dir = getPacmanDir(m_direction);
+        if (dir == NONE) dir = getPacmanDir(m_nextDirection);
+        if (dir == NONE) dir = RIGHT;
+        m_sprite->setTextureRect(PACMAN_FRAMES[dir][m_animFrame]);
+        m_sprite->setOrigin(sf::Vector2f{16.f, 16.f});
+        float scale = static_cast<float>(m_tileSize.x) / 32.f * 0.75f;
+        m_sprite->setScale(sf::Vector2f{scale, scale});
+    }
+}
+
 // Aggiorna la posizione e la direzione di Pac-Man in base all'input e alle collisioni
-void Player::update(float dt, const TileMap& map, const sf::Vector2u& tileSize) {
+void Player::update(float dt, const TileMap& map, const sf::Vector2u& tileSize, const sf::Vector2f& requestedDir) {
     if (m_isDying) {
         // Solo animazione morte
         m_deathAnimTime += dt;
@@ -137,21 +180,13 @@ void Player::update(float dt, const TileMap& map, const sf::Vector2u& tileSize)
         return;
     }
 
-    using Key = sf::Keyboard::Key;
-
-    // Leggi input direzionale (Frecce o WASD)
-    bool left  = sf::Keyboard::isKeyPressed(Key::Left)  || sf::Keyboard::isKeyPressed(Key::A);
-    bool right = sf::Keyboard::isKeyPressed(Key::Right) || sf::Keyboard::isKeyPressed(Key::D);
-    bool up    = sf::Keyboard::isKeyPressed(Key::Up)    || sf::Keyboard::isKeyPressed(Key::W);
-    bool down  = sf::Keyboard::isKeyPressed(Key::Down)  || sf::Keyboard::isKeyPressed(Key::S);
-
-    if      (left)  m_nextDirection = {-1.f,  0.f};
-    else if (right) m_nextDirection = { 1.f,  0.f};
-    else if (up)    m_nextDirection = { 0.f, -1.f};
-    else if (down)  m_nextDirection = { 0.f,  1.f};
+    // Direzione richiesta (tastiera nel gioco, script/AI in headless): (0,0) = nessun input
+    if (requestedDir != sf::Vector2f{0.f, 0.f}) {
+        m_nextDirection = requestedDir;
+    }
 
-    sf::Vector2f pos = m_shape.getPosition();
-    float r = m_shape.getRadius();
+    sf::Vector2f pos = getPosition();
+    float r = m_radius;
 
     // Calcola cella corrente e centro della cella
     unsigned cellX = unsigned(pos.x / tileSize.x);
@@ -195,7 +230,7 @@ void Player::update(float dt, const TileMap& map, const sf::Vector2u& tileSize)
             // Pac-Man non può entrare nella ghost house
             if (inBounds && !map.isWall(nx,ny) && !map.isGhostHouse(nx,ny)) {
                 m_direction = m_nextDirection;
-                m_shape.setPosition(center); // riallinea
+                m_positions->set(ActorPositions::PLAYER, center); // riallinea
                 pos = center;
             }
         }
@@ -230,7 +265,7 @@ void Player::update(float dt, const TileMap& map, const sf::Vector2u& tileSize)
     if (tx>=0 && ty>=0 && tx<int(map.getSize().x) && ty<int(map.getSize().y)
         && !map.isWall(tx, ty) && !map.isGhostHouse(tx, ty))
     {
-        m_shape.setPosition(newPos);
+        m_positions->set(ActorPositions::PLAYER, newPos);
     }
     // Altrimenti, blocca il movimento e riallinea
     else {
@@ -238,22 +273,18 @@ void Player::update(float dt, const TileMap& map, const sf::Vector2u& tileSize)
             float limitX = center.x + (m_direction.x>0
                 ? (tileSize.x/2.f - r)
                 : -(tileSize.x/2.f - r));
-            m_shape.setPosition(sf::Vector2f(limitX, pos.y));
+            m_positions->set(ActorPositions::PLAYER, sf::Vector2f(limitX, pos.y));
         } else if (m_direction.y != 0.f) {
             float limitY = center.y + (m_direction.y>0
                 ? (tileSize.y/2.f - r)
                 : -(tileSize.y/2.f - r));
-            m_shape.setPosition(sf::Vector2f(pos.x, limitY));
+            m_positions->set(ActorPositions::PLAYER, sf::Vector2f(pos.x, limitY));
         }
         m_direction = {0.f,0.f};
     }
 
-    // Aggiorna la posizione logica con la posizione corrente
-    m_logicalPosition = m_shape.getPosition();
-    
-    // Sincronizza lo sprite con la posizione del cerchio
+    // Frame dello sprite (la posizione dello sprite si aggiorna solo in draw/appendTo)
     if (m_hasTexture && m_sprite) {
-        m_sprite->setPosition(m_shape.getPosition());
         // --- ANIMAZIONE SPRITE ---
         m_animTime += dt;
         int animFrames = 3;
@@ -280,9 +311,33 @@ void Player::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     
     if (m_hasTexture && m_sprite) {
         // Disegna lo sprite se la texture è disponibile
+        m_sprite->setPosition(renderPosition());
         target.draw(*m_sprite, states);
     } else {
         // Fallback: disegna il cerchio giallo
-        target.draw(m_shape, states);
+        sf::CircleShape shape(m_radius);
+        shape.setFillColor(sf::Color::Yellow);
+        shape.setOrigin({m_radius, m_radius});
+        shape.setPosition(renderPosition());
+        target.draw(shape, states);
+    }
+}
+
+sf::Vector2f Player::renderPosition() const {
+    const sf::Vector2f current = getPosition();
+    const sf::Vector2f delta = current - m_prevPosition;
+    // Salto più lungo di una cella = teletrasporto nel tunnel: niente scia attraverso la mappa
+    if (std::abs(delta.x) > m_tileSize.x || std::abs(delta.y) > m_tileSize.y)
+        return current;
+    return m_prevPosition + delta * m_renderAlpha;
+}
+
+void Player::appendTo(SpriteBatch& batch, const sf::Transform& transform) const {
+    const sf::Transform t = transform * getTransform();
+    if (m_hasTexture && m_sprite) {
+        m_sprite->setPosition(renderPosition());
+        batch.add(*m_sprite, t);
+    } else {
+        batch.addCircle(renderPosition(), m_radius, sf::Color::Yellow, t);
     }
 }
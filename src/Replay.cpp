@@ -0,0 +1,246 @@
+#include "Replay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+
+static const char REPLAY_MAGIC[4] = {'P', 'M', 'X', 'R'};
+// 2: fantasmi sul grafo degli incroci (le partite registrate con la versione 1 non si riproducono più uguali)
+// 3: generatore PCG32 al posto di mt19937 e frutti sul k-esimo pellet rimasto (cambiano le scelte casuali)
+static constexpr std::uint8_t REPLAY_VERSION = 3;
+
+enum RecordTag : std::uint8_t {
+    RECORD_INPUT = 1,       // direzione + numero di tick
+    RECORD_SNAP = 2,        // snapPlayerToTile
+    RECORD_CHECKPOINT = 3,  // stato dopo un cambio di livello o una vita persa
+    RECORD_END = 4          // stato finale
+};
+
+// Eventi che generano un checkpoint
+static constexpr std::uint32_t CHECKPOINT_EVENTS =
+    GameSimulation::LifeLost | GameSimulation::GameOver | GameSimulation::LevelCompleted |
+    GameSimulation::AllLevelsCompleted | GameSimulation::ExtraLife;
+
+// --- Interi a lunghezza variabile (7 bit per byte, bit alto = continua) ---
+static void writeVarint(std::ostream& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+static bool readVarint(std::istream& in, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = in.get();
+        if (c == std::char_traits<char>::eof()) return false;
+        value |= std::uint64_t(c & 0x7F) << shift;
+        if ((c & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// Direzione di Pac-Man <-> codice a un byte
+static std::uint8_t encodeInput(const SimInput& input) {
+    if (input.direction.x < 0.f) return 1;
+    if (input.direction.x > 0.f) return 2;
+    if (input.direction.y < 0.f) return 3;
+    if (input.direction.y > 0.f) return 4;
+    return 0;
+}
+
+static SimInput decodeInput(std::uint8_t code) {
+    static const sf::Vector2f DIRECTIONS[5] = {{0.f, 0.f}, {-1.f, 0.f}, {1.f, 0.f}, {0.f, -1.f}, {0.f, 1.f}};
+    return SimInput{DIRECTIONS[code < 5 ? code : 0]};
+}
+
+static std::uint16_t ticksPerSecond() {
+    return static_cast<std::uint16_t>(std::lround(1.f / GameSimulation::TICK));
+}
+
+// --- Scrittura ---
+
+void ReplayWriter::begin(const GameSimulation& sim) {
+    m_out.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    m_out.put(static_cast<char>(REPLAY_VERSION));
+    writeVarint(m_out, ticksPerSecond());
+    writeVarint(m_out, sim.getSeed());
+    writeVarint(m_out, sim.getMapFiles().size());
+    for (const std::string& path : sim.getMapFiles()) {
+        std::string name = std::filesystem::path(path).filename().string();
+        writeVarint(m_out, name.size());
+        m_out.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+    m_runInput = 0;
+    m_runLength = 0;
+    m_recording = true;
+}
+
+void ReplayWriter::recordTick(const SimInput& input, const GameSimulation& sim) {
+    if (!m_recording) return;
+    std::uint8_t code = encodeInput(input);
+    if (m_runLength > 0 && code != m_runInput) {
+        flushRun();
+    }
+    m_runInput = code;
+    ++m_runLength;
+    if (sim.getEvents() & CHECKPOINT_EVENTS) {
+        flushRun();
+        m_out.put(static_cast<char>(RECORD_CHECKPOINT));
+        writeState(sim);
+    }
+}
+
+void ReplayWriter::recordSnap() {
+    if (!m_recording) return;
+    flushRun();
+    m_out.put(static_cast<char>(RECORD_SNAP));
+}
+
+void ReplayWriter::finish(const GameSimulation& sim) {
+    if (!m_recording) return;
+    flushRun();
+    m_out.put(static_cast<char>(RECORD_END));
+    writeState(sim);
+    m_out.flush();
+    m_recording = false;
+}
+
+void ReplayWriter::flushRun() {
+    if (m_runLength == 0) return;
+    m_out.put(static_cast<char>(RECORD_INPUT));
+    m_out.put(static_cast<char>(m_runInput));
+    writeVarint(m_out, m_runLength);
+    m_runLength = 0;
+}
+
+void ReplayWriter::writeState(const GameSimulation& sim) {
+    writeVarint(m_out, sim.getTick());
+    writeVarint(m_out, sim.getEvents());
+    writeVarint(m_out, sim.getScore());
+    writeVarint(m_out, static_cast<std::uint64_t>(sim.getLevel()));
+    writeVarint(m_out, static_cast<std::uint64_t>(sim.getDifficulty()));
+    writeVarint(m_out, static_cast<std::uint64_t>(std::max(sim.getLives(), 0)));
+}
+
+// --- Riproduzione ---
+
+// Confronta lo stato registrato con quello risimulato; false + messaggio alla prima differenza
+static bool checkState(std::istream& in, const GameSimulation& sim, std::uint32_t eventMask, std::string& error) {
+    std::uint64_t tick, events, score, level, difficulty, lives;
+    if (!readVarint(in, tick) || !readVarint(in, events) || !readVarint(in, score) ||
+        !readVarint(in, level) || !readVarint(in, difficulty) || !readVarint(in, lives)) {
+        error = "replay troncato";
+        return false;
+    }
+    auto mismatch = [&](const char* what, std::uint64_t expected, std::uint64_t actual) {
+        error = std::string("divergenza al tick ") + std::to_string(sim.getTick()) + ": " + what +
+                " atteso " + std::to_string(expected) + ", ottenuto " + std::to_string(actual);
+        return false;
+    };
+    if (tick != sim.getTick()) return mismatch("tick", tick, sim.getTick());
+    if ((events & eventMask) != (sim.getEvents() & eventMask)) return mismatch("eventi", events, sim.getEvents());
+    if (score != sim.getScore()) return mismatch("punteggio", score, sim.getScore());
+    if (level != std::uint64_t(sim.getLevel())) return mismatch("livello", level, sim.getLevel());
+    if (difficulty != std::uint64_t(sim.getDifficulty())) return mismatch("difficoltà", difficulty, sim.getDifficulty());
+    if (lives != std::uint64_t(std::max(sim.getLives(), 0))) return mismatch("vite", lives, sim.getLives());
+    return true;
+}
+
+static void fillResult(const GameSimulation& sim, ReplayResult& result) {
+    result.ticks = sim.getTick();
+    result.score = sim.getScore();
+    result.level = sim.getLevel();
+    result.lives = sim.getLives();
+    result.ghostAllocations = sim.getGhostUpdateAllocations();
+}
+
+bool playReplay(std::istream& in, const std::string& mapDir, ReplayResult& result) {
+    result = ReplayResult{};
+    char magic[sizeof(REPLAY_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (in.gcount() == 0) return false; // fine dello stream
+    if (in.gcount() != sizeof(magic) || !std::equal(magic, magic + sizeof(magic), REPLAY_MAGIC)) {
+        result.error = "intestazione non valida";
+        return true;
+    }
+    int version = in.get();
+    if (version != REPLAY_VERSION) {
+        result.error = "versione non supportata: " + std::to_string(version);
+        return true;
+    }
+
+    ReplayHeader header;
+    std::uint64_t tickRate, seed, mapCount;
+    if (!readVarint(in, tickRate) || !readVarint(in, seed) || !readVarint(in, mapCount)) {
+        result.error = "replay troncato";
+        return true;
+    }
+    header.ticksPerSecond = static_cast<std::uint16_t>(tickRate);
+    header.seed = static_cast<std::uint32_t>(seed);
+    for (std::uint64_t i = 0; i < mapCount; ++i) {
+        std::uint64_t length;
+        if (!readVarint(in, length) || length > 4096) {
+            result.error = "replay troncato";
+            return true;
+        }
+        std::string name(static_cast<std::size_t>(length), '\0');
+        in.read(name.data(), static_cast<std::streamsize>(length));
+        header.mapFiles.push_back(name);
+    }
+    result.seed = header.seed;
+    if (header.ticksPerSecond != ticksPerSecond()) {
+        result.error = "tick rate " + std::to_string(header.ticksPerSecond) + " diverso da " + std::to_string(ticksPerSecond());
+        return true;
+    }
+
+    GameSimulation::Config config;
+    config.seed = header.seed;
+    config.headless = true;
+    for (const std::string& name : header.mapFiles) {
+        config.mapFiles.push_back((std::filesystem::path(mapDir) / name).string());
+    }
+    GameSimulation sim(config);
+    if (!sim.newGame(header.seed)) {
+        result.error = "mappa non caricabile da " + mapDir;
+        return true;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (;;) {
+        int tag = in.get();
+        if (tag == std::char_traits<char>::eof()) {
+            result.error = "replay troncato";
+            break;
+        }
+        if (tag == RECORD_INPUT) {
+            int code = in.get();
+            std::uint64_t count;
+            if (code == std::char_traits<char>::eof() || !readVarint(in, count)) {
+                result.error = "replay troncato";
+                break;
+            }
+            const SimInput input = decodeInput(static_cast<std::uint8_t>(code));
+            for (std::uint64_t i = 0; i < count; ++i) {
+                sim.step(GameSimulation::TICK, input);
+            }
+        } else if (tag == RECORD_SNAP) {
+            sim.snapPlayerToTile();
+        } else if (tag == RECORD_CHECKPOINT) {
+            if (!checkState(in, sim, CHECKPOINT_EVENTS, result.error)) break;
+        } else if (tag == RECORD_END) {
+            // Gli eventi dell'ultimo tick non contano: la partita può finire anche a metà
+            result.ok = checkState(in, sim, 0, result.error);
+            break;
+        } else {
+            result.error = "record sconosciuto: " + std::to_string(tag);
+            break;
+        }
+    }
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fillResult(sim, result);
+    return true;
+}
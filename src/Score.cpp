@@ -1,13 +1,12 @@
 #include "Score.hpp"
+#include "TextCache.hpp"
 
 // Costruttore: inizializza il punteggio e prepara il testo a schermo
 Score::Score(const std::string& fontFile)
-    : m_score(0), m_extraLifeThreshold(10000), m_extraLifeGiven(false)
+    : m_score(0),
+      m_font(TextCache::instance().font(fontFile)), // letto una volta sola, lancia eccezione se fallisce
+      m_extraLifeThreshold(10000), m_extraLifeGiven(false)
 {
-    // Carica il font dal file, lancia eccezione se fallisce
-    if (!m_font.openFromFile(fontFile))
-        throw std::runtime_error("Cannot load font: " + fontFile);
-
     // Crea l'oggetto sf::Text con font, stringa iniziale e dimensione carattere
     m_text = std::make_unique<sf::Text>(
         m_font,
@@ -0,0 +1,91 @@
+#include "SpriteBatch.hpp"
+#include <cmath>
+
+void SpriteBatch::clear() {
+    for (Layer& layer : m_layers) {
+        layer.vertices.clear();
+    }
+    m_order.clear();
+}
+
+SpriteBatch::Layer& SpriteBatch::layerFor(const sf::Texture* texture) {
+    for (std::size_t idx : m_order) {
+        if (m_layers[idx].texture == texture) return m_layers[idx];
+    }
+    // Primo uso nel frame: riusa il livello di un frame precedente se c'è
+    std::size_t idx = 0;
+    while (idx < m_layers.size() && m_layers[idx].texture != texture) ++idx;
+    if (idx == m_layers.size()) {
+        m_layers.push_back(Layer{texture});
+    }
+    m_order.push_back(idx);
+    return m_layers[idx];
+}
+
+// Due triangoli per sprite; le coordinate texture sono in pixel come per sf::Sprite
+void SpriteBatch::add(const sf::Sprite& sprite, const sf::Transform& transform) {
+    const sf::IntRect rect = sprite.getTextureRect();
+    const sf::Transform t = transform * sprite.getTransform();
+    const sf::Color color = sprite.getColor();
+    const float w = std::abs(static_cast<float>(rect.size.x));
+    const float h = std::abs(static_cast<float>(rect.size.y));
+    const float left = static_cast<float>(rect.position.x);
+    const float top = static_cast<float>(rect.position.y);
+    const float right = left + static_cast<float>(rect.size.x);
+    const float bottom = top + static_cast<float>(rect.size.y);
+
+    const sf::Vertex topLeft{t.transformPoint({0.f, 0.f}), color, {left, top}};
+    const sf::Vertex topRight{t.transformPoint({w, 0.f}), color, {right, top}};
+    const sf::Vertex bottomLeft{t.transformPoint({0.f, h}), color, {left, bottom}};
+    const sf::Vertex bottomRight{t.transformPoint({w, h}), color, {right, bottom}};
+
+    sf::VertexArray& vertices = layerFor(&sprite.getTexture()).vertices;
+    for (const sf::Vertex& v : {topLeft, topRight, bottomLeft, bottomLeft, topRight, bottomRight}) {
+        vertices.append(v);
+    }
+}
+
+// Ventaglio di CIRCLE_POINTS triangoli attorno al centro
+void SpriteBatch::addCircle(const sf::Vector2f& center, float radius, sf::Color color, const sf::Transform& transform) {
+    if (m_unitCircle.empty()) {
+        m_unitCircle.reserve(CIRCLE_POINTS);
+        for (unsigned i = 0; i < CIRCLE_POINTS; ++i) {
+            float angle = 2.f * 3.14159265f * static_cast<float>(i) / CIRCLE_POINTS;
+            m_unitCircle.push_back({std::cos(angle), std::sin(angle)});
+        }
+    }
+    sf::VertexArray& vertices = layerFor(nullptr).vertices;
+    const sf::Vector2f c = transform.transformPoint(center);
+    for (unsigned i = 0; i < CIRCLE_POINTS; ++i) {
+        const sf::Vector2f& a = m_unitCircle[i];
+        const sf::Vector2f& b = m_unitCircle[(i + 1) % CIRCLE_POINTS];
+        vertices.append(sf::Vertex{c, color, {}});
+        vertices.append(sf::Vertex{transform.transformPoint(center + a * radius), color, {}});
+        vertices.append(sf::Vertex{transform.transformPoint(center + b * radius), color, {}});
+    }
+}
+
+std::size_t SpriteBatch::getDrawCallCount() const {
+    std::size_t calls = 0;
+    for (std::size_t idx : m_order) {
+        if (m_layers[idx].vertices.getVertexCount() > 0) ++calls;
+    }
+    return calls;
+}
+
+std::size_t SpriteBatch::getTriangleCount() const {
+    std::size_t vertices = 0;
+    for (std::size_t idx : m_order) {
+        vertices += m_layers[idx].vertices.getVertexCount();
+    }
+    return vertices / 3;
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    for (std::size_t idx : m_order) {
+        const Layer& layer = m_layers[idx];
+        if (layer.vertices.getVertexCount() == 0) continue;
+        states.texture = layer.texture;
+        target.draw(layer.vertices, states);
+    }
+}
@@ -0,0 +1,51 @@
+#include "SpriteSheet.hpp"
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<bool> SpriteSheet::s_enabled{true};
+thread_local bool SpriteSheet::t_headless = false;
+std::atomic<unsigned> SpriteSheet::s_decodeCount{0};
+
+namespace {
+
+// La cache tiene un riferimento proprio: la texture sopravvive anche quando
+// tutte le entità vengono distrutte tra un livello e l'altro.
+// Il mutex copre anche la decodifica: due thread che chiedono lo stesso file lo leggono una volta sola
+struct TextureCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<sf::Texture>> textures;
+};
+
+TextureCache& textureCache() {
+    static TextureCache cache;
+    return cache;
+}
+
+} // namespace
+
+std::shared_ptr<const sf::Texture> SpriteSheet::acquire(const std::string& path) {
+    if (!isEnabled()) return nullptr;
+    TextureCache& cache = textureCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.textures.find(path);
+    if (it == cache.textures.end()) {
+        auto texture = std::make_shared<sf::Texture>();
+        s_decodeCount.fetch_add(1, std::memory_order_relaxed);
+        if (!texture->loadFromFile(path)) {
+            texture.reset(); // ricorda il fallimento, niente nuovi tentativi per ogni entità
+        }
+        it = cache.textures.emplace(path, std::move(texture)).first;
+    }
+    return it->second;
+}
+
+bool SpriteSheet::preload(const sf::Image& image, const std::string& path) {
+    auto texture = std::make_shared<sf::Texture>();
+    s_decodeCount.fetch_add(1, std::memory_order_relaxed);
+    if (!texture->loadFromImage(image)) texture.reset();
+    const bool ok = texture != nullptr;
+    TextureCache& cache = textureCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.textures[path] = std::move(texture);
+    return ok;
+}
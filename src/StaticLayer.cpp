@@ -0,0 +1,70 @@
+#include "StaticLayer.hpp"
+#include <bit>
+
+bool StaticLayer::update(const TileMap& map, const PelletGrid& pellets, const sf::Vector2u& tileSize, int level) {
+    PelletGrid::State current;
+    pellets.saveState(current);
+
+    bool appeared = false;
+    for (std::size_t word = 0; word < PelletGrid::WORDS; ++word) {
+        if (current.bits[word] & ~m_pellets.bits[word]) {
+            appeared = true;
+            break;
+        }
+    }
+    if (!m_valid || appeared || level != m_level || map.getSize() != m_mapSize) {
+        m_level = level;
+        m_mapSize = map.getSize();
+        m_pellets = current;
+        m_valid = rebuild(map, pellets, tileSize);
+        return m_valid;
+    }
+
+    // Solo pellet spariti: un quadrato di sfondo su ognuno (il pellet sta dentro una cella libera)
+    m_erase.clear();
+    const float half = pellets.getRadius() + 1.f;
+    for (std::size_t word = 0; word < PelletGrid::WORDS; ++word) {
+        for (std::uint64_t gone = m_pellets.bits[word] & ~current.bits[word]; gone != 0; gone &= gone - 1) {
+            const std::size_t i = (word << 6) + static_cast<std::size_t>(std::countr_zero(gone));
+            const sf::Vector2f c = pellets.tileCenter(static_cast<unsigned>(i % m_mapSize.x),
+                                                      static_cast<unsigned>(i / m_mapSize.x));
+            const sf::Vertex topLeft{{c.x - half, c.y - half}, m_background, {}};
+            const sf::Vertex topRight{{c.x + half, c.y - half}, m_background, {}};
+            const sf::Vertex bottomLeft{{c.x - half, c.y + half}, m_background, {}};
+            const sf::Vertex bottomRight{{c.x + half, c.y + half}, m_background, {}};
+            m_erase.append(topLeft);
+            m_erase.append(topRight);
+            m_erase.append(bottomLeft);
+            m_erase.append(topRight);
+            m_erase.append(bottomRight);
+            m_erase.append(bottomLeft);
+        }
+    }
+    if (m_erase.getVertexCount() > 0) {
+        m_texture.draw(m_erase);
+        m_texture.display();
+        m_erased += m_erase.getVertexCount() / 6;
+    }
+    m_pellets = current;
+    return true;
+}
+
+bool StaticLayer::rebuild(const TileMap& map, const PelletGrid& pellets, const sf::Vector2u& tileSize) {
+    const sf::Vector2u size{map.getSize().x * tileSize.x, map.getSize().y * tileSize.y};
+    if (size.x == 0 || size.y == 0) return false;
+    if (m_texture.getSize() != size && !m_texture.resize(size)) return false;
+
+    m_texture.clear(m_background);
+    m_texture.draw(map);
+    m_batch.clear();
+    pellets.appendTo(m_batch);
+    m_texture.draw(m_batch);
+    m_texture.display();
+    ++m_rebuilds;
+    return true;
+}
+
+void StaticLayer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!m_valid) return;
+    target.draw(sf::Sprite(m_texture.getTexture()), states);
+}
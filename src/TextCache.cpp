@@ -0,0 +1,56 @@
+#include "TextCache.hpp"
+#include <functional>
+
+TextCache& TextCache::instance() {
+    static TextCache cache;
+    return cache;
+}
+
+const sf::Font& TextCache::font(const std::string& fontPath) {
+    auto it = m_fonts.find(fontPath);
+    if (it == m_fonts.end()) {
+        // SFML 3: il costruttore carica il font e lancia un'eccezione se fallisce
+        it = m_fonts.emplace(fontPath, std::make_unique<sf::Font>(fontPath)).first;
+        ++m_stats.fontLoads;
+    }
+    return *it->second;
+}
+
+sf::Text& TextCache::text(const std::string& fontPath, const std::string& str, unsigned size, std::uint32_t style) {
+    const sf::Font& textFont = font(fontPath);
+    ++m_useCounter;
+    auto it = m_texts.find(Key{&textFont, str, size, style});
+    if (it != m_texts.end()) {
+        ++m_stats.textHits;
+        it->second.lastUse = m_useCounter;
+        return *it->second.text;
+    }
+
+    ++m_stats.textMisses;
+    if (m_texts.size() >= 2 * MAX_TEXTS) {
+        evictUnused();
+    }
+    Entry entry;
+    entry.text = std::make_unique<sf::Text>(textFont, str, size);
+    entry.text->setStyle(style);
+    entry.lastUse = m_useCounter;
+    return *m_texts.emplace(Key{&textFont, str, size, style}, std::move(entry)).first->second.text;
+}
+
+// Elimina i testi non richiesti di recente: quelli usati nel frame corrente restano validi
+void TextCache::evictUnused() {
+    for (auto it = m_texts.begin(); it != m_texts.end();) {
+        if (it->second.lastUse + MAX_TEXTS < m_useCounter) {
+            it = m_texts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::size_t TextCache::KeyHash::operator()(const Key& key) const {
+    std::size_t h = std::hash<std::string>{}(key.str);
+    h ^= std::hash<const void*>{}(key.font) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<std::uint64_t>{}((std::uint64_t(key.size) << 32) | key.style) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
@@ -0,0 +1,106 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+// Worker del thread corrente (e pool a cui appartiene)
+static thread_local const ThreadPool* t_pool = nullptr;
+static thread_local int t_worker = -1;
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // Thread avviati solo dopo aver creato tutte le code: un worker può rubare subito da ognuna
+    for (unsigned i = 0; i < threads; ++i) {
+        m_workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+int ThreadPool::currentWorker() {
+    return t_worker;
+}
+
+void ThreadPool::submit(Task task) {
+    unsigned index;
+    if (t_pool == this) {
+        index = static_cast<unsigned>(t_worker);
+    } else {
+        index = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+    }
+    m_pending.fetch_add(1);
+    {
+        // Contato prima di entrare in coda (così m_queued non scende mai sotto zero) e sotto il lock
+        // di m_wake: un worker che sta per addormentarsi vede il compito
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_queued.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_idle.wait(lock, [this] { return m_pending.load() == 0; });
+}
+
+bool ThreadPool::popLocal(unsigned index, Task& task) {
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(unsigned thief, Task& task) {
+    const unsigned n = size();
+    for (unsigned offset = 1; offset < n; ++offset) {
+        Worker& victim = *m_workers[(thief + offset) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned index) {
+    t_pool = this;
+    t_worker = static_cast<int>(index);
+    Task task;
+    for (;;) {
+        if (popLocal(index, task) || steal(index, task)) {
+            m_queued.fetch_sub(1);
+            task();
+            task = nullptr; // rilascia le catture prima di segnalare la fine
+            if (m_pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load() > 0; });
+        if (m_stop && m_queued.load() == 0) return;
+    }
+}
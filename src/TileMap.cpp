@@ -1,7 +1,12 @@
 #include "TileMap.hpp"
-#include <iostream> // Include iostream for debug logs
+#include "Logger.hpp"
+#include <deque>
+#include <limits>
+#include <cstdlib>
 
-// Carica la mappa da file e genera le tile grafiche
+TileMap::RenderMode TileMap::s_renderMode = TileMap::RenderMode::Batched;
+
+// Carica la mappa da file e prepara la geometria dei muri
 bool TileMap::load(const std::string& filename, const sf::Vector2u& tileSize) {
     m_filename = filename; // Store filename for wall color logic
     std::ifstream file(filename);
@@ -14,53 +19,351 @@ bool TileMap::load(const std::string& filename, const sf::Vector2u& tileSize) {
             m_data.push_back(line);
     }
     file.close();
+    if (m_data.empty()) return false;
 
     m_size.x = static_cast<unsigned>(m_data[0].size());
     m_size.y = static_cast<unsigned>(m_data.size());
+    m_tileSize = tileSize;
     m_tiles.clear();
-    m_tiles.reserve(m_size.x * m_size.y);
+    buildCells();
 
-    // Crea le tile grafiche in base ai dati della mappa
+    // Solo i muri ('1') diventano geometria: corridoi, bordi e Super Pellet sono neri
+    // come lo sfondo della finestra, quindi non serve disegnarli
+    const sf::Color color = wallColor();
+    const float tw = static_cast<float>(tileSize.x), th = static_cast<float>(tileSize.y);
+    m_wallVertices.clear();
+    for (unsigned y = 0; y < m_size.y; ++y) {
+        for (unsigned x = 0; x < m_size.x; ++x) {
+            if (!isWall(x, y)) continue;
+            const sf::Vector2f topLeft{x * tw, y * th};
+            const sf::Vector2f topRight{topLeft.x + tw, topLeft.y};
+            const sf::Vector2f bottomLeft{topLeft.x, topLeft.y + th};
+            const sf::Vector2f bottomRight{topLeft.x + tw, topLeft.y + th};
+            for (const sf::Vector2f& corner : {topLeft, topRight, bottomLeft, bottomLeft, topRight, bottomRight}) {
+                m_wallVertices.append(sf::Vertex{corner, color, {}});
+            }
+        }
+    }
+    m_wallBufferDirty = true;
+
+    // Ricaricare la stessa mappa (vita persa) non ricalcola il grafo
+    if (m_data != m_graphSource) {
+        m_graphSource = m_data;
+        buildNodeGraph();
+        buildJunctionGraph();
+    }
+    return true;
+}
+
+// Colora i muri di blu chiaro, oppure viola se la mappa è map2.txt, oppure arancione se è map3.txt
+sf::Color TileMap::wallColor() const {
+    if (m_filename.find("map2.txt") != std::string::npos) {
+        return sf::Color(200, 0, 255); // viola Ms. Pac-Man
+    } else if (m_filename.find("map3.txt") != std::string::npos) {
+        return sf::Color(255, 180, 100); // arancione chiaro Ms. Pac-Man style
+    }
+    return sf::Color(0, 120, 255); // blu chiaro Pac-Man classico
+}
+
+// Vecchio percorso: una RectangleShape per ogni cella della mappa
+void TileMap::buildTiles() const {
+    m_tiles.clear();
+    m_tiles.reserve(m_size.x * m_size.y);
+    const sf::Color color = wallColor();
     for (unsigned y = 0; y < m_size.y; ++y) {
         for (unsigned x = 0; x < m_size.x; ++x) {
             sf::RectangleShape tile(
                 sf::Vector2f(
-                    static_cast<float>(tileSize.x),
-                    static_cast<float>(tileSize.y)
+                    static_cast<float>(m_tileSize.x),
+                    static_cast<float>(m_tileSize.y)
                 )
             );
             tile.setPosition(
                 sf::Vector2f(
-                    static_cast<float>(x * tileSize.x),
-                    static_cast<float>(y * tileSize.y)
+                    static_cast<float>(x * m_tileSize.x),
+                    static_cast<float>(y * m_tileSize.y)
                 )
             );
-            // Colora i muri ('1') di blu chiaro, oppure viola se la mappa è map2.txt, oppure arancione se è map3.txt
-            sf::Color wallColor = sf::Color(0, 120, 255); // blu chiaro Pac-Man classico
-            if (m_filename.find("map2.txt") != std::string::npos) {
-                wallColor = sf::Color(200, 0, 255); // viola Ms. Pac-Man
-            } else if (m_filename.find("map3.txt") != std::string::npos) {
-                wallColor = sf::Color(255, 180, 100); // arancione chiaro Ms. Pac-Man style
+            tile.setFillColor(isWall(x, y) ? color : sf::Color::Black);
+            m_tiles.push_back(tile);
+        }
+    }
+}
+
+// Flag delle celle dalla griglia di caratteri. Righe più corte della prima: le celle mancanti sono muri
+void TileMap::buildCells() {
+    const unsigned w = m_size.x, h = m_size.y;
+    auto tileAt = [&](unsigned x, unsigned y) { return x < m_data[y].size() ? m_data[y][x] : '1'; };
+    m_cells.assign(static_cast<std::size_t>(w) * h, 0);
+    bool customHouse = false;
+    for (unsigned y = 0; y < h; ++y) {
+        for (unsigned x = 0; x < w; ++x) {
+            std::uint8_t& cell = m_cells[y * w + x];
+            switch (tileAt(x, y)) {
+                case '1': cell = CELL_WALL; break;
+                case '0': cell = CELL_PELLET; break;
+                case 'S': cell = CELL_SUPER_PELLET; break;
+                case 'P': cell = CELL_PACMAN_SPAWN; break;
+                case 'G': cell = CELL_GHOST_HOUSE; customHouse = true; break;
+                case 'D': cell = CELL_DOOR; customHouse = true; break;
+                default: break;
             }
-            if (m_data[y][x] == '1') {
-                tile.setFillColor(wallColor);
-            } else if (m_data[y][x] == '2') {
-                tile.setFillColor(sf::Color::Black); // contorno nero
-            } else if (m_data[y][x] == 'S') {
-                tile.setFillColor(sf::Color::Black); // Super Pellet: sfondo nero, il disegno avviene nel main
-            } else {
-                tile.setFillColor(sf::Color::Black); // corridoio
+        }
+    }
+    // Mappe classiche: la ghost house non è segnata nel file
+    if (!customHouse) {
+        for (unsigned x = 9; x <= 11; ++x) {
+            if (x < w && 10 < h) m_cells[10 * w + x] |= CELL_GHOST_HOUSE;
+        }
+        if (10 < w && 9 < h) m_cells[9 * w + 10] |= CELL_DOOR;
+    }
+
+    // Tunnel laterali: '2' ai due bordi della riga, '1' sopra e sotto su entrambi i lati
+    for (unsigned y = 0; y < h && w > 0; ++y) {
+        bool isTunnel = (tileAt(0, y) == '2' && tileAt(w-1, y) == '2');
+        if (y > 0) isTunnel = isTunnel && (tileAt(0, y-1) == '1' && tileAt(w-1, y-1) == '1');
+        if (y < h-1) isTunnel = isTunnel && (tileAt(0, y+1) == '1' && tileAt(w-1, y+1) == '1');
+        if (isTunnel) {
+            m_cells[y * w] |= CELL_TUNNEL;
+            m_cells[y * w + w - 1] |= CELL_TUNNEL;
+        }
+    }
+
+    // Centro della ghost house: centro del rettangolo che la contiene; porta: la prima 'D', altrimenti sopra il centro
+    unsigned minX = w, minY = h, maxX = 0, maxY = 0;
+    bool hasDoor = false;
+    for (unsigned y = 0; y < h; ++y) {
+        for (unsigned x = 0; x < w; ++x) {
+            const std::uint8_t cell = m_cells[y * w + x];
+            if (cell & CELL_GHOST_HOUSE) {
+                minX = std::min(minX, x); maxX = std::max(maxX, x);
+                minY = std::min(minY, y); maxY = std::max(maxY, y);
+            }
+            if ((cell & CELL_DOOR) && !hasDoor) {
+                m_houseDoor = {x, y};
+                hasDoor = true;
             }
-            m_tiles.push_back(tile);
         }
     }
+    if (minX > maxX) {
+        // Nessuna ghost house (mappa troppo piccola): centro della mappa
+        m_houseCenter = {w / 2, h / 2};
+    } else {
+        m_houseCenter = {(minX + maxX) / 2, (minY + maxY) / 2};
+    }
+    if (!hasDoor) {
+        m_houseDoor = {m_houseCenter.x, minX > maxX || minY == 0 ? m_houseCenter.y : minY - 1};
+    }
+}
+
+bool TileMap::neighbor(int x, int y, int dir, int& nx, int& ny) const {
+    int w = static_cast<int>(m_size.x), h = static_cast<int>(m_size.y);
+    nx = x + DIR_DX[dir];
+    ny = y + DIR_DY[dir];
+    if (ny < 0 || ny >= h) return false;
+    if (nx < 0 || nx >= w) {
+        // Estremo del tunnel sul bordo da cui si esce: collegato all'estremo opposto della stessa riga
+        const int edge = (nx < 0) ? 0 : w - 1;
+        if (!(cellFlags(edge, ny) & CELL_TUNNEL)) return false;
+        nx = w - 1 - edge;
+    }
     return true;
 }
 
+int TileMap::nodeAt(int x, int y) const {
+    int w = static_cast<int>(m_size.x), h = static_cast<int>(m_size.y);
+    if (m_tileNode.empty()) return -1;
+    x = std::clamp(x, 0, w - 1);
+    y = std::clamp(y, 0, h - 1);
+    return m_tileNode[y * w + x];
+}
+
+// Nodi del grafo: le celle non-muro raggiungibili dallo spawn 'P' (ghost house compresa), in ordine di BFS.
+// Le altre celle (muri, bordi isolati) puntano al nodo più vicino in linea d'aria,
+// così anche i target di scatter negli angoli hanno una distanza valida.
+void TileMap::buildNodeGraph() {
+    const int w = static_cast<int>(m_size.x), h = static_cast<int>(m_size.y);
+    m_tileNode.assign(static_cast<std::size_t>(w) * h, -1);
+    m_nodeTile.clear();
+    m_adjacency.clear();
+
+    // Componente connessa di partenza: spawn di Pac-Man, altrimenti la prima cella percorribile
+    int start = -1;
+    for (int y = 0; y < h && start < 0; ++y)
+        for (int x = 0; x < w; ++x)
+            if (cellFlags(x, y) & CELL_PACMAN_SPAWN) { start = y * w + x; break; }
+    for (int i = 0; i < w * h && start < 0; ++i)
+        if (!isWall(i % w, i / w)) start = i;
+    if (start < 0) return;
+
+    std::deque<int> queue{start};
+    m_tileNode[start] = 0;
+    m_nodeTile.push_back(static_cast<std::uint16_t>(start));
+    while (!queue.empty()) {
+        int cur = queue.front();
+        queue.pop_front();
+        for (int d = 0; d < 4; ++d) {
+            int nx, ny;
+            if (!neighbor(cur % w, cur / w, d, nx, ny) || isWall(nx, ny)) continue;
+            int next = ny * w + nx;
+            if (m_tileNode[next] >= 0) continue;
+            if (m_nodeTile.size() >= static_cast<std::size_t>(std::numeric_limits<std::int16_t>::max())) {
+                PACMUX_LOG_ERROR("TileMap: troppe celle per il grafo dei nodi in %s", m_filename.c_str());
+                m_tileNode.clear();
+                m_nodeTile.clear();
+                return;
+            }
+            m_tileNode[next] = static_cast<std::int16_t>(m_nodeTile.size());
+            m_nodeTile.push_back(static_cast<std::uint16_t>(next));
+            queue.push_back(next);
+        }
+    }
+
+    const std::size_t n = m_nodeTile.size();
+    m_adjacency.assign(n * 4, -1);
+    for (std::size_t i = 0; i < n; ++i) {
+        int x = m_nodeTile[i] % w, y = m_nodeTile[i] / w;
+        for (int d = 0; d < 4; ++d) {
+            int nx, ny;
+            if (neighbor(x, y, d, nx, ny) && !isWall(nx, ny))
+                m_adjacency[i * 4 + d] = m_tileNode[ny * w + nx];
+        }
+    }
+
+    // Celle che non sono nodi (muri, zone isolate): nodo più vicino in linea d'aria
+    std::vector<int> nodeX(n), nodeY(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        nodeX[i] = m_nodeTile[i] % w;
+        nodeY[i] = m_nodeTile[i] / w;
+    }
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (m_tileNode[y * w + x] >= 0) continue;
+            int bestDist = std::numeric_limits<int>::max();
+            int bestNode = -1;
+            for (std::size_t i = 0; i < n; ++i) {
+                int dx = nodeX[i] - x, dy = nodeY[i] - y;
+                int d2 = dx * dx + dy * dy;
+                if (d2 < bestDist) {
+                    bestDist = d2;
+                    bestNode = static_cast<int>(i);
+                }
+            }
+            m_tileNode[y * w + x] = static_cast<std::int16_t>(bestNode);
+        }
+    }
+}
+
+int TileMap::junctionAt(int x, int y) const {
+    int w = static_cast<int>(m_size.x), h = static_cast<int>(m_size.y);
+    if (x < 0 || y < 0 || x >= w || y >= h || m_tileJunction.empty()) return -1;
+    return m_tileJunction[y * w + x];
+}
+
+bool TileMap::corridorAt(int x, int y, int& corridor, int& offset) const {
+    int w = static_cast<int>(m_size.x), h = static_cast<int>(m_size.y);
+    if (x < 0 || y < 0 || x >= w || y >= h || m_tileCorridor.empty()) return false;
+    corridor = m_tileCorridor[y * w + x];
+    offset = m_tileOffset[y * w + x];
+    return corridor >= 0;
+}
+
+// Incroci e corridoi per i fantasmi fuori dalla ghost house.
+// Ogni corridoio si percorre dritto da un incrocio finché si arriva a un altro incrocio
+// (le celle intermedie hanno esattamente due uscite opposte); viene registrato in entrambi i versi.
+void TileMap::buildJunctionGraph() {
+    const int w = static_cast<int>(m_size.x), h = static_cast<int>(m_size.y);
+    const std::size_t cells = static_cast<std::size_t>(w) * h;
+    m_junctions.clear();
+    m_corridors.clear();
+    m_tileJunction.assign(cells, -1);
+    m_tileCorridor.assign(cells, -1);
+    m_tileOffset.assign(cells, 0);
+
+    auto walkable = [&](int x, int y) { return !isWall(x, y) && !isGhostHouse(x, y); };
+    auto exitTo = [&](int x, int y, int d, int& nx, int& ny) { return neighbor(x, y, d, nx, ny) && walkable(nx, ny); };
+
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (!walkable(x, y)) continue;
+            bool open[4];
+            int count = 0;
+            for (int d = 0; d < 4; ++d) {
+                int nx, ny;
+                open[d] = exitTo(x, y, d, nx, ny);
+                count += open[d] ? 1 : 0;
+            }
+            // Corridoio dritto: su+giù oppure sinistra+destra (direzioni 0/2 e 1/3)
+            bool straight = count == 2 && ((open[0] && open[2]) || (open[1] && open[3]));
+            if (straight) continue;
+            if (m_junctions.size() >= static_cast<std::size_t>(std::numeric_limits<std::int16_t>::max())) {
+                PACMUX_LOG_ERROR("TileMap: troppi incroci in %s", m_filename.c_str());
+                m_junctions.clear();
+                m_tileJunction.assign(cells, -1);
+                return;
+            }
+            m_tileJunction[y * w + x] = static_cast<std::int16_t>(m_junctions.size());
+            m_junctions.push_back(Junction{static_cast<std::uint16_t>(y * w + x), {-1, -1, -1, -1}});
+        }
+    }
+
+    for (std::size_t j = 0; j < m_junctions.size(); ++j) {
+        const int startX = m_junctions[j].tile % w, startY = m_junctions[j].tile / w;
+        for (int d = 0; d < 4; ++d) {
+            int x = startX, y = startY, nx, ny;
+            if (!exitTo(x, y, d, nx, ny)) continue;
+            const int index = static_cast<int>(m_corridors.size());
+            bool tunnel = false;
+            int length = 0;
+            // Limite di sicurezza: un corridoio non può essere più lungo della mappa intera
+            while (length < w * h) {
+                ++length;
+                tunnel = tunnel || std::abs(nx - x) > 1;
+                x = nx;
+                y = ny;
+                if (m_tileJunction[y * w + x] >= 0) break;
+                if (m_tileCorridor[y * w + x] < 0) {
+                    m_tileCorridor[y * w + x] = static_cast<std::int16_t>(index);
+                    m_tileOffset[y * w + x] = static_cast<std::uint16_t>(length);
+                }
+                if (!exitTo(x, y, d, nx, ny)) break; // non succede: le celle non incrocio sono dritte
+            }
+            if (m_tileJunction[y * w + x] < 0) continue;
+            m_corridors.push_back(Corridor{static_cast<std::uint16_t>(j), static_cast<std::uint16_t>(m_tileJunction[y * w + x]),
+                                           static_cast<std::uint16_t>(length), -1, static_cast<std::uint8_t>(d), tunnel});
+            m_junctions[j].exits[d] = static_cast<std::int16_t>(index);
+        }
+    }
+    // Il verso opposto parte dall'incrocio di arrivo nella direzione opposta
+    for (Corridor& corridor : m_corridors) {
+        corridor.reverse = m_junctions[corridor.to].exits[(corridor.dir + 2) % 4];
+    }
+}
+
 // Disegna la mappa sulla finestra
 void TileMap::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     states.transform *= getTransform();
-    for (const auto& tile : m_tiles) {
-        target.draw(tile, states);
+    if (s_renderMode == RenderMode::PerTile) {
+        if (m_tiles.empty()) buildTiles();
+        for (const auto& tile : m_tiles) {
+            target.draw(tile, states);
+        }
+        return;
+    }
+    // Muri in memoria GPU statica se disponibile, altrimenti dal vertex array
+    if (sf::VertexBuffer::isAvailable()) {
+        if (m_wallBufferDirty) {
+            m_wallBufferDirty = false;
+            if (!m_wallBuffer.create(m_wallVertices.getVertexCount()) ||
+                (m_wallVertices.getVertexCount() > 0 && !m_wallBuffer.update(&m_wallVertices[0]))) {
+                PACMUX_LOG_WARNING("TileMap: impossibile creare il vertex buffer, uso il vertex array");
+                m_wallBuffer = sf::VertexBuffer(sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static);
+            }
+        }
+        if (m_wallBuffer.getVertexCount() == m_wallVertices.getVertexCount()) {
+            target.draw(m_wallBuffer, states);
+            return;
+        }
     }
+    target.draw(m_wallVertices, states);
 }
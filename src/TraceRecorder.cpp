@@ -0,0 +1,148 @@
+#include "TraceRecorder.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using TraceClock = std::chrono::steady_clock;
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    char phase;
+    std::uint32_t tid;
+    double ts; // microsecondi dall'avvio della traccia
+};
+
+// Stato della traccia in corso (uno per processo)
+struct TraceState {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<TraceEvent> pending;  // accodati dai thread, svuotati dallo scrittore
+    std::FILE* file = nullptr;
+    std::thread writer;
+    bool stopping = false;
+    bool first = true;                // nessun evento ancora scritto (virgole del JSON)
+    std::atomic<std::uint64_t> written{0};
+    TraceClock::time_point start;
+    std::atomic<std::uint32_t> nextTid{1};
+};
+
+TraceState& state() {
+    static TraceState s;
+    return s;
+}
+
+// Id piccoli e stabili per thread, più leggibili di std::thread::id
+std::uint32_t currentTid() {
+    static thread_local std::uint32_t tid = state().nextTid.fetch_add(1, std::memory_order_relaxed);
+    return tid;
+}
+
+// Le stringhe sono letterali del programma: basta evitare virgolette e barre rovesciate
+void writeString(std::FILE* file, const char* str) {
+    std::fputc('"', file);
+    for (const char* c = str; *c; ++c) {
+        if (*c == '"' || *c == '\\') std::fputc('\\', file);
+        std::fputc(*c, file);
+    }
+    std::fputc('"', file);
+}
+
+void writeEvents(TraceState& s, const std::vector<TraceEvent>& events) {
+    for (const TraceEvent& e : events) {
+        std::fputs(s.first ? "\n" : ",\n", s.file);
+        s.first = false;
+        if (e.phase == 'M') {
+            std::fprintf(s.file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", e.tid);
+            writeString(s.file, e.name);
+            std::fputs("}}", s.file);
+            continue;
+        }
+        std::fputs("{\"name\":", s.file);
+        writeString(s.file, e.name);
+        std::fputs(",\"cat\":", s.file);
+        writeString(s.file, e.category);
+        std::fprintf(s.file, ",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", e.phase, e.tid, e.ts);
+    }
+    s.written.fetch_add(events.size(), std::memory_order_relaxed);
+}
+
+} // namespace
+
+std::atomic<bool> TraceRecorder::s_enabled{false};
+
+bool TraceRecorder::start(const std::string& path) {
+    stop();
+    TraceState& s = state();
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.file = file;
+        s.stopping = false;
+        s.first = true;
+        s.written.store(0, std::memory_order_relaxed);
+        s.pending.clear();
+        s.pending.reserve(4096);
+        s.start = TraceClock::now();
+    }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    s.writer = std::thread(&TraceRecorder::writerLoop);
+    s_enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void TraceRecorder::stop() {
+    TraceState& s = state();
+    s_enabled.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.file) return;
+        s.stopping = true;
+    }
+    s.wake.notify_one();
+    s.writer.join();
+    // Eventi accodati mentre lo scrittore usciva
+    writeEvents(s, s.pending);
+    s.pending.clear();
+    std::fputs("\n]}\n", s.file);
+    std::fclose(s.file);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.file = nullptr;
+}
+
+std::uint64_t TraceRecorder::getWrittenCount() {
+    return state().written.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::record(char phase, const char* name, const char* category) {
+    TraceState& s = state();
+    const std::uint32_t tid = currentTid();
+    const TraceClock::time_point now = TraceClock::now();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.file || s.stopping) return;
+    const double ts = std::chrono::duration<double, std::micro>(now - s.start).count();
+    s.pending.push_back(TraceEvent{name, category, phase, tid, ts});
+}
+
+void TraceRecorder::writerLoop() {
+    TraceState& s = state();
+    std::vector<TraceEvent> batch;
+    batch.reserve(4096);
+    std::unique_lock<std::mutex> lock(s.mutex);
+    while (!s.stopping) {
+        s.wake.wait_for(lock, std::chrono::milliseconds(100), [&] { return s.stopping; });
+        // Scambia i vettori: chi registra continua subito su quello vuoto (con la sua capacità)
+        batch.swap(s.pending);
+        lock.unlock();
+        writeEvents(s, batch);
+        std::fflush(s.file);
+        batch.clear();
+        lock.lock();
+    }
+}
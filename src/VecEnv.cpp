@@ -0,0 +1,181 @@
+#include "VecEnv.hpp"
+#include "SpriteSheet.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cstring>
+
+static constexpr unsigned TASKS_PER_WORKER = 4; // blocchi più piccoli: i reset costano più degli step
+
+// Cella della posizione (pixel) in una griglia w x h; false fuori (es. a metà di un tunnel)
+static bool cellOf(const sf::Vector2f& pos, const sf::Vector2u& tileSize, unsigned w, unsigned h,
+                   unsigned& x, unsigned& y) {
+    if (pos.x < 0.f || pos.y < 0.f) return false;
+    x = static_cast<unsigned>(pos.x / tileSize.x);
+    y = static_cast<unsigned>(pos.y / tileSize.y);
+    return x < w && y < h;
+}
+
+VecEnv::VecEnv(const GameSimulation::Config& simConfig, const Config& config)
+    : m_simConfig(simConfig), m_config(config)
+{
+    // Come l'Autopilot: niente texture sui thread delle simulazioni (HeadlessScope),
+    // senza spegnere l'atlas di un eventuale gioco nello stesso processo
+    m_simConfig.headless = false;
+    m_config.envs = std::max(1u, m_config.envs);
+    m_config.actionTicks = std::max(1u, m_config.actionTicks);
+
+    // Dimensioni dell'osservazione: la mappa più grande; il piano dei muri di ogni livello si prepara qui
+    std::vector<TileMap> maps(m_simConfig.mapFiles.size());
+    for (std::size_t level = 0; level < maps.size(); ++level) {
+        if (!maps[level].load(m_simConfig.mapFiles[level], m_simConfig.tileSize)) continue;
+        m_width = std::max(m_width, maps[level].getSize().x);
+        m_height = std::max(m_height, maps[level].getSize().y);
+    }
+    m_wallPlanes.resize(maps.size());
+    for (std::size_t level = 0; level < maps.size(); ++level) {
+        std::vector<float>& plane = m_wallPlanes[level];
+        plane.assign(std::size_t(m_width) * m_height, 1.f);
+        const sf::Vector2u size = maps[level].getSize();
+        for (unsigned y = 0; y < size.y; ++y) {
+            for (unsigned x = 0; x < size.x; ++x) {
+                plane[std::size_t(y) * m_width + x] = maps[level].isWall(x, y) ? 1.f : 0.f;
+            }
+        }
+    }
+
+    if (m_config.threads != 1) {
+        m_pool = std::make_unique<ThreadPool>(m_config.threads);
+    }
+    const unsigned tasks = getWorkerCount() * TASKS_PER_WORKER;
+    m_chunk = std::max(1u, (m_config.envs + tasks - 1) / tasks);
+
+    SpriteSheet::HeadlessScope headless;
+    m_envs.resize(m_config.envs);
+    for (Env& env : m_envs) {
+        env.sim = std::make_unique<GameSimulation>(m_simConfig);
+    }
+}
+
+VecEnv::~VecEnv() = default;
+
+unsigned VecEnv::getWorkerCount() const {
+    return m_pool ? m_pool->size() : 1u;
+}
+
+void VecEnv::reset(float* obs) {
+    m_obs = obs;
+    m_resetting = true;
+    for (Env& env : m_envs) {
+        env.episode = 0;
+    }
+    dispatch();
+}
+
+void VecEnv::step(const std::int32_t* actions, float* obs, float* rewards, std::uint8_t* dones) {
+    m_actions = actions;
+    m_obs = obs;
+    m_rewards = rewards;
+    m_dones = dones;
+    m_resetting = false;
+    dispatch();
+    m_steps += m_config.envs;
+    for (unsigned i = 0; i < m_config.envs; ++i) {
+        m_episodes += dones[i];
+    }
+}
+
+void VecEnv::dispatch() {
+    if (!m_pool) {
+        runRange(0, m_config.envs);
+        return;
+    }
+    for (unsigned first = 0; first < m_config.envs; first += m_chunk) {
+        const unsigned last = std::min(m_config.envs, first + m_chunk);
+        m_pool->submit([this, first, last] { runRange(first, last); });
+    }
+    m_pool->wait();
+}
+
+void VecEnv::runRange(unsigned first, unsigned last) {
+    SpriteSheet::HeadlessScope headless;
+    for (unsigned i = first; i < last; ++i) {
+        if (m_resetting) {
+            resetEnv(i);
+        } else {
+            stepEnv(i);
+        }
+        writeObservation(i);
+    }
+}
+
+void VecEnv::resetEnv(unsigned index) {
+    Env& env = m_envs[index];
+    env.sim->newGame(m_config.seed + index + env.episode * m_config.envs);
+    env.steps = 0;
+    env.lastScore = 0;
+}
+
+void VecEnv::stepEnv(unsigned index) {
+    Env& env = m_envs[index];
+    GameSimulation& sim = *env.sim;
+    const std::int32_t action = m_actions[index];
+    SimInput input;
+    if (action >= ACTION_UP && action <= ACTION_RIGHT) {
+        input.direction = {float(TileMap::DIR_DX[action]), float(TileMap::DIR_DY[action])};
+    }
+
+    std::uint32_t events = 0;
+    for (unsigned t = 0; t < m_config.actionTicks && !sim.isGameOver() && !(events & GameSimulation::LevelLoadFailed); ++t) {
+        sim.step(GameSimulation::TICK, input);
+        events |= sim.getEvents();
+    }
+    ++env.steps;
+    // Punteggio dello step (pellet, super pellet, fantasmi in combo, frutti, con le regole della simulazione)
+    const unsigned score = sim.getScore();
+    m_rewards[index] = float(score - env.lastScore);
+    env.lastScore = score;
+
+    const bool done = sim.isGameOver() || (events & GameSimulation::LevelLoadFailed) ||
+                      (m_config.maxEpisodeSteps > 0 && env.steps >= m_config.maxEpisodeSteps);
+    m_dones[index] = done ? 1 : 0;
+    if (done) {
+        env.last = Episode{score, env.steps, sim.getLevel(), sim.getDifficulty()};
+        ++env.episode;
+        resetEnv(index);
+    }
+}
+
+void VecEnv::writeObservation(unsigned index) const {
+    const std::size_t planeSize = std::size_t(m_width) * m_height;
+    float* obs = m_obs + index * obsSize();
+    std::memset(obs, 0, obsSize() * sizeof(float));
+    auto plane = [&](int p) { return obs + p * planeSize; };
+
+    const GameSimulation& sim = *m_envs[index].sim;
+    const int level = sim.getLevel();
+    if (level >= 0 && std::size_t(level) < m_wallPlanes.size()) {
+        std::memcpy(plane(PLANE_WALL), m_wallPlanes[level].data(), planeSize * sizeof(float));
+    }
+
+    float* pellets = plane(PLANE_PELLET);
+    sim.getPellets().forEach([&](unsigned x, unsigned y) { pellets[std::size_t(y) * m_width + x] = 1.f; });
+    float* superPellets = plane(PLANE_SUPER_PELLET);
+    sim.getSuperPellets().forEach([&](unsigned x, unsigned y) { superPellets[std::size_t(y) * m_width + x] = 1.f; });
+
+    const sf::Vector2u tileSize = sim.getTileSize();
+    unsigned x, y;
+    if (cellOf(sim.getPlayer().getPosition(), tileSize, m_width, m_height, x, y)) {
+        plane(PLANE_PACMAN)[std::size_t(y) * m_width + x] = 1.f;
+    }
+    for (const auto& ghost : sim.getGhosts()) {
+        if (ghost->isEaten() || !cellOf(ghost->getPosition(), tileSize, m_width, m_height, x, y)) continue;
+        const std::size_t cell = std::size_t(y) * m_width + x;
+        plane(PLANE_BLINKY + static_cast<int>(ghost->getType()))[cell] = 1.f;
+        if (ghost->isFrightened()) plane(PLANE_FRIGHTENED)[cell] = 1.f;
+    }
+    for (const Fruit& fruit : sim.getFruits()) {
+        if (cellOf(fruit.getCenter(), tileSize, m_width, m_height, x, y)) {
+            plane(PLANE_FRUIT)[std::size_t(y) * m_width + x] = 1.f;
+        }
+    }
+}
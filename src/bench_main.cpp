@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <filesystem>
+
+#include "GameSimulation.hpp"
+#include "Autopilot.hpp"
+#include "ThreadPool.hpp"
+#include "VecEnv.hpp"
+#include "Logger.hpp"
+#include "SpriteSheet.hpp"
+
+// =========================
+// pacmux_bench: partite headless in parallelo
+// =========================
+// Uso: pacmux_bench [--games N] [--threads T] [--seed S] [--input greedy|random|mcts] [--mcts-iterations I]
+//                   [--max-seconds S] [--chunk C] [--maps <cartella>] [--csv <file>] [--no-profile] [--scaling]
+//                   [--verbose] [--vecenv K] [--env-steps N]
+// Gioca N partite indipendenti (seme S, S+1, ...) su un pool con work stealing, ognuna con l'input
+// scelto, e riporta tick simulati al secondo, partite al secondo, tempo per sottosistema e l'esito
+// delle partite (punteggio, livello e difficoltà raggiunti) per tarare la curva di difficoltà.
+// Con --input mcts gioca l'Autopilot (I iterazioni per scelta, sul thread della partita): soak test
+// con un giocatore che sopravvive a lungo.
+// Con --scaling ripete lo stesso lotto con 1, 2, 4, ... thread e mostra lo speedup.
+// Con --vecenv K misura invece il VecEnv: K partite in lockstep, N step con azioni casuali,
+// e riporta gli step di ambiente al secondo (la metrica del training).
+// =========================
+
+enum class InputMode { Greedy, Random, Mcts };
+
+struct BenchOptions {
+    unsigned games = 1000;
+    unsigned threads = 0;            // 0 = un thread per core
+    std::uint32_t seed = 1;
+    InputMode input = InputMode::Greedy;
+    std::uint32_t mctsIterations = 200; // iterazioni dell'Autopilot per scelta (--input mcts)
+    float maxSeconds = 600.f;        // tempo simulato massimo per partita
+    unsigned chunk = 8;              // partite per compito del pool
+    std::string mapDir = "assets";
+    std::string csvPath;
+    bool profile = true;
+    bool scaling = false;
+    bool verbose = false;
+    unsigned vecEnvs = 0;            // --vecenv: partite del VecEnv (0 = benchmark delle partite)
+    unsigned envSteps = 10000;       // step del VecEnv
+};
+
+struct GameResult {
+    std::uint32_t seed = 0;
+    std::uint64_t ticks = 0;
+    unsigned score = 0;
+    int level = 0;
+    int difficulty = 0;
+    int lives = 0;
+    bool gameOver = false;
+    bool loaded = false;
+};
+
+struct BatchResult {
+    std::vector<GameResult> games;
+    GameSimulation::SubsystemTimes times;
+    double wallSeconds = 0.0;
+    std::uint64_t steals = 0;
+    std::uint64_t flowFieldBuilds = 0;
+    std::uint64_t autopilotSearches = 0; // ricerche dell'Autopilot (--input mcts)
+    std::uint64_t autopilotTicks = 0;    // tick simulati da quelle ricerche
+    unsigned threads = 0;
+};
+
+// --- Politiche di input ---
+// Stesso modulo diretto della simulazione sull'uscita di mt19937: esiti identici su ogni libreria standard
+struct InputPolicy {
+    std::mt19937 rng;
+    bool greedy = true;
+    sf::Vector2f heading{0.f, 0.f};
+    int lastTile = -1;
+    unsigned ticksLeft = 0;
+
+    explicit InputPolicy(std::uint32_t seed, bool greedyInput) : rng(seed ^ 0x9E3779B9u), greedy(greedyInput) {}
+
+    static sf::Vector2f direction(int dir) {
+        return {float(TileMap::DIR_DX[dir]), float(TileMap::DIR_DY[dir])};
+    }
+
+    // Casuale: una direzione qualsiasi, tenuta per 15..74 tick
+    SimInput random() {
+        if (ticksLeft == 0) {
+            heading = direction(static_cast<int>(rng() % 4));
+            ticksLeft = 15 + rng() % 60;
+        }
+        --ticksLeft;
+        return SimInput{heading};
+    }
+
+    // Greedy: a ogni cella nuova va verso un pellet adiacente, altrimenti prosegue;
+    // contro un muro sceglie a caso tra le uscite, evitando se può di tornare indietro
+    SimInput greedyStep(const GameSimulation& sim) {
+        const TileMap& map = sim.getMap();
+        const sf::Vector2u tileSize = sim.getTileSize();
+        const sf::Vector2f pos = sim.getPlayer().getPosition();
+        if (pos.x < 0.f || pos.y < 0.f) return SimInput{heading};
+        const int x = static_cast<int>(pos.x / tileSize.x);
+        const int y = static_cast<int>(pos.y / tileSize.y);
+        const int tile = y * static_cast<int>(map.getSize().x) + x;
+        if (tile == lastTile && heading != sf::Vector2f{0.f, 0.f}) return SimInput{heading};
+        lastTile = tile;
+
+        int open[4], pellet[4];
+        int openCount = 0, pelletCount = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx, ny;
+            if (!map.neighbor(x, y, dir, nx, ny) || map.isWall(nx, ny) || map.isGhostHouse(nx, ny)) continue;
+            open[openCount++] = dir;
+            if (sim.getPellets().has(nx, ny) || sim.getSuperPellets().has(nx, ny)) pellet[pelletCount++] = dir;
+        }
+        if (openCount == 0) return SimInput{heading};
+
+        auto keeps = [&](const int* dirs, int count) {
+            for (int i = 0; i < count; ++i) {
+                if (direction(dirs[i]) == heading) return true;
+            }
+            return false;
+        };
+        if (pelletCount > 0) {
+            if (!keeps(pellet, pelletCount)) heading = direction(pellet[rng() % pelletCount]);
+        } else if (!keeps(open, openCount)) {
+            int forward[4];
+            int forwardCount = 0;
+            for (int i = 0; i < openCount; ++i) {
+                if (direction(open[i]) != -heading) forward[forwardCount++] = open[i];
+            }
+            heading = forwardCount > 0 ? direction(forward[rng() % forwardCount]) : direction(open[rng() % openCount]);
+        }
+        return SimInput{heading};
+    }
+
+    SimInput next(const GameSimulation& sim) { return greedy ? greedyStep(sim) : random(); }
+};
+
+static const char* inputName(InputMode input) {
+    switch (input) {
+        case InputMode::Random: return "casuale";
+        case InputMode::Mcts:   return "mcts";
+        default:                return "greedy";
+    }
+}
+
+// pilot: solo con --input mcts
+static GameResult playGame(GameSimulation& sim, Autopilot* pilot, std::uint32_t seed, const BenchOptions& options) {
+    GameResult result;
+    result.seed = seed;
+    if (!sim.newGame(seed)) return result;
+    result.loaded = true;
+
+    InputPolicy policy(seed, options.input != InputMode::Random);
+    if (pilot) pilot->reset(seed);
+    const std::uint64_t maxTicks = static_cast<std::uint64_t>(options.maxSeconds / GameSimulation::TICK);
+    while (!sim.isGameOver() && sim.getTick() < maxTicks) {
+        sim.step(GameSimulation::TICK, pilot ? pilot->next(sim) : policy.next(sim));
+    }
+    result.ticks = sim.getTick();
+    result.score = sim.getScore();
+    result.level = sim.getLevel();
+    result.difficulty = sim.getDifficulty();
+    result.lives = std::max(sim.getLives(), 0);
+    result.gameOver = sim.isGameOver();
+    return result;
+}
+
+static BatchResult runBatch(const BenchOptions& options, unsigned threads) {
+    GameSimulation::Config config;
+    config.headless = true;
+    for (const char* mapFile : {"map1.txt", "map2.txt", "map3.txt"}) {
+        config.mapFiles.push_back((std::filesystem::path(options.mapDir) / mapFile).string());
+    }
+
+    BatchResult batch;
+    batch.games.resize(options.games);
+
+    ThreadPool pool(threads);
+    batch.threads = pool.size();
+    // Una simulazione per worker, riusata tra le partite: mappe e cache dei campi di flusso restano calde
+    std::vector<std::unique_ptr<GameSimulation>> sims(pool.size());
+    // Con --input mcts anche un Autopilot per worker, a un solo thread (il parallelismo è tra le partite)
+    std::vector<std::unique_ptr<Autopilot>> pilots(pool.size());
+    Autopilot::Config pilotConfig;
+    pilotConfig.threads = 1;
+    pilotConfig.budgetSeconds = 0.f; // solo iterazioni: partite riproducibili
+    pilotConfig.maxIterations = options.mctsIterations;
+
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned chunk = std::max(1u, options.chunk);
+    for (unsigned first = 0; first < options.games; first += chunk) {
+        const unsigned last = std::min(options.games, first + chunk);
+        pool.submit([&, first, last] {
+            const auto worker = static_cast<std::size_t>(ThreadPool::currentWorker());
+            auto& sim = sims[worker];
+            if (!sim) {
+                sim = std::make_unique<GameSimulation>(config);
+                sim->setProfiling(options.profile);
+            }
+            auto& pilot = pilots[worker];
+            if (!pilot && options.input == InputMode::Mcts) {
+                pilot = std::make_unique<Autopilot>(config, pilotConfig);
+            }
+            for (unsigned i = first; i < last; ++i) {
+                batch.games[i] = playGame(*sim, pilot.get(), options.seed + i, options);
+            }
+        });
+    }
+    pool.wait();
+    batch.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    batch.steals = pool.getStealCount();
+    for (const auto& sim : sims) {
+        if (!sim) continue;
+        batch.times += sim->getSubsystemTimes();
+        batch.flowFieldBuilds += sim->getFlowFieldBuilds();
+    }
+    for (const auto& pilot : pilots) {
+        if (!pilot) continue;
+        batch.autopilotSearches += pilot->getSearchCount();
+        batch.autopilotTicks += pilot->getSimulatedTicks();
+    }
+    return batch;
+}
+
+static std::uint64_t totalTicks(const BatchResult& batch) {
+    std::uint64_t ticks = 0;
+    for (const GameResult& game : batch.games) ticks += game.ticks;
+    return ticks;
+}
+
+static void printBatch(const BatchResult& batch, const BenchOptions& options, std::ostream& out) {
+    const std::uint64_t ticks = totalTicks(batch);
+    const double simSeconds = ticks * double(GameSimulation::TICK);
+    out << std::fixed << std::setprecision(1);
+    out << "[BENCH] " << batch.games.size() << " partite, " << batch.threads << " thread, input "
+              << inputName(options.input) << ", semi " << options.seed << ".."
+              << options.seed + options.games - 1 << std::endl;
+    out << "[BENCH] " << ticks << " tick (" << simSeconds << " s simulati) in " << batch.wallSeconds
+              << " s reali, compiti rubati tra code: " << batch.steals << std::endl;
+    out << "[BENCH] " << ticks / batch.wallSeconds << " tick/s, " << batch.games.size() / batch.wallSeconds
+              << " partite/s, " << simSeconds / batch.wallSeconds << "x tempo reale" << std::endl;
+
+    if (options.profile) {
+        const GameSimulation::SubsystemTimes& t = batch.times;
+        const double total = std::max(t.total(), 1e-12);
+        auto line = [&](const char* name, double seconds) {
+            out << "[BENCH]   " << std::left << std::setw(11) << name << std::right << std::setw(9)
+                      << seconds * 1000.0 << " ms  " << std::setw(5) << 100.0 * seconds / total << "%  "
+                      << std::setw(8) << seconds * 1e9 / std::max<std::uint64_t>(ticks, 1) << " ns/tick" << std::endl;
+        };
+        out << "[BENCH] sottosistemi (somma su tutti i thread):" << std::endl;
+        line("pacman", t.player);
+        line("fantasmi", t.ghosts);
+        line("pellet", t.pellets);
+        line("frutti", t.fruits);
+        line("collisioni", t.collisions);
+        line("livelli", t.levelLoad);
+    }
+    out << "[BENCH] campi di flusso dei fantasmi: " << batch.flowFieldBuilds << " BFS, una ogni "
+        << double(ticks) / std::max<std::uint64_t>(batch.flowFieldBuilds, 1) << " tick" << std::endl;
+    if (batch.autopilotSearches > 0) {
+        out << "[BENCH] autopilota: " << batch.autopilotSearches << " ricerche, " << batch.autopilotTicks
+            << " tick simulati (" << double(batch.autopilotTicks) / batch.autopilotSearches << " per ricerca, "
+            << batch.autopilotTicks / batch.wallSeconds << " tick/s)" << std::endl;
+    }
+
+    // Esito delle partite: su questo si tara la curva di difficoltà
+    std::map<int, unsigned> byDifficulty;
+    double scoreSum = 0.0, levelSum = 0.0;
+    unsigned over = 0, failed = 0;
+    for (const GameResult& game : batch.games) {
+        if (!game.loaded) {
+            ++failed;
+            continue;
+        }
+        scoreSum += game.score;
+        levelSum += (game.difficulty - 1) * 3 + game.level + 1;
+        ++byDifficulty[game.difficulty];
+        if (game.gameOver) ++over;
+    }
+    const unsigned played = static_cast<unsigned>(batch.games.size()) - failed;
+    if (played > 0) {
+        out << "[BENCH] punteggio medio " << scoreSum / played << ", livelli giocati in media "
+                  << levelSum / played << ", game over " << over << "/" << played << std::endl;
+        out << "[BENCH] difficoltà raggiunta:";
+        for (const auto& [difficulty, count] : byDifficulty) {
+            out << "  " << difficulty << ": " << count;
+        }
+        out << std::endl;
+    }
+    if (failed > 0) {
+        out << "[BENCH] " << failed << " partite non avviate: mappe non trovate in " << options.mapDir << std::endl;
+    }
+}
+
+static bool writeCsv(const BatchResult& batch, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "seed,ticks,score,level,difficulty,lives,game_over\n";
+    for (const GameResult& game : batch.games) {
+        out << game.seed << ',' << game.ticks << ',' << game.score << ',' << game.level + 1 << ','
+            << game.difficulty << ',' << game.lives << ',' << (game.gameOver ? 1 : 0) << '\n';
+    }
+    return bool(out);
+}
+
+// Stesso lotto con un numero crescente di thread; gli esiti devono essere identici
+static void printScaling(const BenchOptions& options, std::ostream& out) {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned n = 1; n < cores; n *= 2) counts.push_back(n);
+    counts.push_back(cores);
+
+    out << std::fixed;
+    out << "[BENCH] scaling su " << options.games << " partite (" << cores << " core)" << std::endl;
+    out << "[BENCH] thread     tick/s   speedup  efficienza" << std::endl;
+    double baseRate = 0.0;
+    std::uint64_t baseTicks = 0;
+    for (unsigned threads : counts) {
+        const BatchResult batch = runBatch(options, threads);
+        const std::uint64_t ticks = totalTicks(batch);
+        const double rate = ticks / batch.wallSeconds;
+        if (baseRate == 0.0) {
+            baseRate = rate;
+            baseTicks = ticks;
+        }
+        const double speedup = rate / baseRate;
+        out << "[BENCH] " << std::setw(6) << threads << std::setw(11) << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2) << speedup << "x" << std::setw(10) << std::setprecision(0)
+                  << 100.0 * speedup / threads << "%" << std::endl;
+        if (ticks != baseTicks) {
+            out << "[BENCH] ATTENZIONE: " << ticks << " tick invece di " << baseTicks
+                      << ", le partite non sono deterministiche" << std::endl;
+        }
+    }
+}
+
+// VecEnv: step in lockstep con azioni casuali (cambiano in media ogni 4 step) in buffer allocati una volta
+static void runVecEnv(const BenchOptions& options, std::ostream& out) {
+    GameSimulation::Config simConfig;
+    for (const char* mapFile : {"map1.txt", "map2.txt", "map3.txt"}) {
+        simConfig.mapFiles.push_back((std::filesystem::path(options.mapDir) / mapFile).string());
+    }
+    VecEnv::Config config;
+    config.envs = options.vecEnvs;
+    config.threads = options.threads;
+    config.seed = options.seed;
+    config.maxEpisodeSteps = static_cast<std::uint32_t>(options.maxSeconds / (config.actionTicks * GameSimulation::TICK));
+    VecEnv env(simConfig, config);
+
+    std::vector<float> obs(env.size() * env.obsSize());
+    std::vector<float> rewards(env.size());
+    std::vector<std::uint8_t> dones(env.size());
+    std::vector<std::int32_t> actions(env.size(), VecEnv::ACTION_NONE);
+    Pcg32 rng(options.seed);
+    env.reset(obs.data());
+
+    double rewardSum = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned s = 0; s < options.envSteps; ++s) {
+        for (std::int32_t& action : actions) {
+            if (action == VecEnv::ACTION_NONE || rng() % 4 == 0) action = static_cast<std::int32_t>(rng() % 4);
+        }
+        env.step(actions.data(), obs.data(), rewards.data(), dones.data());
+        for (float r : rewards) rewardSum += r;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double steps = double(env.getStepCount());
+
+    out << std::fixed << std::setprecision(1);
+    out << "[BENCH] VecEnv: " << env.size() << " partite, " << env.getWorkerCount() << " thread, "
+        << VecEnv::PLANE_COUNT << " piani " << env.width() << "x" << env.height() << ", "
+        << config.actionTicks << " tick per step" << std::endl;
+    out << "[BENCH] " << env.getStepCount() << " step in " << seconds << " s: " << steps / seconds
+        << " step/s, " << steps * config.actionTicks / seconds << " tick/s, "
+        << seconds * 1e6 / options.envSteps << " us per step del lotto" << std::endl;
+    out << "[BENCH] " << env.getEpisodeCount() << " episodi finiti, ricompensa media per step "
+        << rewardSum / std::max(steps, 1.0) << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue)
+            options.games = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--threads" && hasValue)
+            options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--seed" && hasValue)
+            options.seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--input" && hasValue)
+        {
+            const std::string input = argv[++i];
+            options.input = input == "random" ? InputMode::Random : input == "mcts" ? InputMode::Mcts : InputMode::Greedy;
+        }
+        else if (arg == "--mcts-iterations" && hasValue)
+            options.mctsIterations = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--max-seconds" && hasValue)
+            options.maxSeconds = std::stof(argv[++i]);
+        else if (arg == "--chunk" && hasValue)
+            options.chunk = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--maps" && hasValue)
+            options.mapDir = argv[++i];
+        else if (arg == "--csv" && hasValue)
+            options.csvPath = argv[++i];
+        else if (arg == "--no-profile")
+            options.profile = false;
+        else if (arg == "--scaling")
+            options.scaling = true;
+        else if (arg == "--verbose")
+            options.verbose = true;
+        else if (arg == "--vecenv" && hasValue)
+            options.vecEnvs = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--env-steps" && hasValue)
+            options.envSteps = static_cast<unsigned>(std::stoul(argv[++i]));
+        else
+        {
+            std::cerr << "Uso: " << argv[0] << " [--games N] [--threads T] [--seed S] [--input greedy|random|mcts]"
+                      << " [--mcts-iterations I]"
+                      << " [--max-seconds S] [--chunk C] [--maps <cartella>] [--csv <file>] [--no-profile]"
+                      << " [--scaling] [--verbose] [--vecenv K] [--env-steps N]" << std::endl;
+            return 2;
+        }
+    }
+
+    // I log di debug di Pac-Man e dei fantasmi costerebbero più della simulazione: senza --verbose
+    // restano solo avvisi ed errori. Il riepilogo va direttamente su std::cout
+    Logger::setLevel(options.verbose ? Logger::Debug : Logger::Warning);
+    std::ostream& out = std::cout;
+
+    if (options.vecEnvs > 0)
+    {
+        runVecEnv(options, out);
+        return 0;
+    }
+
+    if (options.scaling)
+    {
+        BenchOptions quiet = options;
+        quiet.profile = false;
+        printScaling(quiet, out);
+        return 0;
+    }
+
+    const BatchResult batch = runBatch(options, options.threads);
+    printBatch(batch, options, out);
+
+    if (!options.csvPath.empty())
+    {
+        if (!writeCsv(batch, options.csvPath))
+        {
+            std::cerr << "[BENCH] Impossibile scrivere " << options.csvPath << std::endl;
+            return 1;
+        }
+        out << "[BENCH] esiti per partita in " << options.csvPath << std::endl;
+    }
+    // Simulazioni headless: nessuna decodifica del PNG, nemmeno durante la costruzione di Player e fantasmi
+    if (SpriteSheet::getDecodeCount() != 0)
+    {
+        std::cerr << "[BENCH] " << SpriteSheet::getDecodeCount() << " decodifiche dell'atlas in modalità headless" << std::endl;
+        return 1;
+    }
+    bool anyFailed = std::any_of(batch.games.begin(), batch.games.end(), [](const GameResult& g) { return !g.loaded; });
+    return anyFailed ? 1 : 0;
+}
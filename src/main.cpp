@@ -5,31 +5,52 @@
 #include <vector>
 #include <memory>
 #include <string>
-#include <iostream>  // Per il log di debug
+#include <cstdio>    // Per std::snprintf
+#include <algorithm> // Per std::min
 #include <cstdint>   // Per std::uint32_t
 #include <cctype>    // Per std::isalnum, std::toupper
-#include <random>    // Per RNG spawn frutti casuali
+#include <random>    // Per il seme della simulazione
+#include <fstream>   // Per la registrazione del replay
 #include <optional>  // Per std::optional usato con pollEvent
-#include <algorithm> // Per std::find_if
-#include <cmath>     // Per std::pow, std::sin, std::abs
+#include <cmath>     // Per std::sin, std::abs
+#include <cstdlib>   // Per std::atexit (chiusura della traccia)
 
-#include "TileMap.hpp"
-#include "Player.hpp"
-#include "Pellet.hpp"
-#include "Fruit.hpp"
+#include "GameSimulation.hpp"
+#include "Autopilot.hpp"
 #include "Score.hpp"
 #include "HighScore.hpp"
 #include "GlobalLeaderboard.hpp"
-#include "Blinky.hpp"
-#include "Pinky.hpp"
-#include "Inky.hpp"
-#include "Clyde.hpp"
+#include "TextCache.hpp"
+#include "SpriteBatch.hpp"
+#include "StaticLayer.hpp"
+#include "FrameProfiler.hpp"
+#include "TraceRecorder.hpp"
+#include "Logger.hpp"
+#include "AudioManager.hpp"
+#include "AssetLoader.hpp"
+#include "SpriteSheet.hpp"
+#include "Replay.hpp"
+
+// Campiona la direzione richiesta dalla tastiera (Frecce o WASD); (0,0) se nessun tasto
+sf::Vector2f readPlayerInput()
+{
+    using Key = sf::Keyboard::Key;
+    if (sf::Keyboard::isKeyPressed(Key::Left) || sf::Keyboard::isKeyPressed(Key::A))
+        return {-1.f, 0.f};
+    if (sf::Keyboard::isKeyPressed(Key::Right) || sf::Keyboard::isKeyPressed(Key::D))
+        return {1.f, 0.f};
+    if (sf::Keyboard::isKeyPressed(Key::Up) || sf::Keyboard::isKeyPressed(Key::W))
+        return {0.f, -1.f};
+    if (sf::Keyboard::isKeyPressed(Key::Down) || sf::Keyboard::isKeyPressed(Key::S))
+        return {0.f, 1.f};
+    return {0.f, 0.f};
+}
 
 // Utility: mostra un messaggio grafico e attende INVIO (compatibile SFML 3)
 void showMessage(sf::RenderWindow &window, const std::string &message, const std::string &fontPath)
 {
-    sf::Font font(fontPath);          // SFML 3: load font via constructor
-    sf::Text text(font, message, 20); // Font size ridotto per evitare tagli
+    TextCache &texts = TextCache::instance();
+    sf::Text &text = texts.text(fontPath, message, 20); // Font size ridotto per evitare tagli
     text.setFillColor(sf::Color::Yellow);
     text.setOutlineColor(sf::Color::Blue);
     text.setOutlineThickness(2);
@@ -64,7 +85,7 @@ void showMessage(sf::RenderWindow &window, const std::string &message, const std
         // Aggiungi "PRESS ENTER" lampeggiante - ora sempre visibile all'inizio
         if (blinkClock.getElapsedTime().asSeconds() < 0.5f)
         {
-            sf::Text pressEnter(font, "PRESS ENTER", 16);
+            sf::Text &pressEnter = texts.text(fontPath, "PRESS ENTER", 16);
             pressEnter.setFillColor(sf::Color::White);
             pressEnter.setPosition({windowWidth * 0.4f, windowHeight * 0.55f});
             window.draw(pressEnter);
@@ -101,7 +122,7 @@ void showMessage(sf::RenderWindow &window, const std::string &message, const std
 // Funzione per chiedere se l'utente vuole caricare il punteggio online
 bool askForGlobalUpload(sf::RenderWindow &window, const std::string &fontPath, unsigned int finalScore)
 {
-    sf::Font font(fontPath);
+    TextCache &texts = TextCache::instance();
 
     while (window.isOpen())
     {
@@ -109,7 +130,7 @@ bool askForGlobalUpload(sf::RenderWindow &window, const std::string &fontPath, u
 
         window.clear(sf::Color::Black);
 
-        sf::Text titleText(font, "CARICA PUNTEGGIO ONLINE?", 32);
+        sf::Text &titleText = texts.text(fontPath, "CARICA PUNTEGGIO ONLINE?", 32);
         titleText.setFillColor(sf::Color(255, 215, 0)); // Oro
         titleText.setOutlineColor(sf::Color::Red);
         titleText.setOutlineThickness(2);
@@ -117,19 +138,19 @@ bool askForGlobalUpload(sf::RenderWindow &window, const std::string &fontPath, u
         titleText.setPosition(sf::Vector2f((window.getSize().x - titleBounds.size.x) / 2.0f, window.getSize().y * 0.2f));
         window.draw(titleText);
 
-        sf::Text scoreText(font, "Punteggio: " + std::to_string(finalScore), 24);
+        sf::Text &scoreText = texts.text(fontPath, "Punteggio: " + std::to_string(finalScore), 24);
         scoreText.setFillColor(sf::Color::White);
         sf::FloatRect scoreBounds = scoreText.getLocalBounds();
         scoreText.setPosition(sf::Vector2f((window.getSize().x - scoreBounds.size.x) / 2.0f, window.getSize().y * 0.35f));
         window.draw(scoreText);
 
-        sf::Text yesText(font, "Premi Y per SI", 20);
+        sf::Text &yesText = texts.text(fontPath, "Premi Y per SI", 20);
         yesText.setFillColor(sf::Color::Green);
         sf::FloatRect yesBounds = yesText.getLocalBounds();
         yesText.setPosition(sf::Vector2f((window.getSize().x - yesBounds.size.x) / 2.0f, window.getSize().y * 0.55f));
         window.draw(yesText);
 
-        sf::Text noText(font, "Premi N per NO", 20);
+        sf::Text &noText = texts.text(fontPath, "Premi N per NO", 20);
         noText.setFillColor(sf::Color::Red);
         sf::FloatRect noBounds = noText.getLocalBounds();
         noText.setPosition(sf::Vector2f((window.getSize().x - noBounds.size.x) / 2.0f, window.getSize().y * 0.65f));
@@ -164,7 +185,7 @@ bool askForGlobalUpload(sf::RenderWindow &window, const std::string &fontPath, u
 // Funzione per inserire il nome per upload globale
 std::string inputPlayerNameForGlobal(sf::RenderWindow &window, const std::string &fontPath, unsigned int finalScore)
 {
-    sf::Font font(fontPath);
+    TextCache &texts = TextCache::instance();
     std::string playerName;
 
     while (window.isOpen())
@@ -173,7 +194,7 @@ std::string inputPlayerNameForGlobal(sf::RenderWindow &window, const std::string
 
         window.clear(sf::Color::Black);
 
-        sf::Text titleText(font, "INSERISCI IL TUO NOME", 32);
+        sf::Text &titleText = texts.text(fontPath, "INSERISCI IL TUO NOME", 32);
         titleText.setFillColor(sf::Color(255, 215, 0)); // Oro
         titleText.setOutlineColor(sf::Color::Red);
         titleText.setOutlineThickness(2);
@@ -181,13 +202,13 @@ std::string inputPlayerNameForGlobal(sf::RenderWindow &window, const std::string
         titleText.setPosition(sf::Vector2f((window.getSize().x - titleBounds.size.x) / 2.0f, window.getSize().y * 0.15f));
         window.draw(titleText);
 
-        sf::Text scoreText(font, "Punteggio: " + std::to_string(finalScore), 24);
+        sf::Text &scoreText = texts.text(fontPath, "Punteggio: " + std::to_string(finalScore), 24);
         scoreText.setFillColor(sf::Color::White);
         sf::FloatRect scoreBounds = scoreText.getLocalBounds();
         scoreText.setPosition(sf::Vector2f((window.getSize().x - scoreBounds.size.x) / 2.0f, window.getSize().y * 0.3f));
         window.draw(scoreText);
 
-        sf::Text nameLabel(font, "Nome:", 20);
+        sf::Text &nameLabel = texts.text(fontPath, "Nome:", 20);
         nameLabel.setFillColor(sf::Color::Cyan);
         nameLabel.setPosition(sf::Vector2f(window.getSize().x * 0.2f, window.getSize().y * 0.5f));
         window.draw(nameLabel);
@@ -202,12 +223,12 @@ std::string inputPlayerNameForGlobal(sf::RenderWindow &window, const std::string
             displayName += "_"; // Cursore
         }
 
-        sf::Text nameText(font, displayName, 20);
+        sf::Text &nameText = texts.text(fontPath, displayName, 20);
         nameText.setFillColor(sf::Color::White);
         nameText.setPosition(sf::Vector2f(window.getSize().x * 0.35f, window.getSize().y * 0.5f));
         window.draw(nameText);
 
-        sf::Text instructionText(font, "Premi INVIO per confermare", 16);
+        sf::Text &instructionText = texts.text(fontPath, "Premi INVIO per confermare", 16);
         instructionText.setFillColor(sf::Color(128, 128, 128));
         sf::FloatRect instrBounds = instructionText.getLocalBounds();
         instructionText.setPosition(sf::Vector2f((window.getSize().x - instrBounds.size.x) / 2.0f, window.getSize().y * 0.75f));
@@ -264,7 +285,7 @@ std::string inputPlayerNameForGlobal(sf::RenderWindow &window, const std::string
 // Funzione per inserire il nome del giocatore per un nuovo record
 std::string inputPlayerName(sf::RenderWindow &window, const std::string &fontPath, unsigned int finalScore)
 {
-    sf::Font font(fontPath);
+    TextCache &texts = TextCache::instance();
     std::string playerName;
     sf::Clock blinkClock;
     bool showCursor = true;
@@ -274,7 +295,7 @@ std::string inputPlayerName(sf::RenderWindow &window, const std::string &fontPat
         window.clear(sf::Color::Black);
 
         // Titolo
-        sf::Text titleText(font, "NUOVO RECORD!", 36);
+        sf::Text &titleText = texts.text(fontPath, "NUOVO RECORD!", 36);
         titleText.setFillColor(sf::Color::Yellow);
         titleText.setOutlineColor(sf::Color::Red);
         titleText.setOutlineThickness(2);
@@ -283,14 +304,14 @@ std::string inputPlayerName(sf::RenderWindow &window, const std::string &fontPat
         window.draw(titleText);
 
         // Punteggio
-        sf::Text scoreText(font, "Punteggio: " + std::to_string(finalScore), 24);
+        sf::Text &scoreText = texts.text(fontPath, "Punteggio: " + std::to_string(finalScore), 24);
         scoreText.setFillColor(sf::Color::Cyan);
         sf::FloatRect scoreBounds = scoreText.getLocalBounds();
         scoreText.setPosition(sf::Vector2f((window.getSize().x - scoreBounds.size.x) / 2.0f, window.getSize().y * 0.35f));
         window.draw(scoreText);
 
         // Prompt
-        sf::Text promptText(font, "Inserisci il tuo nome:", 20);
+        sf::Text &promptText = texts.text(fontPath, "Inserisci il tuo nome:", 20);
         promptText.setFillColor(sf::Color::White);
         sf::FloatRect promptBounds = promptText.getLocalBounds();
         promptText.setPosition(sf::Vector2f((window.getSize().x - promptBounds.size.x) / 2.0f, window.getSize().y * 0.5f));
@@ -308,14 +329,14 @@ std::string inputPlayerName(sf::RenderWindow &window, const std::string &fontPat
             showCursor = !showCursor;
         }
 
-        sf::Text nameText(font, displayName, 24);
+        sf::Text &nameText = texts.text(fontPath, displayName, 24);
         nameText.setFillColor(sf::Color::Green);
         sf::FloatRect nameBounds = nameText.getLocalBounds();
         nameText.setPosition(sf::Vector2f((window.getSize().x - nameBounds.size.x) / 2.0f, window.getSize().y * 0.6f));
         window.draw(nameText);
 
         // Istruzioni
-        sf::Text instructText(font, "Premi INVIO per confermare", 16);
+        sf::Text &instructText = texts.text(fontPath, "Premi INVIO per confermare", 16);
         instructText.setFillColor(sf::Color(128, 128, 128));
         sf::FloatRect instructBounds = instructText.getLocalBounds();
         instructText.setPosition(sf::Vector2f((window.getSize().x - instructBounds.size.x) / 2.0f, window.getSize().y * 0.8f));
@@ -377,10 +398,47 @@ std::string inputPlayerName(sf::RenderWindow &window, const std::string &fontPat
     return playerName.empty() ? "PLAYER" : playerName;
 }
 
-int main()
+int main(int argc, char **argv)
 {
     namespace fs = std::filesystem;
 
+    // Fasi dell'avvio nel log ([STARTUP]): durata di ciascuna dalla fine della precedente
+    sf::Clock startupClock;
+    float startupLast = 0.f;
+    auto startupPhase = [&](const char *phase)
+    {
+        const float now = startupClock.getElapsedTime().asSeconds();
+        PACMUX_LOG_INFO("[STARTUP] %-16s %7.1f ms", phase, (now - startupLast) * 1000.f);
+        startupLast = now;
+    };
+
+    // --trace out.json: fasi dei frame, caricamenti di livello e richieste della classifica in formato
+    // Chrome Trace Event (chrome://tracing o ui.perfetto.dev), scritte da un thread in background.
+    // Il file si chiude all'uscita, anche da exit() nei menu.
+    // --no-audio: nessun campione caricato e nessun thread audio
+    bool noAudio = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--no-audio")
+        {
+            noAudio = true;
+        }
+        else if (std::string(argv[i]) == "--trace" && i + 1 < argc)
+        {
+            const std::string tracePath = argv[++i];
+            if (TraceRecorder::start(tracePath))
+            {
+                std::atexit(TraceRecorder::stop);
+                TraceRecorder::setThreadName("main");
+                PACMUX_LOG_INFO("[TRACE] Traccia in %s", tracePath.c_str());
+            }
+            else
+            {
+                PACMUX_LOG_ERROR("[TRACE] Impossibile scrivere %s", tracePath.c_str());
+            }
+        }
+    }
+
     // Recupera la cartella dell'eseguibile e degli asset
     char buf[MAX_PATH];
     GetModuleFileNameA(NULL, buf, MAX_PATH);
@@ -404,54 +462,120 @@ int main()
         return EXIT_FAILURE;
     }
 
-    // Configura la finestra di gioco
-    const sf::Vector2u tileSize{32, 32};
-    TileMap map;
-    if (!map.load(mapPath.string(), tileSize))
-    {
-        MessageBoxA(NULL, ("Errore caricamento mappa:\n" + mapPath.string()).c_str(),
-                    "Errore Pacman", MB_OK | MB_ICONERROR);
-        return EXIT_FAILURE;
-    }
-    auto mapSz = map.getSize();
-    sf::Vector2f startPos{
-        (mapSz.x * tileSize.x) / 2.f,
-        (mapSz.y * tileSize.y) / 2.f};
-    sf::VideoMode mode(sf::Vector2u{tileSize.x * mapSz.x, tileSize.y * mapSz.y}, 32);
+    // Font e testi condivisi: il font si legge da disco una volta sola, i testi si costruiscono al primo uso
+    TextCache &texts = TextCache::instance();
+    const std::string fontFile = fontPath.string();
 
-    // Assicurati che la finestra sia abbastanza grande per i menu e l'HUD
+    // --- AVVIO: finestra subito, asset decodificati in parallelo dietro una schermata di caricamento ---
+    // La finestra nasce alla misura minima per menu e HUD; si allarga dopo, se la mappa è più grande
     const unsigned minWidth = 800;
     const unsigned minHeight = 700;
-    if (mode.size.x < minWidth)
-    {
-        mode.size.x = minWidth;
-    }
-    if (mode.size.y < minHeight)
-    {
-        mode.size.y = minHeight;
-    }
-
-    // Wrap-around per Pac-Man: correggi posizione se esce dai bordi
-    // RIMOSSO: i controlli di wrap-around ora sono gestiti nella classe Player
-
-    sf::RenderWindow window(mode, "PacMux", sf::Style::Titlebar | sf::Style::Close);
+    sf::RenderWindow window(sf::VideoMode(sf::Vector2u{minWidth, minHeight}, 32), "PacMux",
+                            sf::Style::Titlebar | sf::Style::Close);
     window.setFramerateLimit(60); // Ensure a consistent framerate
+    startupPhase("finestra");
 
-    // Trova la posizione di spawn di Pac-Man ('P') o usa il centro
-    for (unsigned y = 0; y < mapSz.y; ++y)
+    // Font, atlas delle texture e audio: un job per file sui worker. I job non toccano OpenGL né la finestra;
+    // l'upload della texture e l'avvio del thread audio restano qui, dopo wait()
+    AudioManager audio(AudioManager::Config{audioDir, !noAudio});
+    sf::Image spriteImage;
+    bool spriteDecoded = false;
     {
-        for (unsigned x = 0; x < mapSz.x; ++x)
+        // Il blocco chiude il pool del loader: nessun worker inattivo resta vivo durante la partita
+        AssetLoader loader;
+        loader.add("pacman.ttf", [&texts, &fontFile] { texts.font(fontFile); return true; });
+        loader.add("pacman.png", [&spriteImage, &spriteDecoded] {
+            spriteDecoded = spriteImage.loadFromFile(SpriteSheet::PATH);
+            return spriteDecoded;
+        });
+        if (audio.isEnabled())
         {
-            if (map.getData()[y][x] == 'P')
+            for (std::size_t i = 0; i < AudioManager::FILE_COUNT; ++i)
             {
-                startPos = {
-                    x * float(tileSize.x) + tileSize.x / 2.f,
-                    y * float(tileSize.y) + tileSize.y / 2.f};
+                loader.add(AudioManager::getFileName(i), [&audio, i] { return audio.loadFile(i); });
             }
         }
+        loader.start();
+
+        // Schermata di caricamento: solo forme (il font è tra i file in caricamento), finestra sempre reattiva
+        const sf::Vector2f barSize{400.f, 16.f};
+        const sf::Vector2f barPos{(minWidth - barSize.x) / 2.f, (minHeight - barSize.y) / 2.f};
+        sf::RectangleShape barOutline(barSize);
+        barOutline.setPosition(barPos);
+        barOutline.setFillColor(sf::Color::Transparent);
+        barOutline.setOutlineColor(sf::Color(0, 120, 255)); // Blu dei muri della prima mappa
+        barOutline.setOutlineThickness(2.f);
+        sf::RectangleShape barFill;
+        barFill.setPosition(barPos);
+        barFill.setFillColor(sf::Color::Yellow);
+        while (!loader.isDone())
+        {
+            while (auto event = window.pollEvent())
+            {
+                if (event->is<sf::Event::Closed>())
+                {
+                    window.close();
+                    return EXIT_SUCCESS; // Il loader attende i job ancora in corso prima di essere distrutto
+                }
+            }
+            barFill.setSize({barSize.x * loader.getProgress(), barSize.y});
+            window.clear(sf::Color::Black);
+            window.draw(barOutline);
+            window.draw(barFill);
+            window.display();
+        }
+        loader.wait();
+        startupPhase("asset");
+        PACMUX_LOG_INFO("[STARTUP] %zu file su %u thread: %.1f ms reali, %.1f ms di lavoro",
+                        loader.getResults().size(), loader.getThreadCount(),
+                        loader.getWallSeconds() * 1000.0, loader.getWorkSeconds() * 1000.0);
+        for (const AssetLoader::Result &result : loader.getResults())
+        {
+            PACMUX_LOG_INFO("[STARTUP]   %-24s %7.1f ms%s", result.name, result.seconds * 1000.0,
+                            result.ok ? "" : "  ERRORE");
+        }
+    }
+
+    // Consegna: la texture sale sulla GPU dal thread della finestra, l'audio parte con i campioni già pronti
+    if (spriteDecoded)
+    {
+        SpriteSheet::preload(spriteImage);
+    }
+    spriteImage = sf::Image(); // I pixel ora sono sulla GPU
+    audio.start();
+
+    // Crea la simulazione di gioco (stato e logica, senza rendering né audio)
+    const sf::Vector2u tileSize{32, 32};
+    GameSimulation::Config simConfig;
+    simConfig.tileSize = tileSize;
+    simConfig.seed = std::random_device{}();
+    for (const char *mapFile : {"map1.txt", "map2.txt", "map3.txt"})
+    {
+        simConfig.mapFiles.push_back((assets / mapFile).string());
+    }
+    GameSimulation sim(simConfig);
+    // Sottosistemi della simulazione per il profiler dei frame (due letture dell'orologio per sottosistema e tick)
+    sim.setProfiling(FrameProfiler::ENABLED);
+    if (!sim.newGame())
+    {
+        MessageBoxA(NULL, ("Errore caricamento mappa:\n" + mapPath.string()).c_str(),
+                    "Errore Pacman", MB_OK | MB_ICONERROR);
+        return EXIT_FAILURE;
     }
 
-    // Carica il font e inizializza il punteggio
+    // Misura definitiva della finestra: la mappa intera, almeno la misura minima.
+    // La vista di default di SFML non segue setSize: menu e HUD usano uiView
+    auto mapSz = sim.getMap().getSize();
+    const sf::Vector2u windowSize{std::max(tileSize.x * mapSz.x, minWidth), std::max(tileSize.y * mapSz.y, minHeight)};
+    if (window.getSize() != windowSize)
+    {
+        window.setSize(windowSize);
+    }
+    const sf::View uiView(sf::FloatRect({0.f, 0.f}, sf::Vector2f(windowSize)));
+    window.setView(uiView);
+    startupPhase("texture e mappa");
+
+    // Inizializza il punteggio (il font è già nella cache dei testi)
     std::unique_ptr<Score> score;
     std::unique_ptr<HighScore> highScore;
     std::unique_ptr<GlobalLeaderboard> globalLeaderboard;
@@ -461,9 +585,9 @@ int main()
 
     try
     {
-        score = std::make_unique<Score>(fontPath.string());
-        highScore = std::make_unique<HighScore>(fontPath.string());
-        globalLeaderboard = std::make_unique<GlobalLeaderboard>(fontPath.string());
+        score = std::make_unique<Score>(fontFile);
+        highScore = std::make_unique<HighScore>(fontFile);
+        globalLeaderboard = std::make_unique<GlobalLeaderboard>(fontFile);
 
         // Carica i record esistenti dal percorso corretto
         highScore->loadFromFile(highscorePath.string());
@@ -476,169 +600,8 @@ int main()
         MessageBoxA(NULL, e.what(), "Errore Pacman", MB_OK | MB_ICONERROR);
         return EXIT_FAILURE;
     }
-
-    // --- AUDIO: Caricamento effetti e musica ---
-    sf::Music music;
-    if (!music.openFromFile((audioDir / "pacman_beginning.wav").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento musica di sottofondo!\n";
-    }
-    music.setLooping(false); // SFML 3: musica suona una volta sola
-    // NON avviare la musica qui - sarà avviata quando inizia il gameplay
-
-    sf::SoundBuffer bufChomp, bufChompMenu, bufEatGhost, bufDeath, bufMenu, bufGhostBlue, bufGhostReturn, bufGhostNormal;
-    if (!bufChomp.loadFromFile((audioDir / "PacmanChomp.mp3").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto chomp!\n";
-    }
-    if (!bufChompMenu.loadFromFile((audioDir / "pacman_chomp.wav").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto chomp menu!\n";
-    }
-    if (!bufEatGhost.loadFromFile((audioDir / "pacman_eatghost.wav").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto eat ghost!\n";
-    }
-    if (!bufDeath.loadFromFile((audioDir / "pacman_death.wav").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto death!\n";
-    }
-    if (!bufMenu.loadFromFile((audioDir / "pacman_menupausa.wav").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto menu!\n";
-    }
-    if (!bufGhostBlue.loadFromFile((audioDir / "GhostTurntoBlue.mp3").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto ghost blue!\n";
-    }
-    if (!bufGhostReturn.loadFromFile((audioDir / "GhostReturntoHome.mp3").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto ghost return!\n";
-    }
-    if (!bufGhostNormal.loadFromFile((audioDir / "GhostNormalMove.mp3").string()))
-    {
-        std::cerr << "[AUDIO] Errore caricamento effetto ghost normal!\n";
-    }
-
-    // === RIEPILOGO DEGLI 8 SUONI IMPLEMENTATI ===
-    // 1. pacman_beginning.wav - Musica di sottofondo (una volta per partita)
-    // 2. PacmanChomp.mp3 - Suono "wakawakawaka" durante il gioco (loop continuo)
-    // 3. pacman_chomp.wav - Suono per navigazione menu (breve, non in loop)
-    // 4. pacman_eatghost.wav - Mangiare fantasmi + conferma selezioni menu
-    // 5. pacman_death.wav - Morte di Pac-Man
-    // 6. pacman_menupausa.wav - Suono pausa + ritorno al menu da Game Over
-    // 7. GhostTurntoBlue.mp3 - Quando i fantasmi diventano blu (Super Pellet)
-    // 8. GhostReturntoHome.mp3 - Fantasmi che tornano alla casa (dopo essere stati mangiati)
-    // 9. GhostNormalMove.mp3 - Movimento normale dei fantasmi (loop continuo)
-
-    sf::Sound sfxChomp(bufChomp), sfxChompMenu(bufChompMenu), sfxEatGhost(bufEatGhost), sfxDeath(bufDeath), sfxMenu(bufMenu), sfxGhostBlue(bufGhostBlue), sfxGhostReturn(bufGhostReturn), sfxGhostNormal(bufGhostNormal);
-
-    // Imposta il chomp in loop per suono continuo come l'arcade originale
-    sfxChomp.setLooping(true); // Il chomp sarà un loop continuo
-
-    // Il suono menu chomp NON è in loop (perfetto per navigazione)
-    // sfxChompMenu è già configurato per navigazione menu
-    sfxGhostNormal.setLooping(true); // SFML 3: setLoop() → setLooping()
-    sfxGhostReturn.setLooping(true); // Anche il suono di ritorno alla casa in loop
-
-    // === CONTROLLO VOLUME AUDIO ===
-    sfxChomp.setVolume(45.f);       // Riduci volume chomp (0-100)
-    sfxChompMenu.setVolume(35.f);   // Volume per navigazione menu
-    sfxGhostNormal.setVolume(15.f); // Volume molto ridotto fantasmi
-    sfxGhostReturn.setVolume(20.f); // Volume ridotto per ritorno
-    sfxGhostBlue.setVolume(65.f);   // Volume normale per effetti speciali
-    sfxEatGhost.setVolume(70.f);
-    sfxDeath.setVolume(75.f);
-    sfxMenu.setVolume(55.f); // Volume musica di sottofondo
-
-    // Flag per controllare se la musica è già stata avviata
-    bool musicStarted = false;
-
-    // Flag per controllare se i fantasmi stanno suonando
-    bool ghostSoundPlaying = false;
-    bool canPlayGhostSounds = false; // I fantasmi possono suonare solo dopo la musica di inizio
-
-    // Sistema audio avanzato - tracciamento degli stati
-    sf::Clock menuSoundCooldown; // Previene spam di suoni nel menu
-
-    // Timer per il suono chomp - VERSIONE CON CONTROLLO VOLUME
-    bool chompActive = false;       // Indica se Pac-Man sta mangiando
-    sf::Clock lastPelletTimer;      // Timer globale per tracciare l'ultimo pellet mangiato
-    bool chompSoundStarted = false; // Flag per sapere se il chomp è mai stato avviato
-
-    // Crea il giocatore (Pac-Man)
-    Player pac(120.f, startPos, tileSize);
-
-    // Genera tutti i pellet sulle celle libere, ESCLUDENDO tile '2' e la cella di spawn di Pac-Man
-    std::vector<Pellet> pellets;
-    // --- Super Pellet positions ---
-    std::vector<sf::Vector2f> superPelletPositions;
-    // --- Frutti ---
-    std::vector<Fruit> fruits;
-    // Contatore pellet mangiati (per spawn frutti a 20 e 50) e RNG
-    int pelletsEatenCount = 0;
-    bool fruit20Spawned = false; // usato ora per la soglia 30
-    bool fruit50Spawned = false; // usato ora per la soglia 70
-    std::mt19937 rng(std::random_device{}());
-    // Per evitare due frutti uguali nello stesso livello
-    bool firstFruitTypeSet = false;
-    Fruit::Type firstFruitType = Fruit::Type::Cherry;
-    for (unsigned y = 0; y < mapSz.y; ++y)
-    {
-        for (unsigned x = 0; x < mapSz.x; ++x)
-        {
-            char tile = map.getData()[y][x];
-            // Escludi la cella di spawn di Pac-Man
-            sf::Vector2f pos{
-                x * float(tileSize.x) + tileSize.x / 2.f,
-                y * float(tileSize.y) + tileSize.y / 2.f};
-            bool isPacmanSpawn = (std::abs(pos.x - startPos.x) < 1e-2f && std::abs(pos.y - startPos.y) < 1e-2f);
-            // Genera pellet solo sui tile '0' (spazi vuoti) e non sui tile '1' (muri) o '2' (spazi vuoti senza pellet)
-            if (tile == '0' && !isPacmanSpawn)
-            {
-                pellets.emplace_back(pos);
-            }
-            if (tile == 'S')
-            {
-                superPelletPositions.emplace_back(pos);
-            }
-            // NIENTE spawn da mappa: i frutti ora compaiono casualmente dopo 30 e 70 pellet mangiati
-        }
-    }
-
-    // Crea i fantasmi mobili - ora usando classi specifiche
-    std::vector<std::unique_ptr<Ghost>> ghosts;
-    const std::vector<sf::Vector2f> ghostStartPos = {
-        sf::Vector2f(10 * tileSize.x + tileSize.x / 2.f, 9 * tileSize.y + tileSize.y / 2.f),  // Blinky (centro, riga 10) - ghost house entrance
-        sf::Vector2f(10 * tileSize.x + tileSize.x / 2.f, 10 * tileSize.y + tileSize.y / 2.f), // Pinky (centro, riga 11)
-        sf::Vector2f(11 * tileSize.x + tileSize.x / 2.f, 10 * tileSize.y + tileSize.y / 2.f), // Inky (sinistra, riga 11)
-        sf::Vector2f(9 * tileSize.x + tileSize.x / 2.f, 10 * tileSize.y + tileSize.y / 2.f)   // Clyde (destra, riga 11)
-    };
-
-    ghosts.push_back(std::make_unique<Blinky>(ghostStartPos[0]));
-    ghosts.push_back(std::make_unique<Pinky>(ghostStartPos[1]));
-    ghosts.push_back(std::make_unique<Inky>(ghostStartPos[2]));
-    ghosts.push_back(std::make_unique<Clyde>(ghostStartPos[3]));
-
-    // Initialize all ghosts as unreleased (cascade system will control release)
-    for (auto &ghost : ghosts)
-    {
-        ghost->setReleased(false);
-    }
-
-    // --- TIMER MODALITÀ GHOSTS ---
-    enum class GhostMode
-    {
-        Scatter,
-        Chase
-    };
-    GhostMode ghostMode = GhostMode::Scatter; // Inizia in modalità SCATTER come nel classico
-    float modeTimer = 0.f;
-    int modePhase = 0;
-    // Tabella classica: scatter/chase (in secondi) - ora SCATTER È LUNGO QUANTO ERA chase E VICEVERSA
-    const std::vector<float> scatterChaseTimes = {
-        7.f, 20.f, 7.f, 20.f, 5.f, 20.f, 5.f, -1.f // tempi classici Pac-Man
-    };
+    startupPhase("punteggi");
+    bool firstFrameShown = false; // [STARTUP] primo frame, dopo il primo display del menu
 
     // --- GESTIONE STATI DI GIOCO ---
     enum class GameState
@@ -672,133 +635,216 @@ int main()
     PauseOption selectedPauseOption = PauseOption::RESUME;
     const int NUM_PAUSE_OPTIONS = 2;
 
-    // --- GESTIONE MULTI-LIVELLO ---
-    std::vector<std::string> mapFiles = {"map1.txt", "map2.txt", "map3.txt"};
-    int currentLevel = 0;
-    int difficultyLevel = 1;
-    float ghostBaseSpeed = 90.f;
-    float frightenedBaseDuration = 6.0f;
-    std::vector<float> ghostReleaseDelays = {0.f, 3.f, 3.f, 3.f};
-    const float minFrightened = 1.5f;
-    const float minRelease = 0.5f;
-
-    // --- GESTIONE RELEASE SEMPLICE E SEQUENZIALE DEI FANTASMI ---
-    int nextGhostToRelease = 0;
-    float ghostReleaseTimer = 0.f;
-
-    auto loadLevel = [&](int levelIdx, bool resetPellets = true)
+    // Game loop principale
+    sf::Clock clock;
+    bool recordChecked = false; // Flag per controllare se il record è già stato verificato
+    // Gestione focus finestra: senza focus la simulazione resta ferma
+    bool appHasFocus = true;
+    // Confronto tempi di rendering della mappa (F3 alterna batched / una shape per tile)
+    sf::Clock renderClock;
+    float renderTimeAccum = 0.f;
+    float mapDrawTimeAccum = 0.f;
+    float actorDrawTimeAccum = 0.f;
+    int renderFrames = 0;
+    int textStatsFrames = 0;
+    // Autopilota (F2): Pac-Man guidato dalla ricerca MCTS invece che dalla tastiera (soak test e demo).
+    // Creato al primo uso: i suoi worker tengono una simulazione headless ciascuno
+    std::unique_ptr<Autopilot> autopilot;
+    bool autopilotOn = false;
+    // Profiler dei frame (F4 mostra l'overlay): fasi del ciclo e sottosistemi della simulazione.
+    // Il testo dell'overlay si rifà ogni PROFILER_OVERLAY_REFRESH frame, non ogni frame
+    FrameProfiler profiler;
+    bool profilerOverlay = false;
+    std::unique_ptr<sf::Text> profilerText;
+    GameSimulation::SubsystemTimes lastSimTimes;
+    const std::uint64_t PROFILER_OVERLAY_REFRESH = 30;
+
+    // Attori (pellet, Super Pellet, frutti, fantasmi, Pac-Man) raccolti in un batch per texture:
+    // draw call costanti qualunque sia il numero di entità. Con F3 in modalità per tile si torna
+    // al disegno di un oggetto alla volta, per confrontare i tempi.
+    // Coordinate di mappa: la vista attiva (worldView in drawScene) aggiunge l'offset di centratura
+    SpriteBatch actorBatch;
+    sf::CircleShape superPelletShape(9.f); // raggio 9px, solo per il disegno per tile
+    superPelletShape.setOrigin(sf::Vector2f(9.f, 9.f));
+    // withPellets = false quando i pellet sono già nello sfondo statico (staticLayer)
+    auto drawActors = [&](sf::Color superPelletColor, bool withFruits, bool withPellets)
     {
-        mapPath = assets / mapFiles[levelIdx];
-        if (!map.load(mapPath.string(), tileSize))
-        {
-            MessageBoxA(NULL, ("Mappa non trovata:\n" + mapPath.string()).c_str(), "Errore Pacman", MB_OK | MB_ICONERROR);
-            exit(EXIT_FAILURE);
-        }
-        mapSz = map.getSize();
-        // Trova spawn Pac-Man
-        for (unsigned y = 0; y < mapSz.y; ++y)
+        // Pac-Man e fantasmi tra il tick precedente e quello attuale, secondo il tempo non ancora simulato
+        sim.setRenderAlpha(sim.getInterpolationAlpha());
+        if (TileMap::getRenderMode() == TileMap::RenderMode::Batched)
         {
-            for (unsigned x = 0; x < mapSz.x; ++x)
+            actorBatch.clear();
+            if (withPellets)
+                sim.getPellets().appendTo(actorBatch);
+            sim.getSuperPellets().appendTo(actorBatch, superPelletColor);
+            if (withFruits)
             {
-                if (map.getData()[y][x] == 'P')
-                {
-                    startPos = {
-                        x * float(tileSize.x) + tileSize.x / 2.f,
-                        y * float(tileSize.y) + tileSize.y / 2.f};
-                }
+                for (auto &f : sim.getFruits())
+                    f.appendTo(actorBatch);
             }
+            for (auto &g : sim.getGhosts())
+                g->appendTo(actorBatch);
+            sim.getPlayer().appendTo(actorBatch);
+            window.draw(actorBatch);
+            return;
         }
-        // Reset pellet e super pellet solo se richiesto
-        if (resetPellets)
+        window.draw(sim.getPellets());
+        superPelletShape.setFillColor(superPelletColor);
+        sim.getSuperPellets().forEach([&](unsigned x, unsigned y)
         {
-            pellets.clear();
-            superPelletPositions.clear();
-            fruits.clear();
-            // Reset contatori spawn frutti solo quando si rigenerano i pellet
-            pelletsEatenCount = 0;
-            fruit20Spawned = false;
-            fruit50Spawned = false;
-            firstFruitTypeSet = false;
-            for (unsigned y = 0; y < mapSz.y; ++y)
-            {
-                for (unsigned x = 0; x < mapSz.x; ++x)
-                {
-                    char tile = map.getData()[y][x];
-                    sf::Vector2f pos{
-                        x * float(tileSize.x) + tileSize.x / 2.f,
-                        y * float(tileSize.y) + tileSize.y / 2.f};
-                    bool isPacmanSpawn = (std::abs(pos.x - startPos.x) < 1e-2f && std::abs(pos.y - startPos.y) < 1e-2f);
-                    if (tile == '0' && !isPacmanSpawn)
-                    {
-                        pellets.emplace_back(pos);
-                    }
-                    if (tile == 'S')
-                    {
-                        superPelletPositions.emplace_back(pos);
-                    }
-                    // NIENTE spawn da mappa: i frutti ora compaiono casualmente dopo 30 e 70 pellet mangiati
-                }
-            }
+            superPelletShape.setPosition(sim.getSuperPellets().tileCenter(x, y));
+            window.draw(superPelletShape);
+        });
+        if (withFruits)
+        {
+            for (auto &f : sim.getFruits())
+                window.draw(f);
         }
-        // Reset fantasmi
-        ghosts.clear();
-        ghosts.push_back(std::make_unique<Blinky>(ghostStartPos[0]));
-        ghosts.push_back(std::make_unique<Pinky>(ghostStartPos[1]));
-        ghosts.push_back(std::make_unique<Inky>(ghostStartPos[2]));
-        ghosts.push_back(std::make_unique<Clyde>(ghostStartPos[3]));
-        // Aggiorna velocità e frightened in base alla difficoltà
-        float speed = ghostBaseSpeed;
-        for (auto &g : ghosts)
+        for (auto &g : sim.getGhosts())
+            window.draw(*g);
+        window.draw(sim.getPlayer());
+    };
+
+    // Scena di gioco, unica per il gameplay, la pausa dopo un fantasma mangiato e lo sfondo del menu di pausa:
+    // mappa e attori in una vista spostata per centrare la mappa, poi in coordinate finestra punteggio,
+    // vite, livello e autopilota. Durante la pausa del fantasma i Super Pellet restano accesi, i frutti
+    // spariscono e il punteggio del fantasma compare sopra Pac-Man
+    sf::Clock blinkClock; // lampeggio dei Super Pellet
+    StaticLayer staticLayer;
+    auto drawScene = [&]()
+    {
+        const TileMap &map = sim.getMap();
+        const bool ghostEatPause = sim.isGhostEatPause();
+        // Centra la mappa nella finestra
+        sf::Vector2f mapOffset;
+        mapOffset.x = (window.getSize().x - map.getSize().x * tileSize.x) / 2.f;
+        mapOffset.y = (window.getSize().y - map.getSize().y * tileSize.y) / 2.f;
+        sf::View worldView = uiView;
+        worldView.move(-mapOffset);
+        window.setView(worldView);
+
+        // Tempi di disegno solo in gioco: il log ogni 120 frame conta i frame di PLAYING
+        const bool timed = gameState == GameState::PLAYING;
+        // Labirinto e pellet: in modalità batched un quad dello sfondo statico, aggiornato solo
+        // dove un pellet è sparito; per tile (F3) o senza RenderTexture ogni muro e pellet ogni frame
+        FrameProfiler::Scope mapScope(profiler, FrameProfiler::DrawMap);
+        sf::Clock mapDrawClock;
+        const bool layered = TileMap::getRenderMode() == TileMap::RenderMode::Batched &&
+                             staticLayer.update(map, sim.getPellets(), tileSize, sim.getLevel());
+        if (layered)
+            window.draw(staticLayer);
+        else
+            window.draw(map);
+        if (timed)
+            mapDrawTimeAccum += mapDrawClock.getElapsedTime().asSeconds();
+        mapScope.stop();
+
+        // Super Pellet lampeggianti: visibile (peach) o invisibile (trasparente)
+        sf::Color pelletColor = sf::Color(255, 209, 128); // sempre visibile di default
+        if (sim.isStarted() && !ghostEatPause)
+        {
+            float blink = std::abs(std::sin(blinkClock.getElapsedTime().asSeconds() * 12));        // lampeggio ~6 volte/sec
+            pelletColor = (blink > 0.5f) ? sf::Color(255, 209, 128) : sf::Color(255, 209, 128, 0); // peach o trasparente
+        }
+        // Prima i pellet, poi i Super Pellet grandi, poi i frutti, poi i fantasmi, poi Pac-Man sopra tutto
+        FrameProfiler::Scope actorScope(profiler, FrameProfiler::DrawActors);
+        sf::Clock actorDrawClock;
+        drawActors(pelletColor, !ghostEatPause, !layered);
+        if (timed)
+            actorDrawTimeAccum += actorDrawClock.getElapsedTime().asSeconds();
+        actorScope.stop();
+
+        FrameProfiler::Scope hudScope(profiler, FrameProfiler::DrawHud);
+        if (ghostEatPause)
         {
-            g->setSpeed(speed);
-            g->setFrightened(0.f);
-            g->setEaten(false);
-            g->setReleased(false);
-            // Imposta anche il tempo di attesa nella ghost house post-mangiata in base alla difficoltà
-            g->setRespawnDuration(std::max(0.5f, 3.0f * std::pow(0.8f, float(difficultyLevel - 1))));
+            // Punteggio del fantasma sopra Pac-Man
+            const sf::Vector2f pacPos = sim.getPlayer().getPosition();
+            sf::Text &ghostScoreText = texts.text(fontFile, std::to_string(sim.getGhostEatScore()), 18, sf::Text::Bold);
+            ghostScoreText.setFillColor(sf::Color(0, 191, 255)); // Blu frightened
+            ghostScoreText.setOutlineColor(sf::Color::Black);
+            ghostScoreText.setOutlineThickness(4);
+            auto textRect = ghostScoreText.getLocalBounds();
+            ghostScoreText.setOrigin({textRect.position.x + textRect.size.x / 2.f, textRect.position.y + textRect.size.y / 2.f});
+            ghostScoreText.setPosition(sf::Vector2f(pacPos.x, pacPos.y - 40));
+            window.draw(ghostScoreText);
         }
-        // Reset ghost release state sequenziale
-        nextGhostToRelease = 0;
-        ghostReleaseTimer = 0.f;
+        window.setView(uiView);
+
+        score->setScore(sim.getScore());
+        score->draw(window);
+
+        // HUD - Visualizza vite del giocatore (angolo in alto a destra)
+        sf::Text &livesText = texts.text(fontFile, "Vite: " + std::to_string(sim.getLives()), 20);
+        livesText.setFillColor(sf::Color::White);
+        livesText.setPosition(sf::Vector2f(window.getSize().x - 140.f, 10.f)); // Più a sinistra per evitare tagli
+        window.draw(livesText);
 
-        // Salva le vite attuali prima di creare un nuovo Player
-        int currentLives = pac.getLives();
-        pac = Player(120.f, startPos, tileSize);
-        pac.setLives(currentLives); // Ripristina le vite salvate
+        // HUD - Visualizza livello corrente (angolo in basso a sinistra)
+        sf::Text &levelText = texts.text(fontFile, "Livello: " + std::to_string(sim.getLevel() + 1), 20);
+        levelText.setFillColor(sf::Color::Cyan);
+        levelText.setPosition(sf::Vector2f(10.f, window.getSize().y - 30.f)); // Angolo in basso a sinistra
+        window.draw(levelText);
 
-        // NON resettare score qui - mantieni il punteggio tra i livelli
-        // score = std::make_unique<Score>(fontPath.string());
+        if (autopilotOn)
+        {
+            sf::Text &autoText = texts.text(fontFile, "AUTOPILOTA", 20);
+            autoText.setFillColor(sf::Color::Green);
+            autoText.setPosition(sf::Vector2f(window.getSize().x - 180.f, window.getSize().y - 30.f));
+            window.draw(autoText);
+        }
     };
 
-    // Game loop principale
-    sf::Clock clock;
-    bool gameOver = false;
-    bool gameStarted = false;
-    bool recordChecked = false; // Flag per controllare se il record è già stato verificato
-    // Gestione focus finestra e spike del delta-time dopo Alt-Tab
-    bool appHasFocus = true;
-    bool skipNextDt = false;
-    // Evita retrigger della morte su più frame/ghost durante la stessa sequenza
-    bool deathSequenceActive = false;
-    // --- VARIABILI PER PAUSA DOPO MANGIATO FANTASMA (combo classica) ---
-    bool isGhostEatPause = false;
-    sf::Clock ghostEatPauseClock;
-    int ghostEatCombo = 0;
-    int ghostEatScore = 0;
-    constexpr float GHOST_EAT_PAUSE = 1.0f;
-    sf::Vector2f pacmanDirBeforePause;
-    std::vector<sf::Vector2f> ghostsDirBeforePause(4);
+    // Ogni partita viene registrata in last_game.pmxr accanto all'exe (verificabile con pacmux_replay)
+    const fs::path replayPath = exeDir / "last_game.pmxr";
+    std::ofstream replayFile;
+    std::unique_ptr<ReplayWriter> replay;
+    auto finishReplay = [&]()
+    {
+        if (!replay)
+            return;
+        replay->finish(sim);
+        sim.setRecorder(nullptr);
+        replay.reset();
+        replayFile.close();
+    };
+
+    // Avvia una nuova partita (dal menu o dal Game Over)
+    auto startNewGame = [&]()
+    {
+        finishReplay();
+        score->resetScore();
+        recordChecked = false; // Reset del flag per il prossimo game over
+        if (!sim.newGame(std::random_device{}()))
+        {
+            MessageBoxA(NULL, "Errore caricamento mappa", "Errore Pacman", MB_OK | MB_ICONERROR);
+            exit(EXIT_FAILURE);
+        }
+        if (autopilot)
+            autopilot->reset(sim.getSeed());
+        replayFile.open(replayPath, std::ios::binary | std::ios::trunc);
+        if (replayFile)
+        {
+            replay = std::make_unique<ReplayWriter>(replayFile);
+            replay->begin(sim);
+            sim.setRecorder(replay.get());
+        }
+    };
 
     while (window.isOpen())
     {
-        float dt = clock.restart().asSeconds();
-        if (skipNextDt)
+        profiler.beginFrame();
+        // Ogni 600 frame stampa le statistiche della cache testi: a regime nessun font caricato e nessun miss
+        if (++textStatsFrames == 600)
         {
-            dt = 0.f;
-            skipNextDt = false;
+            const TextCache::Stats &textStats = texts.getStats();
+            PACMUX_LOG_INFO("[TEXT] Font caricati: %u, testi hit/miss: %u/%u (%zu in cache)", textStats.fontLoads,
+                            textStats.textHits, textStats.textMisses, texts.getTextCount());
+            texts.resetStats();
+            textStatsFrames = 0;
         }
-        if (dt > 0.1f)
-            dt = 0.1f; // Clamp per evitare salti enormi dopo il refocus
+
+        // Tempo reale del frame: la simulazione lo consuma a tick fissi (GameSimulation::TICK)
+        float dt = clock.restart().asSeconds();
 
         // --- Gestione stati di gioco ---
         if (gameState == GameState::GAME_OVER)
@@ -812,12 +858,12 @@ int main()
                 if (highScore->isHighScore(finalScore))
                 {
                     // Nuovo record locale! Chiedi il nome del giocatore
-                    std::string playerName = inputPlayerName(window, fontPath.string(), finalScore);
+                    std::string playerName = inputPlayerName(window, fontFile, finalScore);
                     highScore->addScore(playerName, finalScore);
                 }
 
                 // Poi chiedi per upload globale (indipendentemente dal record locale)
-                if (askForGlobalUpload(window, fontPath.string(), finalScore))
+                if (askForGlobalUpload(window, fontFile, finalScore))
                 {
                     // L'utente vuole caricare online
                     // Svuota il buffer degli eventi per evitare che la Y rimanga
@@ -825,7 +871,7 @@ int main()
                     { /* svuota buffer */
                     }
 
-                    std::string globalPlayerName = inputPlayerNameForGlobal(window, fontPath.string(), finalScore);
+                    std::string globalPlayerName = inputPlayerNameForGlobal(window, fontFile, finalScore);
                     globalLeaderboard->uploadScore(globalPlayerName, finalScore);
                 }
 
@@ -834,9 +880,8 @@ int main()
 
             // Mostra schermata Game Over
             window.clear(sf::Color::Black);
-            sf::Font font(fontPath.string());
 
-            sf::Text gameOverText(font, "GAME OVER", 48);
+            sf::Text &gameOverText = texts.text(fontFile, "GAME OVER", 48);
             gameOverText.setFillColor(sf::Color::Red);
             gameOverText.setOutlineColor(sf::Color::White);
             gameOverText.setOutlineThickness(2);
@@ -844,7 +889,7 @@ int main()
             window.draw(gameOverText);
 
             unsigned int finalScore = score->getScore();
-            sf::Text scoreText(font, "Punteggio finale: " + std::to_string(finalScore), 24);
+            sf::Text &scoreText = texts.text(fontFile, "Punteggio finale: " + std::to_string(finalScore), 24);
             scoreText.setFillColor(sf::Color::Yellow);
             scoreText.setPosition(sf::Vector2f(window.getSize().x * 0.2f, window.getSize().y * 0.35f));
             window.draw(scoreText);
@@ -852,7 +897,7 @@ int main()
             // Mostra se è stato raggiunto un nuovo record
             if (highScore->isHighScore(finalScore) || finalScore == highScore->getTopScore())
             {
-                sf::Text recordText(font, "NUOVO RECORD!", 28);
+                sf::Text &recordText = texts.text(fontFile, "NUOVO RECORD!", 28);
                 recordText.setFillColor(sf::Color(255, 215, 0)); // Oro
                 recordText.setOutlineColor(sf::Color::Red);
                 recordText.setOutlineThickness(2);
@@ -861,17 +906,17 @@ int main()
                 window.draw(recordText);
             }
 
-            sf::Text restartText(font, "Premi INVIO per ricominciare", 20);
+            sf::Text &restartText = texts.text(fontFile, "Premi INVIO per ricominciare", 20);
             restartText.setFillColor(sf::Color::White);
             restartText.setPosition(sf::Vector2f(window.getSize().x * 0.12f, window.getSize().y * 0.55f));
             window.draw(restartText);
 
-            sf::Text menuText(font, "Premi M o ESC per tornare al menu", 20);
+            sf::Text &menuText = texts.text(fontFile, "Premi M o ESC per tornare al menu", 20);
             menuText.setFillColor(sf::Color::Cyan);
             menuText.setPosition(sf::Vector2f(window.getSize().x * 0.08f, window.getSize().y * 0.65f));
             window.draw(menuText);
 
-            sf::Text highscoreText(font, "Premi H per vedere i record", 20);
+            sf::Text &highscoreText = texts.text(fontFile, "Premi H per vedere i record", 20);
             highscoreText.setFillColor(sf::Color::Magenta);
             highscoreText.setPosition(sf::Vector2f(window.getSize().x * 0.12f, window.getSize().y * 0.75f));
             window.draw(highscoreText);
@@ -892,46 +937,17 @@ int main()
                 {
                     if (keyEvent->code == sf::Keyboard::Key::Enter)
                     {
-                        sfxEatGhost.play(); // Suono di conferma restart
+                        audio.post(AudioManager::Confirm); // Suono di conferma restart
                         // Riavvia il gioco - RESETTA tutto
                         gameState = GameState::PLAYING;
-
-                        // Avvia la musica di sottofondo solo se non è già stata avviata
-                        if (!musicStarted)
-                        {
-                            music.play();
-                            musicStarted = true;
-                        }
-                        // Reset flag audio e suoni
-                        canPlayGhostSounds = false;
-                        ghostSoundPlaying = false;
-                        chompActive = false;
-                        chompSoundStarted = false;
-                        sfxChomp.stop();
-                        sfxChomp.setVolume(60.f); // Reset volume per il prossimo uso
-                        sfxGhostNormal.stop();
-                        sfxGhostReturn.stop();
-
-                        gameOver = false;
-                        gameStarted = false;
-                        currentLevel = 0;
-                        score->resetScore();
-                        pac.setLives(3);
-                        recordChecked = false; // Reset del flag per il prossimo game over
-                        loadLevel(0);
+                        audio.post(AudioManager::GameStarted);
+                        startNewGame();
                         continue;
                     }
                     else if (keyEvent->code == sf::Keyboard::Key::M || keyEvent->code == sf::Keyboard::Key::Escape)
                     {
-                        sfxMenu.play(); // Suono di ritorno al menu
-                        // Ferma tutti i suoni quando si torna al menu
-                        sfxGhostNormal.stop();
-                        sfxGhostReturn.stop();
-                        ghostSoundPlaying = false;
-                        canPlayGhostSounds = false;
-                        chompActive = false;
-                        sfxChomp.stop();           // Ferma completamente il chomp quando si torna al menu
-                        chompSoundStarted = false; // Reset del flag
+                        audio.post(AudioManager::MenuOpen); // Suono di ritorno al menu
+                        audio.post(AudioManager::GameStopped);
                         // Torna al menu - MANTIENI il punteggio per ora
                         recordChecked = false; // Reset del flag
                         gameState = GameState::MENU;
@@ -939,7 +955,7 @@ int main()
                     }
                     else if (keyEvent->code == sf::Keyboard::Key::H)
                     {
-                        sfxEatGhost.play(); // Suono di navigazione
+                        audio.post(AudioManager::Confirm); // Suono di navigazione
                         gameState = GameState::HIGHSCORE;
                         continue;
                     }
@@ -952,10 +968,9 @@ int main()
         {
             // Mostra menu principale
             window.clear(sf::Color::Black);
-            sf::Font font(fontPath.string());
 
             // Titolo del gioco
-            sf::Text title(font, "PACMUX", 48);
+            sf::Text &title = texts.text(fontFile, "PACMUX", 48);
             title.setFillColor(sf::Color::Yellow);
             title.setOutlineColor(sf::Color::Blue);
             title.setOutlineThickness(3);
@@ -971,13 +986,12 @@ int main()
 
             for (int i = 0; i < NUM_MENU_OPTIONS; ++i)
             {
-                sf::Text menuText(font, menuItems[i], 24);
+                sf::Text &menuText = texts.text(fontFile, menuItems[i], 24);
                 menuText.setFillColor(menuColors[i]);
-                if (i == static_cast<int>(selectedMenuOption))
-                {
-                    menuText.setOutlineColor(sf::Color::Red);
-                    menuText.setOutlineThickness(2);
-                }
+                // Il testo è condiviso tra i frame: il contorno va tolto alle voci non selezionate
+                bool selected = (i == static_cast<int>(selectedMenuOption));
+                menuText.setOutlineColor(sf::Color::Red);
+                menuText.setOutlineThickness(selected ? 2.f : 0.f);
 
                 float yPos = window.getSize().y * 0.4f + (i * 60.f);
                 menuText.setPosition(sf::Vector2f(window.getSize().x * 0.4f, yPos));
@@ -986,7 +1000,7 @@ int main()
                 // Freccia per l'opzione selezionata
                 if (i == static_cast<int>(selectedMenuOption))
                 {
-                    sf::Text arrow(font, ">", 24);
+                    sf::Text &arrow = texts.text(fontFile, ">", 24);
                     arrow.setFillColor(sf::Color::Red);
                     arrow.setPosition(sf::Vector2f(window.getSize().x * 0.35f, yPos));
                     window.draw(arrow);
@@ -994,32 +1008,38 @@ int main()
             }
 
             // Istruzioni - sezione separata e ben organizzata
-            sf::Text instructionsTitle(font, "CONTROLLI:", 18);
+            sf::Text &instructionsTitle = texts.text(fontFile, "CONTROLLI:", 18);
             instructionsTitle.setFillColor(sf::Color::Cyan);
             instructionsTitle.setPosition(sf::Vector2f(window.getSize().x * 0.15f, window.getSize().y * 0.72f));
             window.draw(instructionsTitle);
 
-            sf::Text navigationText(font, "Frecce SU/GIU - naviga menu", 14);
+            sf::Text &navigationText = texts.text(fontFile, "Frecce SU/GIU - naviga menu", 14);
             navigationText.setFillColor(sf::Color::White);
             navigationText.setPosition(sf::Vector2f(window.getSize().x * 0.15f, window.getSize().y * 0.76f));
             window.draw(navigationText);
 
-            sf::Text selectText(font, "INVIO - seleziona", 14);
+            sf::Text &selectText = texts.text(fontFile, "INVIO - seleziona", 14);
             selectText.setFillColor(sf::Color::White);
             selectText.setPosition(sf::Vector2f(window.getSize().x * 0.15f, window.getSize().y * 0.79f));
             window.draw(selectText);
 
-            sf::Text moveText(font, "Frecce/WASD - muovi Pac-Man", 14);
+            sf::Text &moveText = texts.text(fontFile, "Frecce/WASD - muovi Pac-Man", 14);
             moveText.setFillColor(sf::Color::White);
             moveText.setPosition(sf::Vector2f(window.getSize().x * 0.15f, window.getSize().y * 0.82f));
             window.draw(moveText);
 
-            sf::Text pauseText(font, "P - pausa", 14);
+            sf::Text &pauseText = texts.text(fontFile, "P - pausa", 14);
             pauseText.setFillColor(sf::Color::White);
             pauseText.setPosition(sf::Vector2f(window.getSize().x * 0.15f, window.getSize().y * 0.85f));
             window.draw(pauseText);
 
             window.display();
+            if (!firstFrameShown)
+            {
+                firstFrameShown = true;
+                startupPhase("primo frame");
+                PACMUX_LOG_INFO("[STARTUP] Primo frame dopo %.1f ms", startupClock.getElapsedTime().asSeconds() * 1000.f);
+            }
 
             // Gestione input menu (non bloccante)
             while (auto event = window.pollEvent())
@@ -1035,51 +1055,25 @@ int main()
                 {
                     if (keyEvent->code == sf::Keyboard::Key::Up)
                     {
-                        if (menuSoundCooldown.getElapsedTime().asMilliseconds() > 100)
-                        {
-                            sfxChompMenu.play(); // Suono di navigazione menu (non in loop)
-                            menuSoundCooldown.restart();
-                        }
+                        audio.post(AudioManager::MenuMove); // Suono di navigazione menu (non in loop)
                         selectedMenuOption = static_cast<MenuOption>((static_cast<int>(selectedMenuOption) - 1 + NUM_MENU_OPTIONS) % NUM_MENU_OPTIONS);
                     }
                     else if (keyEvent->code == sf::Keyboard::Key::Down)
                     {
-                        if (menuSoundCooldown.getElapsedTime().asMilliseconds() > 100)
-                        {
-                            sfxChompMenu.play(); // Suono di navigazione menu (non in loop)
-                            menuSoundCooldown.restart();
-                        }
+                        audio.post(AudioManager::MenuMove); // Suono di navigazione menu (non in loop)
                         selectedMenuOption = static_cast<MenuOption>((static_cast<int>(selectedMenuOption) + 1) % NUM_MENU_OPTIONS);
                     }
                     else if (keyEvent->code == sf::Keyboard::Key::Enter)
                     {
-                        sfxEatGhost.play(); // Suono di conferma selezione
+                        audio.post(AudioManager::Confirm); // Suono di conferma selezione
                         switch (selectedMenuOption)
                         {
                         case MenuOption::PLAY:
                             // Inizia una nuova partita
                             gameState = GameState::PLAYING;
-
-                            // Reset del suono chomp per nuova partita
-                            chompActive = false;
-                            sfxChomp.stop();
-                            chompSoundStarted = false;
-
-                            // Avvia la musica di sottofondo solo se non è già stata avviata
-                            if (!musicStarted)
-                            {
-                                music.play();
-                                musicStarted = true;
-                                canPlayGhostSounds = false; // Reset audio fantasmi quando ricomincia la musica
-                            }
-
-                            gameOver = false;
-                            gameStarted = false;
-                            currentLevel = 0;
-                            score->resetScore();
-                            pac.setLives(3);
-                            recordChecked = false; // Reset del flag per il prossimo game over
-                            loadLevel(0);
+                            // Musica d'inizio alla prima partita, sirena e chomp da zero
+                            audio.post(AudioManager::GameStarted);
+                            startNewGame();
                             break;
                         case MenuOption::HIGHSCORE:
                             // Vai alla schermata dei record
@@ -1127,15 +1121,7 @@ int main()
                 {
                     if (keyEvent->code == sf::Keyboard::Key::Escape)
                     {
-                        sfxEatGhost.play(); // Suono di ritorno al menu
-                        // Ferma tutti i suoni quando si torna al menu da highscore
-                        sfxGhostNormal.stop();
-                        sfxGhostReturn.stop();
-                        ghostSoundPlaying = false;
-                        canPlayGhostSounds = false;
-                        chompActive = false;
-                        sfxChomp.stop();           // Ferma completamente il chomp quando si torna al menu
-                        chompSoundStarted = false; // Reset del flag
+                        audio.post(AudioManager::Confirm); // Suono di ritorno al menu
                         gameState = GameState::MENU;
                     }
                 }
@@ -1170,22 +1156,14 @@ int main()
                 {
                     if (keyEvent->code == sf::Keyboard::Key::Escape)
                     {
-                        sfxEatGhost.play(); // Suono di ritorno al menu
-                        // Ferma tutti i suoni quando si torna al menu
-                        sfxGhostNormal.stop();
-                        sfxGhostReturn.stop();
-                        ghostSoundPlaying = false;
-                        canPlayGhostSounds = false;
-                        chompActive = false;
-                        sfxChomp.stop();
-                        chompSoundStarted = false;
+                        audio.post(AudioManager::Confirm); // Suono di ritorno al menu
                         gameState = GameState::MENU;
                         continue;
                     }
                     else if (keyEvent->code == sf::Keyboard::Key::R)
                     {
                         // Force refresh della leaderboard
-                        sfxEatGhost.play(); // Suono di conferma
+                        audio.post(AudioManager::Confirm); // Suono di conferma
                         globalLeaderboard->forceRefresh();
                         continue;
                     }
@@ -1225,11 +1203,14 @@ int main()
 
         if (gameState == GameState::PAUSED)
         {
-            // Mostra menu di pausa
+            // Mostra menu di pausa sopra la partita ferma, scurita
             window.clear(sf::Color::Black);
-            sf::Font font(fontPath.string());
+            drawScene();
+            sf::RectangleShape dim(sf::Vector2f(window.getSize()));
+            dim.setFillColor(sf::Color(0, 0, 0, 190));
+            window.draw(dim);
 
-            sf::Text titleText(font, "PAUSA", 48);
+            sf::Text &titleText = texts.text(fontFile, "PAUSA", 48);
             titleText.setFillColor(sf::Color::Yellow);
             titleText.setOutlineColor(sf::Color::Blue);
             titleText.setOutlineThickness(3);
@@ -1245,13 +1226,12 @@ int main()
 
             for (int i = 0; i < NUM_PAUSE_OPTIONS; ++i)
             {
-                sf::Text pauseText(font, pauseItems[i], 24);
+                sf::Text &pauseText = texts.text(fontFile, pauseItems[i], 24);
                 pauseText.setFillColor(pauseColors[i]);
-                if (i == static_cast<int>(selectedPauseOption))
-                {
-                    pauseText.setOutlineColor(sf::Color::Red);
-                    pauseText.setOutlineThickness(2);
-                }
+                // Il testo è condiviso tra i frame: il contorno va tolto alle voci non selezionate
+                bool selected = (i == static_cast<int>(selectedPauseOption));
+                pauseText.setOutlineColor(sf::Color::Red);
+                pauseText.setOutlineThickness(selected ? 2.f : 0.f);
 
                 float yPos = window.getSize().y * 0.4f + (i * 60.f);
                 pauseText.setPosition(sf::Vector2f(window.getSize().x * 0.35f, yPos));
@@ -1260,7 +1240,7 @@ int main()
                 // Freccia per l'opzione selezionata
                 if (i == static_cast<int>(selectedPauseOption))
                 {
-                    sf::Text arrow(font, ">", 24);
+                    sf::Text &arrow = texts.text(fontFile, ">", 24);
                     arrow.setFillColor(sf::Color::Red);
                     arrow.setPosition(sf::Vector2f(window.getSize().x * 0.3f, yPos));
                     window.draw(arrow);
@@ -1268,12 +1248,12 @@ int main()
             }
 
             // Istruzioni
-            sf::Text instructionsText(font, "Usa le frecce SU/GIU per navigare", 16);
+            sf::Text &instructionsText = texts.text(fontFile, "Usa le frecce SU/GIU per navigare", 16);
             instructionsText.setFillColor(sf::Color::Cyan);
             instructionsText.setPosition(sf::Vector2f(window.getSize().x * 0.15f, window.getSize().y * 0.65f));
             window.draw(instructionsText);
 
-            sf::Text selectText(font, "INVIO per selezionare - P per riprendere", 16);
+            sf::Text &selectText = texts.text(fontFile, "INVIO per selezionare - P per riprendere", 16);
             selectText.setFillColor(sf::Color::Cyan);
             selectText.setPosition(sf::Vector2f(window.getSize().x * 0.12f, window.getSize().y * 0.68f));
             window.draw(selectText);
@@ -1294,40 +1274,28 @@ int main()
                 {
                     if (keyEvent->code == sf::Keyboard::Key::Up)
                     {
-                        if (menuSoundCooldown.getElapsedTime().asMilliseconds() > 100)
-                        {
-                            sfxChompMenu.play(); // Suono di navigazione menu pausa (non in loop)
-                            menuSoundCooldown.restart();
-                        }
+                        audio.post(AudioManager::MenuMove); // Suono di navigazione menu pausa (non in loop)
                         selectedPauseOption = static_cast<PauseOption>((static_cast<int>(selectedPauseOption) - 1 + NUM_PAUSE_OPTIONS) % NUM_PAUSE_OPTIONS);
                     }
                     else if (keyEvent->code == sf::Keyboard::Key::Down)
                     {
-                        if (menuSoundCooldown.getElapsedTime().asMilliseconds() > 100)
-                        {
-                            sfxChompMenu.play(); // Suono di navigazione menu pausa (non in loop)
-                            menuSoundCooldown.restart();
-                        }
+                        audio.post(AudioManager::MenuMove); // Suono di navigazione menu pausa (non in loop)
                         selectedPauseOption = static_cast<PauseOption>((static_cast<int>(selectedPauseOption) + 1) % NUM_PAUSE_OPTIONS);
                     }
                     else if (keyEvent->code == sf::Keyboard::Key::Enter)
                     {
-                        sfxEatGhost.play(); // Suono di conferma selezione pausa
+                        audio.post(AudioManager::Confirm); // Suono di conferma selezione pausa
                         switch (selectedPauseOption)
                         {
                         case PauseOption::RESUME:
                             // Riprendi il gioco
                             gameState = GameState::PLAYING;
+                            audio.post(AudioManager::LoopsResumed);
                             break;
                         case PauseOption::BACK_TO_MENU:
                             // Ferma tutti i suoni quando si torna al menu dal pause
-                            sfxGhostNormal.stop();
-                            sfxGhostReturn.stop();
-                            ghostSoundPlaying = false;
-                            canPlayGhostSounds = false;
-                            chompActive = false;
-                            sfxChomp.stop();           // Ferma completamente il chomp quando si torna al menu
-                            chompSoundStarted = false; // Reset del flag
+                            audio.post(AudioManager::GameStopped);
+                            finishReplay();            // partita abbandonata: il replay si chiude qui
                             // Torna al menu principale
                             gameState = GameState::MENU;
                             break;
@@ -1337,26 +1305,15 @@ int main()
                     {
                         // Shortcut per riprendere con P
                         gameState = GameState::PLAYING;
+                        audio.post(AudioManager::LoopsResumed);
                     }
                 }
             }
             continue;
         }
 
-        // --- Modalità ghosts ---
-        // Riattiva il cambio automatico scatter/chase SOLO durante il gameplay
-        if (gameState == GameState::PLAYING && modePhase < (int)scatterChaseTimes.size() && scatterChaseTimes[modePhase] > 0.f)
-        {
-            modeTimer += dt;
-            if (modeTimer >= scatterChaseTimes[modePhase])
-            {
-                modeTimer = 0.f;
-                modePhase++;
-                ghostMode = (ghostMode == GhostMode::Scatter) ? GhostMode::Chase : GhostMode::Scatter;
-                // std::cout << "[DEBUG] Cambio modalità fantasmi: " << (ghostMode == GhostMode::Scatter ? "SCATTER" : "CHASE") << std::endl;
-            }
-        }
         // Gestione eventi finestra
+        FrameProfiler::Scope eventsScope(profiler, FrameProfiler::Events);
         while (auto ev = window.pollEvent())
         {
             if (ev->is<sf::Event::Closed>())
@@ -1370,8 +1327,8 @@ int main()
             else if (ev->is<sf::Event::FocusGained>())
             {
                 appHasFocus = true;
-                skipNextDt = true; // evita spike del primo frame al rientro
-                clock.restart();   // resetta il clock per sicurezza
+                clock.restart();        // il tempo passato senza focus non va simulato
+                sim.resetAccumulator();
             }
             else if (ev->is<sf::Event::KeyPressed>())
             {
@@ -1381,691 +1338,186 @@ int main()
                     if (gameState == GameState::PLAYING && keyEvent->code == sf::Keyboard::Key::P)
                     {
                         // Snappa Pac-Man al centro cella e ferma il movimento per evitare uscita mappa
-                        sf::Vector2f p = pac.getPosition();
-                        unsigned cx = static_cast<unsigned>(p.x / tileSize.x);
-                        unsigned cy = static_cast<unsigned>(p.y / tileSize.y);
-                        sf::Vector2f center{
-                            cx * static_cast<float>(tileSize.x) + tileSize.x / 2.f,
-                            cy * static_cast<float>(tileSize.y) + tileSize.y / 2.f};
-                        pac.setPosition(center);
-                        pac.setDirection({0.f, 0.f});
+                        sim.snapPlayerToTile();
                         gameState = GameState::PAUSED;
-                        sfxGhostNormal.stop();                     // Ferma il suono fantasmi quando il gioco va in pausa
-                        sfxGhostReturn.stop();                     // Ferma anche il suono di ritorno
-                        ghostSoundPlaying = false;                 // Reset flag suono fantasmi
-                        chompActive = false;                       // Ferma anche il chomp ritmico
-                        sfxChomp.setVolume(0.f);                   // Silenzia il chomp
-                        sfxMenu.play();                            // Suono del menu di pausa
+                        audio.post(AudioManager::LoopsPaused);     // Sirena e chomp sfumano durante la pausa
+                        audio.post(AudioManager::MenuOpen);        // Suono del menu di pausa
                         selectedPauseOption = PauseOption::RESUME; // Reset selezione pausa
                     }
+                    else if (gameState == GameState::PLAYING && keyEvent->code == sf::Keyboard::Key::F3)
+                    {
+                        TileMap::setRenderMode(TileMap::getRenderMode() == TileMap::RenderMode::Batched
+                                                   ? TileMap::RenderMode::PerTile
+                                                   : TileMap::RenderMode::Batched);
+                        renderTimeAccum = mapDrawTimeAccum = actorDrawTimeAccum = 0.f;
+                        renderFrames = 0;
+                    }
+                    else if (gameState == GameState::PLAYING && keyEvent->code == sf::Keyboard::Key::F2)
+                    {
+                        // Budget di 4 ms per ricerca, una ricerca ogni 0.1 s di gioco: il frame resta sotto i 16 ms
+                        if (!autopilot)
+                            autopilot = std::make_unique<Autopilot>(simConfig, Autopilot::Config{});
+                        autopilotOn = !autopilotOn;
+                        PACMUX_LOG_INFO("[AUTOPILOTA] %s (%u worker)", autopilotOn ? "attivo" : "spento",
+                                        autopilot->getWorkerCount());
+                    }
+                    else if (FrameProfiler::ENABLED && gameState == GameState::PLAYING && keyEvent->code == sf::Keyboard::Key::F4)
+                    {
+                        profilerOverlay = !profilerOverlay;
+                        if (!profilerOverlay)
+                        {
+                            // Una riga per messaggio: la tabella intera supera MESSAGE_SIZE
+                            PACMUX_LOG_INFO("[PROFILER]");
+                            const std::string report = profiler.report();
+                            for (std::size_t begin = 0, end; begin < report.size(); begin = end + 1)
+                            {
+                                end = std::min(report.find('\n', begin), report.size());
+                                PACMUX_LOG_INFO("%.*s", int(end - begin), report.c_str() + begin);
+                            }
+                        }
+                    }
                 }
             }
         }
+        eventsScope.stop();
 
         // Solo se il gioco è in stato PLAYING, aggiorna la logica di gioco
-        if (gameState == GameState::PLAYING && !gameOver)
+        if (gameState == GameState::PLAYING)
         {
             // Se la finestra non ha focus, non aggiornare la logica per evitare comportamenti strani
             if (!appHasFocus)
             {
                 goto render_section;
             }
-            // Blocca movimento di Pac-Man e fantasmi finché la musica iniziale non è finita
-            bool introMusicPlaying = (musicStarted && music.getStatus() == sf::Music::Status::Playing);
-
             // Blocca tutto il gioco finché la musica iniziale è in riproduzione
-            if (introMusicPlaying)
+            if (audio.isIntroPlaying())
             {
-                // Ferma anche il suono chomp se per qualche motivo è partito
-                chompActive = false;
-                sfxChomp.stop();
-                sfxChomp.setVolume(0.f);
-                // Blocca anche i fantasmi
-                // Non aggiornare Pac-Man o fantasmi
-                // Salta direttamente al rendering
+                // Non aggiornare la simulazione, salta direttamente al rendering
                 goto render_section;
             }
-            // Aggiorna il giocatore
-            pac.update(dt, map, tileSize);
-
-            // --- GESTIONE SUONO FANTASMI IN MOVIMENTO ---
-            // Consenti suoni fantasmi SOLO dopo che Pac-Man ha iniziato a muoversi
-            if (musicStarted && !canPlayGhostSounds)
-            {
-                if (music.getStatus() != sf::Music::Status::Playing && gameStarted)
-                {
-                    canPlayGhostSounds = true;
-                    ghostSoundPlaying = false; // Forza il reset per evitare suoni prematuri
-                    sfxGhostNormal.stop();
-                    sfxGhostReturn.stop();
-                }
-            }
-            // Solo se i fantasmi possono suonare, gestisci gli audio
-            if (canPlayGhostSounds)
-            {
-                // Determina quale suono dei fantasmi dovrebbe essere attivo
-                bool anyFrightened = false;
-                bool anyReturning = false;
-                for (const auto &ghost : ghosts)
-                {
-                    if (ghost->isFrightened() && !ghost->isEaten())
-                    {
-                        anyFrightened = true;
-                    }
-                    if (ghost->isEaten() && ghost->isReturningToHouse())
-                    {
-                        anyReturning = true;
-                    }
-                }
-
-                // Gestisci i suoni in base allo stato dei fantasmi (evita sovrapposizioni)
-                static bool lastAnyReturning = false;
-                static bool lastAnyFrightened = false;
-                static sf::Clock ghostSoundCooldown; // Previene cambio troppo frequente
-
-                // Cambia audio solo se lo stato è cambiato E è passato abbastanza tempo
-                if ((anyReturning != lastAnyReturning || anyFrightened != lastAnyFrightened) &&
-                    ghostSoundCooldown.getElapsedTime().asMilliseconds() > 300)
-                {
-
-                    // Stato cambiato, ferma tutti i suoni dei fantasmi prima
-                    sfxGhostNormal.stop();
-                    sfxGhostReturn.stop();
-                    ghostSoundPlaying = false;
-
-                    if (anyReturning)
-                    {
-                        // Priorità: suono ritorno alla casa
-                        sfxGhostReturn.play();
-                        ghostSoundPlaying = true;
-                        // std::cout << "[AUDIO] Attivato suono ritorno fantasmi\n";
-                    }
-                    else if (anyFrightened)
-                    {
-                        // Suono quando i fantasmi sono frightened (blu) - silenzio
-                        ghostSoundPlaying = false;
-                        // std::cout << "[AUDIO] Fantasmi frightened, silenzio\n";
-                    }
-                    else
-                    {
-                        // Suono normale dei fantasmi
-                        sfxGhostNormal.play();
-                        ghostSoundPlaying = true;
-                        // std::cout << "[AUDIO] Attivato suono normale fantasmi\n";
-                    }
-
-                    lastAnyReturning = anyReturning;
-                    lastAnyFrightened = anyFrightened;
-                    ghostSoundCooldown.restart();
-                }
-
-                // Mantieni i suoni attivi se non sono cambiati gli stati (controllo meno frequente)
-                static sf::Clock maintainSoundCheck;
-                if (maintainSoundCheck.getElapsedTime().asSeconds() > 1.0f) // Controlla ogni secondo
-                {
-                    if (anyReturning && sfxGhostReturn.getStatus() != sf::Sound::Status::Playing)
-                    {
-                        sfxGhostReturn.play();
-                    }
-                    else if (!anyFrightened && !anyReturning && sfxGhostNormal.getStatus() != sf::Sound::Status::Playing)
-                    {
-                        sfxGhostNormal.play();
-                    }
-                    maintainSoundCheck.restart();
-                }
-            }
 
-            // --- GESTIONE RELEASE SEMPLICE E SEQUENZIALE DEI FANTASMI ---
-            if (gameStarted && nextGhostToRelease < 4)
+            // Avanza la simulazione a tick fissi con l'input della tastiera (o dell'autopilota)
+            FrameProfiler::Scope simScope(profiler, FrameProfiler::Simulation);
+            sim.advance(dt, autopilotOn ? autopilot->next(sim) : SimInput{readPlayerInput()});
+            simScope.stop();
+            if constexpr (FrameProfiler::ENABLED)
             {
-                ghostReleaseTimer += dt;
-                if (ghostReleaseTimer >= ghostReleaseDelays[nextGhostToRelease])
-                {
-                    ghosts[nextGhostToRelease]->setReleased(true);
-                    // std::cout << "[DEBUG] Ghost " << nextGhostToRelease << " (" << Ghost::getTypeName(static_cast<Ghost::Type>(nextGhostToRelease)) << ") released!\n";
-                    nextGhostToRelease++;
-                    ghostReleaseTimer = 0.f; // resetta il timer SOLO dopo il rilascio
-                }
+                // Quota dei sottosistemi in questo frame: differenza dei tempi accumulati dalla simulazione
+                const GameSimulation::SubsystemTimes &simTimes = sim.getSubsystemTimes();
+                profiler.add(FrameProfiler::SimPlayer, simTimes.player - lastSimTimes.player);
+                profiler.add(FrameProfiler::SimGhosts, simTimes.ghosts - lastSimTimes.ghosts);
+                profiler.add(FrameProfiler::SimPellets, simTimes.pellets - lastSimTimes.pellets);
+                profiler.add(FrameProfiler::SimFruits, simTimes.fruits - lastSimTimes.fruits);
+                profiler.add(FrameProfiler::SimCollisions, simTimes.collisions - lastSimTimes.collisions);
+                profiler.add(FrameProfiler::SimLevelLoad, simTimes.levelLoad - lastSimTimes.levelLoad);
+                lastSimTimes = simTimes;
             }
-
-            // Aggiorna i fantasmi con la nuova architettura SOLO se la musica iniziale è finita
-            for (size_t i = 0; i < ghosts.size(); ++i)
+            if (sim.hasEvent(GameSimulation::LevelLoadFailed))
             {
-                Ghost::Mode m = (ghostMode == GhostMode::Scatter) ? Ghost::Mode::Scatter : Ghost::Mode::Chase;
-
-                if (auto *inky = dynamic_cast<Inky *>(ghosts[i].get()))
-                {
-                    if (ghosts.size() > 0)
-                    {
-                        inky->update(dt, map, tileSize, pac.getPosition(), pac.getDirection(), m, ghosts[0]->getPosition(), gameStarted);
-                    }
-                }
-                else if (auto *pinky = dynamic_cast<Pinky *>(ghosts[i].get()))
-                {
-                    pinky->update(dt, map, tileSize, pac.getPosition(), pac.getDirection(), m, gameStarted);
-                }
-                else if (auto *clyde = dynamic_cast<Clyde *>(ghosts[i].get()))
-                {
-                    clyde->update(dt, map, tileSize, pac.getPosition(), pac.getDirection(), m, gameStarted);
-                }
-                else
-                {
-                    ghosts[i]->update(dt, map, tileSize, pac.getPosition(), pac.getDirection(), m, gameStarted);
-                }
-
-                // WORKAROUND: Evita che i fantasmi attraversino i bordi laterali (teleport)
-                sf::Vector2f ghostPos = ghosts[i]->getPosition();
-                unsigned ghostTileX = static_cast<unsigned>(ghostPos.x / tileSize.x);
-                // Se il fantasma è troppo vicino ai bordi laterali, riposizionalo e forza la direzione verso l'interno
-                if (ghostTileX <= 1)
-                {
-                    sf::Vector2f newPos = ghostPos;
-                    newPos.x = 2.2f * tileSize.x;
-                    ghosts[i]->setPosition(newPos);
-                    // Forza la direzione verso destra (interno)
-                    sf::Vector2f dir = ghosts[i]->getDirection();
-                    dir.x = 1.f;
-                    dir.y = 0.f;
-                    ghosts[i]->setDirection(dir);
-                    // std::cout << "[DEBUG] Ghost " << i << " troppo a sinistra, riposizionato e direzione forzata a destra\n";
-                }
-                else if (ghostTileX >= mapSz.x - 2)
-                {
-                    sf::Vector2f newPos = ghostPos;
-                    newPos.x = (mapSz.x - 2.2f) * tileSize.x;
-                    ghosts[i]->setPosition(newPos);
-                    // Forza la direzione verso sinistra (interno)
-                    sf::Vector2f dir = ghosts[i]->getDirection();
-                    dir.x = -1.f;
-                    dir.y = 0.f;
-                    ghosts[i]->setDirection(dir);
-                    // std::cout << "[DEBUG] Ghost " << i << " troppo a destra, riposizionato e direzione forzata a sinistra\n";
-                }
+                MessageBoxA(NULL, "Errore caricamento mappa", "Errore Pacman", MB_OK | MB_ICONERROR);
+                return EXIT_FAILURE;
             }
 
-            // Controlla collisione con i pellet
-            bool pelletEaten = false;
-            for (auto it = pellets.begin(); it != pellets.end();)
-                if (it->eaten(pac.getPosition()))
-                {
-                    score->add(10);
-                    pelletEaten = true;
-                    // Conta ogni pellet mangiato (serve per spawn frutti a 20/50)
-                    ++pelletsEatenCount;
-                    it = pellets.erase(it);
-                }
-                else
-                    ++it;
+            // Audio: solo l'accodamento degli eventi, i suoni si aggiornano sul thread audio
+            FrameProfiler::Scope audioScope(profiler, FrameProfiler::Audio);
+            // Eventi dell'ultimo advance e stato dei fantasmi (sirena) al thread audio
+            audio.postSimulation(sim);
+            audioScope.stop();
 
-            // Spawn frutti casuali al raggiungimento delle soglie (20 e 50)
-            if (pelletEaten)
+            // Vita extra raggiunta (pellet, frutto o fantasma)
+            if (sim.hasEvent(GameSimulation::ExtraLife))
             {
-                auto spawnFruitAtRandomPellet = [&](Fruit::Type type) -> bool
-                {
-                    if (pellets.empty())
-                        return false;
-                    std::uniform_int_distribution<size_t> dist(0, pellets.size() - 1);
-                    const sf::Vector2f pos = pellets[dist(rng)].getPosition();
-                    fruits.emplace_back(pos, type);
-                    return true;
-                };
-                // Selezione pesata tra 4 tipi: Cherry 40%, Strawberry 30%, Mushroom 20%, Egg 10%
-                auto pickTypeWeighted = [&]()
-                {
-                    std::uniform_int_distribution<int> d(1, 100);
-                    int r = d(rng);
-                    if (r <= 40)
-                        return Fruit::Type::Cherry;
-                    if (r <= 70)
-                        return Fruit::Type::Strawberry;
-                    if (r <= 90)
-                        return Fruit::Type::Mushroom;
-                    return Fruit::Type::Egg;
-                };
-
-                if (!fruit20Spawned && pelletsEatenCount >= 30)
-                {
-                    Fruit::Type t = pickTypeWeighted();
-                    if (spawnFruitAtRandomPellet(t))
-                    {
-                        fruit20Spawned = true;
-                        firstFruitType = t;
-                        firstFruitTypeSet = true;
-                    }
-                }
-                if (!fruit50Spawned && pelletsEatenCount >= 70)
-                {
-                    Fruit::Type t = pickTypeWeighted();
-                    // Evita duplicato rispetto al primo frutto del livello
-                    if (firstFruitTypeSet)
-                    {
-                        int guard = 0; // prevenzione loop infinito
-                        while (t == firstFruitType && guard < 10)
-                        {
-                            t = pickTypeWeighted();
-                            ++guard;
-                        }
-                    }
-                    if (spawnFruitAtRandomPellet(t))
-                        fruit50Spawned = true;
-                }
+                // Sirena e chomp sfumano durante il messaggio di vita extra
+                audio.post(AudioManager::LoopsPaused);
+                showMessage(window, "VITA EXTRA!\n\nHai raggiunto 10.000 punti!\n\nVite: " + std::to_string(sim.getLives()), fontFile);
+                audio.post(AudioManager::LoopsResumed);
             }
 
-            // Aggiorna e raccogli/auto-despawn frutti
-            for (auto itf = fruits.begin(); itf != fruits.end();)
+            // Livello completato: la simulazione ha già caricato il livello successivo
+            if (sim.hasEvent(GameSimulation::LevelCompleted) || sim.hasEvent(GameSimulation::AllLevelsCompleted))
             {
-                // Aggiorna vita
-                itf->update(dt);
-
-                // Raccoglimento da parte di Pac-Man
-                if (itf->eaten(pac.getPosition()))
+                // Sirena e chomp sfumano durante le schermate di vittoria
+                audio.post(AudioManager::LoopsPaused);
+                if (sim.hasEvent(GameSimulation::AllLevelsCompleted))
                 {
-                    score->add(itf->getScore());
-                    // breve popup del punteggio del frutto potrebbe essere aggiunto in futuro
-                    itf = fruits.erase(itf);
-                }
-                // Auto-despawn dopo 10s
-                else if (itf->expired())
-                {
-                    itf = fruits.erase(itf);
+                    showMessage(window, "COMPLIMENTI, HAI COMPLETATO\n\nTUTTI I LIVELLI!\n\nDIFFICOLTA' AUMENTATA!", fontFile);
                 }
                 else
                 {
-                    ++itf;
+                    showMessage(window, " LIVELLO COMPLETATO!\n\n BEN FATTO!", fontFile);
                 }
+                audio.post(AudioManager::LoopsResumed);
             }
 
-            // Gestione suono chomp continuo - CONTROLLO VOLUME INVECE DI STOP/PLAY
-            if (pelletEaten)
+            // Inizio animazione morte Pac-Man: sirena e chomp si fermano e suona la morte (PlayerDied,
+            // già accodato da postSimulation). Animazione finita: vita persa o Game Over
+            if (sim.hasEvent(GameSimulation::GameOver))
             {
-                // Avvia il loop continuo del chomp solo la prima volta
-                if (!chompSoundStarted)
-                {
-                    chompSoundStarted = true;
-                    sfxChomp.stop(); // Forza il reset
-                    sfxChomp.setVolume(60.f);
-                    sfxChomp.play(); // Inizia il loop continuo una volta sola
-                }
-                // Rendi il chomp udibile
-                if (!chompActive)
-                {
-                    chompActive = true;
-                    sfxChomp.setVolume(60.f); // Volume normale quando si mangiano pellet
-                }
-                lastPelletTimer.restart(); // Reset timer quando si mangia un pellet
-            }
-            // Silenzia il chomp se non si mangiano pellet da un po' (ma non fermarlo!)
-            if (chompActive && lastPelletTimer.getElapsedTime().asMilliseconds() > 300)
-            {
-                chompActive = false;
-                sfxChomp.setVolume(0.f); // Silenzia invece di fermare
-            }
-
-            // Controlla se è stata raggiunta una vita extra
-            if (score->checkExtraLife())
-            {
-                // Ferma tutti i suoni durante il messaggio di vita extra
-                sfxGhostNormal.stop();
-                sfxGhostReturn.stop();
-                ghostSoundPlaying = false;
-                chompActive = false;
-                sfxChomp.setVolume(0.f); // Silenzia il chomp
-
-                // Ferma Pac-Man per evitare che esca dalla mappa durante il messaggio
-                pac.stopMovement();
-                pac.setLives(pac.getLives() + 1);
-                showMessage(window, "VITA EXTRA!\n\nHai raggiunto 10.000 punti!\n\nVite: " + std::to_string(pac.getLives()), fontPath.string());
-            }
-
-            // --- Raccolta Super Pellet ---
-            unsigned pacTileX = static_cast<unsigned>(pac.getPosition().x / tileSize.x);
-            unsigned pacTileY = static_cast<unsigned>(pac.getPosition().y / tileSize.y);
-            // Se la posizione è ancora in superPelletPositions, la raccogli
-            auto it = std::find_if(superPelletPositions.begin(), superPelletPositions.end(),
-                                   [&](const sf::Vector2f &pos)
-                                   {
-                                       return (std::abs(pos.x - (pacTileX * tileSize.x + tileSize.x / 2.f)) < 1e-2f &&
-                                               std::abs(pos.y - (pacTileY * tileSize.y + tileSize.y / 2.f)) < 1e-2f);
-                                   });
-            if (it != superPelletPositions.end())
-            {
-                superPelletPositions.erase(it);
-                sfxGhostBlue.play();
-                // Attiva frightened SOLO per fantasmi già usciti
-                for (auto &g : ghosts)
-                {
-                    if (g->isReleased())
-                        g->setFrightened(frightenedBaseDuration);
-                }
-            }
-
-            // Se tutti i pellet sono stati raccolti, mostra messaggio e passa al livello successivo
-            if (pellets.empty())
-            {
-                // Ferma tutti i suoni durante le schermate di vittoria
-                sfxGhostNormal.stop();
-                sfxGhostReturn.stop();
-                ghostSoundPlaying = false;
-                chompActive = false;
-                sfxChomp.setVolume(0.f); // Silenzia il chomp
-
-                currentLevel++;
-                if (currentLevel >= (int)mapFiles.size())
-                {
-                    // Tutte le mappe completate!
-                    showMessage(window, "COMPLIMENTI, HAI COMPLETATO\n\nTUTTI I LIVELLI!\n\nDIFFICOLTA' AUMENTATA!", fontPath.string());
-                    difficultyLevel++;
-                    currentLevel = 0;
-                    // Aumenta la velocità dei fantasmi per la nuova difficoltà (+20% per livello)
-                    ghostBaseSpeed = 90.f * std::pow(1.2f, float(difficultyLevel - 1));
-                    // Diminuisci frightened (minimo 1.5s) del 20% per livello
-                    frightenedBaseDuration = std::max<float>(minFrightened, 6.0f * std::pow(0.8f, float(difficultyLevel - 1)));
-                    // Diminuisci tempi di rilascio (minimo 0.5s, il primo resta 0) del 20% per livello
-                    for (size_t i = 1; i < ghostReleaseDelays.size(); ++i)
-                    {
-                        ghostReleaseDelays[i] = std::max<float>(minRelease, 3.f * std::pow(0.8f, float(difficultyLevel - 1)));
-                    }
-                    // Riduci anche il tempo di attesa in ghost house dopo essere stati mangiati del 20%
-                    for (auto &g : ghosts)
-                    {
-                        g->setRespawnDuration(std::max(0.5f, 3.0f * std::pow(0.8f, float(difficultyLevel - 1))));
-                    }
-                }
-                else
-                {
-                    showMessage(window, " LIVELLO COMPLETATO!\n\n BEN FATTO!", fontPath.string());
-                }
-                loadLevel(currentLevel);
-                gameOver = true;
+                audio.post(AudioManager::GameStopped);
+                // Game Over - passa alla schermata Game Over
+                finishReplay();
+                gameState = GameState::GAME_OVER;
             }
-
-            // --- BLOCCO PAUSA DOPO MANGIATO FANTASMA (combo classica) ---
-            if (isGhostEatPause)
+            else if (sim.hasEvent(GameSimulation::LifeLost))
             {
-                // Blocca movimento Pac-Man e fantasmi SOLO durante la pausa
-                pac.setDirection({0.f, 0.f});
-                for (size_t i = 0; i < ghosts.size(); ++i)
-                    ghosts[i]->setDirection({0.f, 0.f});
-                // Mostra punteggio sopra Pac-Man
-                sf::Vector2f mapOffset;
-                mapOffset.x = (window.getSize().x - map.getSize().x * tileSize.x) / 2.f;
-                mapOffset.y = (window.getSize().y - map.getSize().y * tileSize.y) / 2.f;
-                // Mostra punteggio sopra Pac-Man
-                sf::Font font(fontPath.string());
-                sf::Text ghostScoreText(font, std::to_string(ghostEatScore), 18);
-                ghostScoreText.setFillColor(sf::Color(0, 191, 255)); // Blu frightened
-                ghostScoreText.setOutlineColor(sf::Color::Black);
-                ghostScoreText.setOutlineThickness(4);
-                ghostScoreText.setStyle(sf::Text::Bold);
-                auto textRect = ghostScoreText.getLocalBounds();
-                ghostScoreText.setOrigin({textRect.position.x + textRect.size.x / 2.f, textRect.position.y + textRect.size.y / 2.f});
-                ghostScoreText.setPosition(sf::Vector2f(pac.getPosition().x + mapOffset.x, pac.getPosition().y + mapOffset.y - 40));
-                window.clear();
-                // Disegna la mappa e gli oggetti normalmente
-                sf::Transform mapTransform;
-                mapTransform.translate(mapOffset);
-                window.draw(map, mapTransform);
-                for (auto &p : pellets)
-                {
-                    sf::Transform pelletTransform;
-                    pelletTransform.translate(mapOffset);
-                    window.draw(p, pelletTransform);
-                }
-                for (const auto &pos : superPelletPositions)
-                {
-                    sf::CircleShape superPellet(9.f);
-                    superPellet.setOrigin(sf::Vector2f(9.f, 9.f));
-                    superPellet.setPosition(pos + mapOffset);
-                    superPellet.setFillColor(sf::Color(255, 209, 128));
-                    window.draw(superPellet);
-                }
-                for (auto &g : ghosts)
-                {
-                    sf::Transform ghostTransform;
-                    ghostTransform.translate(mapOffset);
-                    window.draw(*g, ghostTransform);
-                }
-                sf::Transform pacTransform;
-                pacTransform.translate(mapOffset);
-                window.draw(pac, pacTransform);
-                score->draw(window);
-                // HUD
-                sf::Text livesText(font, "Vite: " + std::to_string(pac.getLives()), 20);
-                livesText.setFillColor(sf::Color::White);
-                livesText.setPosition(sf::Vector2f(window.getSize().x - 140.f, 10.f));
-                window.draw(livesText);
-                sf::Text levelText(font, "Livello: " + std::to_string(currentLevel + 1), 20);
-                levelText.setFillColor(sf::Color::Cyan);
-                levelText.setPosition(sf::Vector2f(10.f, window.getSize().y - 30.f));
-                window.draw(levelText);
-                window.draw(ghostScoreText);
-                window.display();
-                if (ghostEatPauseClock.getElapsedTime().asSeconds() >= GHOST_EAT_PAUSE)
-                {
-                    isGhostEatPause = false;
-                    // Ripristina la direzione di Pac-Man e dei fantasmi
-                    pac.setDirection(pacmanDirBeforePause);
-                    for (size_t i = 0; i < ghosts.size(); ++i)
-                        ghosts[i]->setDirection(ghostsDirBeforePause[i]);
-                }
-                continue;
-            }
-            // Collisione Pac-Man / Fantasmi (skippa se in sequenza di morte)
-            for (size_t i = 0; i < ghosts.size() && !deathSequenceActive; ++i)
-            {
-                const auto &ghost = ghosts[i];
-                float dist = (pac.getPosition() - ghost->getPosition()).x * (pac.getPosition() - ghost->getPosition()).x +
-                             (pac.getPosition() - ghost->getPosition()).y * (pac.getPosition() - ghost->getPosition()).y;
-                float minDist = 24.f * 24.f; // raggio Pac-Man + raggio Ghost (approssimato)
-                if (dist < minDist)
-                {
-                    if (ghost->isFrightened() && !ghost->isEaten())
-                    {
-                        ghost->setEaten(true);
-                        sfxEatGhost.play();
-                        // Combo: 200, 400, 800, 1600
-                        static const int ghostScores[] = {200, 400, 800, 1600};
-                        ghostEatScore = ghostScores[std::min(ghostEatCombo, 3)];
-                        score->add(ghostEatScore);
-                        ghostEatCombo++;
-                        // Controlla se è stata raggiunta una vita extra dopo aver mangiato un fantasma
-                        if (score->checkExtraLife())
-                        {
-                            // Ferma tutti i suoni durante il messaggio di vita extra
-                            sfxGhostNormal.stop();
-                            sfxGhostReturn.stop();
-                            ghostSoundPlaying = false;
-                            chompActive = false;
-                            sfxChomp.setVolume(0.f); // Silenzia il chomp
-                            pac.setLives(pac.getLives() + 1);
-                            showMessage(window, "VITA EXTRA!\n\nHai raggiunto 10.000 punti!\n\nVite: " + std::to_string(pac.getLives()), fontPath.string());
-                        }
-                        // Salva la direzione di Pac-Man e dei fantasmi prima della pausa
-                        pacmanDirBeforePause = pac.getDirection();
-                        for (size_t j = 0; j < ghosts.size(); ++j)
-                            ghostsDirBeforePause[j] = ghosts[j]->getDirection();
-                        isGhostEatPause = true;
-                        ghostEatPauseClock.restart();
-                        continue;
-                    }
-                    else if (!ghost->isEaten() && !ghost->isReturningToHouse())
-                    {
-                        // Avvia animazione morte Pac-Man
-                        if (!pac.isDying())
-                        {
-                            pac.startDeathAnimation();
-                            sfxGhostNormal.stop();     // Ferma il suono fantasmi quando Pac-Man muore
-                            sfxGhostReturn.stop();     // Ferma anche il suono di ritorno
-                            ghostSoundPlaying = false; // Reset flag suono fantasmi
-                            // SILENZIA IMMEDIATAMENTE IL CHOMP
-                            chompActive = false;
-                            sfxChomp.stop();
-                            sfxChomp.setVolume(0.f);
-                            sfxDeath.play();
-                            deathSequenceActive = true; // blocca ulteriori collisioni finché non gestita
-                        }
-                    }
-                }
-            }
-            // --- BLOCCO GIOCO DURANTE ANIMAZIONE MORTE PAC-MAN ---
-            if (pac.isDying())
-            {
-                // Aggiorna solo Pac-Man per animazione morte
-                pac.update(dt, map, tileSize);
-                // Rendering
-                goto render_section;
-            }
-            // --- FINE BLOCCO ANIMAZIONE MORTE ---
-            // Dopo che l'animazione di morte è finita, decrementa vite o Game Over
-            if (pac.isDeathAnimationFinished())
-            {
-                pac.resetDeathAnimation();
-                pac.loseLife();
-                if (pac.getLives() <= 0)
-                {
-                    // Ferma tutti i suoni quando si va in Game Over
-                    chompActive = false;
-                    sfxChomp.stop();
-                    sfxChomp.setVolume(0.f);
-                    // Game Over - passa alla schermata Game Over
-                    gameState = GameState::GAME_OVER;
-                    deathSequenceActive = false; // reset per prossima partita
-                }
-                else
-                {
-                    showMessage(window, "VITA PERSA!\n\nVite rimaste: " + std::to_string(pac.getLives()) + "\n\nRiprova!", fontPath.string());
-                    // Ricarica il livello corrente SENZA resettare i pellet e le vite
-                    int currentLives = pac.getLives();
-                    loadLevel(currentLevel, false); // NON resettare i pellet
-                    pac.setLives(currentLives);     // Ripristina le vite corrette
-                    ghostSoundPlaying = false;      // Reset flag suono fantasmi dopo morte
-                    // --- FIX: reset chomp dopo morte ---
-                    chompActive = false;
-                    chompSoundStarted = false;
-                    sfxChomp.stop();
-                    sfxChomp.setVolume(60.f); // Reset volume per il prossimo uso
-                    gameOver = true;
-                    deathSequenceActive = false; // fine sequenza dopo gestione vita persa
-                }
-            }
-            // --- RESET COMBO SOLO SE NESSUN FANTASMA È FRIGHTENED ---
-            bool anyFrightened = false;
-            for (const auto &ghost : ghosts)
-            {
-                if (ghost->isFrightened() && !ghost->isEaten())
-                {
-                    anyFrightened = true;
-                    break;
-                }
-            }
-            if (!anyFrightened)
-                ghostEatCombo = 0;
-        }
-        // Gestione gameOver e gameStarted SOLO durante il gameplay
-        if (gameState == GameState::PLAYING)
-        {
-            // Dopo il reset, attendi che il giocatore prema una freccia per ripartire
-            if (gameOver)
-            {
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Left) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Right) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Up) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Down))
-                {
-                    gameOver = false;
-                    gameStarted = false;
-                }
-            }
-            // Avvia il gioco solo dopo la prima mossa di Pac-Man
-            if (!gameStarted && (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Left) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Right) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Up) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Down) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::W) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::A) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::S) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::D)))
-            {
-                gameStarted = true;
+                showMessage(window, "VITA PERSA!\n\nVite rimaste: " + std::to_string(sim.getLives()) + "\n\nRiprova!", fontFile);
+                audio.post(AudioManager::LoopsResumed); // la sirena riparte, il chomp al primo pellet
             }
         }
 
     render_section:
         // Rendering
+        renderClock.restart();
         window.clear();
 
-        // Disegna l'HUD solo durante il gameplay
+        // Scena e HUD solo durante il gameplay (anche nella pausa dopo un fantasma mangiato)
         if (gameState == GameState::PLAYING)
         {
-            // Centra la mappa nella finestra
-            sf::Vector2f mapOffset;
-            mapOffset.x = (window.getSize().x - map.getSize().x * tileSize.x) / 2.f;
-            mapOffset.y = (window.getSize().y - map.getSize().y * tileSize.y) / 2.f;
-
-            // Applica l'offset alla mappa (se possibile)
-            sf::Transform mapTransform;
-            mapTransform.translate(mapOffset);
-            window.draw(map, mapTransform);
-
-            // Prima i pellet, poi i Super Pellet grandi, poi i frutti, poi i fantasmi, poi Pac-Man sopra tutto
-            for (auto &p : pellets)
-            {
-                sf::Transform pelletTransform;
-                pelletTransform.translate(mapOffset);
-                window.draw(p, pelletTransform);
-            }
-            // Super Pellet lampeggianti: visibile (peach) o invisibile (trasparente)
-            static sf::Clock blinkClock;
-            float blink = 1.0f;
-            sf::Color pelletColor = sf::Color(255, 209, 128); // sempre visibile di default
-            if (gameStarted)
-            {
-                blink = std::abs(std::sin(blinkClock.getElapsedTime().asSeconds() * 12));              // lampeggio ~6 volte/sec
-                pelletColor = (blink > 0.5f) ? sf::Color(255, 209, 128) : sf::Color(255, 209, 128, 0); // peach o trasparente
-            }
-            for (const auto &pos : superPelletPositions)
-            {
-                sf::CircleShape superPellet(9.f); // raggio 9px
-                superPellet.setOrigin(sf::Vector2f(9.f, 9.f));
-                superPellet.setPosition(pos + mapOffset);
-                superPellet.setFillColor(pelletColor);
-                window.draw(superPellet);
-            }
-            // Frutti
-            for (auto &f : fruits)
+            drawScene();
+
+            if (profilerOverlay)
             {
-                sf::Transform fruitTransform;
-                fruitTransform.translate(mapOffset);
-                window.draw(f, fruitTransform);
+                FrameProfiler::Scope hudScope(profiler, FrameProfiler::DrawHud);
+                if (!profilerText)
+                    profilerText = std::make_unique<sf::Text>(texts.font(fontFile), profiler.report(), 12);
+                else if (profiler.getFrameCount() % PROFILER_OVERLAY_REFRESH == 0)
+                    profilerText->setString(profiler.report());
+                sf::RectangleShape panel(profilerText->getGlobalBounds().size + sf::Vector2f(16.f, 16.f));
+                panel.setPosition(sf::Vector2f(10.f, 40.f));
+                panel.setFillColor(sf::Color(0, 0, 0, 200));
+                profilerText->setPosition(sf::Vector2f(18.f, 48.f));
+                profilerText->setFillColor(sf::Color::White);
+                window.draw(panel);
+                window.draw(*profilerText);
             }
-            for (auto &g : ghosts)
+
+            // Ogni 120 frame stampa il tempo CPU medio del rendering (escluso display/vsync)
+            renderTimeAccum += renderClock.getElapsedTime().asSeconds();
+            if (++renderFrames == 120)
             {
-                sf::Transform ghostTransform;
-                ghostTransform.translate(mapOffset);
-                window.draw(*g, ghostTransform);
+                bool batched = TileMap::getRenderMode() == TileMap::RenderMode::Batched;
+                char actors[32] = "uno per oggetto";
+                if (batched)
+                    std::snprintf(actors, sizeof(actors), "%zu draw call", actorBatch.getDrawCallCount());
+                PACMUX_LOG_INFO("[RENDER] Mappa %s (%zu draw call, %zu pellet, %llu ridisegni, %llu pellet cancellati), "
+                                "attori %s: frame %g ms, mappa %g ms, attori %g ms",
+                                batched ? "sfondo statico" : "per tile",
+                                batched ? std::size_t(1) : sim.getMap().getDrawCallCount(), sim.getPellets().count(),
+                                static_cast<unsigned long long>(staticLayer.getRebuildCount()),
+                                static_cast<unsigned long long>(staticLayer.getErasedCount()), actors,
+                                renderTimeAccum / renderFrames * 1000.f, mapDrawTimeAccum / renderFrames * 1000.f,
+                                actorDrawTimeAccum / renderFrames * 1000.f);
+                renderTimeAccum = mapDrawTimeAccum = actorDrawTimeAccum = 0.f;
+                renderFrames = 0;
             }
-            sf::Transform pacTransform;
-            pacTransform.translate(mapOffset);
-            window.draw(pac, pacTransform);
-
-            score->draw(window);
-
-            // HUD - Visualizza vite del giocatore (angolo in alto a destra)
-            sf::Font font(fontPath.string());
-            sf::Text livesText(font, "Vite: " + std::to_string(pac.getLives()), 20);
-            livesText.setFillColor(sf::Color::White);
-            livesText.setPosition(sf::Vector2f(window.getSize().x - 140.f, 10.f)); // Più a sinistra per evitare tagli
-            window.draw(livesText);
-
-            // HUD - Visualizza livello corrente (angolo in basso a sinistra)
-            sf::Text levelText(font, "Livello: " + std::to_string(currentLevel + 1), 20);
-            levelText.setFillColor(sf::Color::Cyan);
-            levelText.setPosition(sf::Vector2f(10.f, window.getSize().y - 30.f)); // Angolo in basso a sinistra
-            window.draw(levelText);
         }
 
+        FrameProfiler::Scope displayScope(profiler, FrameProfiler::Display);
         window.display();
+        displayScope.stop();
+        profiler.endFrame();
     }
 
+    finishReplay(); // finestra chiusa a partita in corso
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,72 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Replay.hpp"
+#include "AllocationCounter.hpp"
+#include "Logger.hpp"
+
+// =========================
+// pacmux_replay: verifica in blocco dei replay
+// =========================
+// Uso: pacmux_replay [--maps <cartella>] [--verbose] <file.pmxr> [altri file...]
+// Ogni file può contenere più replay di fila. Ogni partita viene risimulata headless alla massima
+// velocità e confrontata con i checkpoint registrati. Codice di uscita 0 solo se tutti i replay tornano.
+// =========================
+int main(int argc, char** argv)
+{
+    std::string mapDir = "assets";
+    std::vector<std::string> files;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--maps" && i + 1 < argc)
+            mapDir = argv[++i];
+        else if (arg == "--verbose")
+            verbose = true;
+        else
+            files.push_back(arg);
+    }
+    if (files.empty())
+    {
+        std::cerr << "Uso: " << argv[0] << " [--maps <cartella>] [--verbose] <file.pmxr> [altri file...]" << std::endl;
+        return 2;
+    }
+
+    // Come pacmux_bench: senza --verbose i log di debug dei fantasmi non coprono gli esiti OK/ERRORE
+    Logger::setLevel(verbose ? Logger::Debug : Logger::Warning);
+
+    int total = 0, failed = 0;
+    for (const std::string& file : files)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (!in)
+        {
+            std::cerr << "[REPLAY] Impossibile aprire " << file << std::endl;
+            ++failed;
+            continue;
+        }
+        ReplayResult result;
+        for (int index = 0; playReplay(in, mapDir, result); ++index)
+        {
+            ++total;
+            std::cout << "[REPLAY] " << file << " #" << index << " seme " << result.seed << ": "
+                      << result.ticks << " tick, punteggio " << result.score << ", livello " << result.level + 1
+                      << ", vite " << result.lives << " (" << result.wallSeconds * 1000.0 << " ms)";
+            if (AllocationCounter::isEnabled())
+                std::cout << ", allocazioni fantasmi " << result.ghostAllocations;
+            if (result.ok)
+            {
+                std::cout << " OK" << std::endl;
+                continue;
+            }
+            std::cout << " ERRORE: " << result.error << std::endl;
+            ++failed;
+            break; // dopo un errore lo stream non è più allineato
+        }
+    }
+    std::cout << "[REPLAY] " << total - failed << "/" << total << " replay verificati" << std::endl;
+    return failed == 0 ? 0 : 1;
+}